@@ -0,0 +1,34 @@
+#pragma once
+
+#include <helgoboss-learn/Target.h>
+
+namespace helgoboss::bench {
+  // Continuous target which just remembers its value, so modes have to look at a changing current value. Final, so
+  // calls are not virtual where the static type is known.
+  class BenchTarget final : public Target {
+  private:
+    double value_ = 0.5;
+  public:
+    TargetCharacter getCharacter() const override {
+      return TargetCharacter::Continuous;
+    }
+    double getStepSize() const override {
+      return -1;
+    }
+    bool wantsToBeHitWithStepCounts() const override {
+      return false;
+    }
+    void hit(double normalizedValue, bool isStepCount) override {
+      value_ = normalizedValue;
+    }
+    double getCurrentValue() const override {
+      return value_;
+    }
+    int getMaxStepCount() const override {
+      return -1;
+    }
+    bool canBeDiscrete() const override {
+      return false;
+    }
+  };
+}
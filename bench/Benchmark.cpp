@@ -0,0 +1,59 @@
+#include "Benchmark.h"
+#include <chrono>
+#include <algorithm>
+#include <limits>
+
+namespace helgoboss::bench {
+  double BenchmarkResult::itemsPerSecond() const {
+    return nanosPerItem == 0 ? 0 : 1000000000.0 / nanosPerItem;
+  }
+
+  Runner::Runner(std::string filter, int runCount) : filter_(std::move(filter)), runCount_(runCount) {
+  }
+
+  void Runner::measure(const std::string& name, long long itemCount, const std::function<void()>& run) {
+    if (name.find(filter_) == std::string::npos) {
+      return;
+    }
+    auto fastestRun = std::chrono::steady_clock::duration::max();
+    for (int i = 0; i < runCount_; i++) {
+      const auto start = std::chrono::steady_clock::now();
+      run();
+      fastestRun = std::min(fastestRun, std::chrono::steady_clock::now() - start);
+    }
+    const auto nanos = std::chrono::duration_cast<std::chrono::duration<double, std::nano>>(fastestRun).count();
+    results_.push_back({name, itemCount, itemCount == 0 ? nanos : nanos / itemCount});
+  }
+
+  void Runner::recordCount(const std::string& name, const std::string& unit, long long itemCount, long long count) {
+    if (name.find(filter_) == std::string::npos) {
+      return;
+    }
+    counterResults_.push_back({name, unit, itemCount, itemCount == 0 ? count : static_cast<double>(count) / itemCount});
+  }
+
+  const std::vector<BenchmarkResult>& Runner::getResults() const {
+    return results_;
+  }
+
+  const std::vector<CounterResult>& Runner::getCounterResults() const {
+    return counterResults_;
+  }
+
+  namespace {
+    std::vector<Benchmark>& getBenchmarks() {
+      // Function-local so it's initialized before first use during static initialization
+      static std::vector<Benchmark> benchmarks;
+      return benchmarks;
+    }
+  }
+
+  int registerBenchmark(Benchmark benchmark) {
+    getBenchmarks().push_back(std::move(benchmark));
+    return static_cast<int>(getBenchmarks().size());
+  }
+
+  const std::vector<Benchmark>& getRegisteredBenchmarks() {
+    return getBenchmarks();
+  }
+}
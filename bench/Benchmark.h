@@ -0,0 +1,81 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <functional>
+
+namespace helgoboss::bench {
+  struct BenchmarkResult {
+    std::string name;
+    // Number of items (messages, mappings, ...) processed by one run
+    long long itemCount;
+    // Duration of the fastest run divided by the item count
+    double nanosPerItem;
+
+    double itemsPerSecond() const;
+  };
+
+  struct CounterResult {
+    std::string name;
+    // What has been counted, e.g. "bytes" or "cache misses"
+    std::string unit;
+    // Number of items (mappings, messages, ...) the count is spread over
+    long long itemCount;
+    double countPerItem;
+  };
+
+  class Runner {
+  private:
+    std::string filter_;
+    int runCount_;
+    std::vector<BenchmarkResult> results_;
+    std::vector<CounterResult> counterResults_;
+  public:
+    Runner(std::string filter, int runCount);
+
+    /**
+     * Invokes the given function a few times and records the fastest run. The function is supposed to process
+     * itemCount items per invocation.
+     *
+     * Does nothing if the name doesn't contain the filter text.
+     */
+    void measure(const std::string& name, long long itemCount, const std::function<void()>& run);
+
+    /**
+     * Records something counted for the given items other than time, e.g. the heap bytes they keep alive (see
+     * getLiveHeapBytes()) or the cache misses caused by processing them (see CacheMissCounter).
+     *
+     * Does nothing if the name doesn't contain the filter text.
+     */
+    void recordCount(const std::string& name, const std::string& unit, long long itemCount, long long count);
+
+    const std::vector<BenchmarkResult>& getResults() const;
+
+    const std::vector<CounterResult>& getCounterResults() const;
+  };
+
+  using Benchmark = std::function<void(Runner&)>;
+
+  /**
+   * Makes the given benchmark part of the helgoboss-learn-bench executable. Supposed to be called during static
+   * initialization, that's why it returns something.
+   */
+  int registerBenchmark(Benchmark benchmark);
+
+  const std::vector<Benchmark>& getRegisteredBenchmarks();
+
+  /**
+   * Prevents the compiler from optimizing away the computation of the given value.
+   */
+  template<typename T>
+  void keep(const T& value) {
+    static const void* volatile sink;
+    sink = &value;
+  }
+
+  // Taking the address is not enough for plain numbers, the computation could still be dropped
+  inline void keep(double value) {
+    static volatile double sink;
+    sink = value;
+  }
+}
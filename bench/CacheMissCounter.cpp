@@ -0,0 +1,66 @@
+#include "CacheMissCounter.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cstdint>
+#endif
+
+namespace helgoboss::bench {
+#ifdef __linux__
+  CacheMissCounter::CacheMissCounter() {
+    perf_event_attr attr{};
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.size = sizeof(attr);
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // This thread, any CPU
+    fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+  }
+
+  CacheMissCounter::~CacheMissCounter() {
+    if (fd_ != -1) {
+      close(fd_);
+    }
+  }
+
+  void CacheMissCounter::start() {
+    if (fd_ == -1) {
+      return;
+    }
+    ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+  }
+
+  long long CacheMissCounter::stop() {
+    if (fd_ == -1) {
+      return 0;
+    }
+    ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+    std::uint64_t count = 0;
+    if (read(fd_, &count, sizeof(count)) != sizeof(count)) {
+      return 0;
+    }
+    return static_cast<long long>(count);
+  }
+#else
+  CacheMissCounter::CacheMissCounter() = default;
+
+  CacheMissCounter::~CacheMissCounter() = default;
+
+  void CacheMissCounter::start() {
+  }
+
+  long long CacheMissCounter::stop() {
+    return 0;
+  }
+#endif
+
+  bool CacheMissCounter::isAvailable() const {
+    return fd_ != -1;
+  }
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+namespace helgoboss::bench {
+  /**
+   * Counts the hardware cache misses (last level) of the current thread between start() and stop(), in user space
+   * only.
+   *
+   * Uses perf_event on Linux. Not available on other systems, or if the kernel doesn't allow it (see
+   * /proc/sys/kernel/perf_event_paranoid) or runs in a VM without access to the performance counters.
+   */
+  class CacheMissCounter {
+  private:
+    int fd_ = -1;
+  public:
+    CacheMissCounter();
+    CacheMissCounter(const CacheMissCounter& other) = delete;
+    CacheMissCounter& operator=(const CacheMissCounter& other) = delete;
+    ~CacheMissCounter();
+
+    bool isAvailable() const;
+
+    void start();
+
+    /**
+     * Returns the number of cache misses since start().
+     */
+    long long stop();
+  };
+}
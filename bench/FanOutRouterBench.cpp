@@ -0,0 +1,83 @@
+#include "Benchmark.h"
+#include "BenchTarget.h"
+#include <helgoboss-learn/FanOutRouter.h>
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/Source.h>
+#include <vector>
+
+using helgoboss::FanOutRouter;
+using helgoboss::MidiMessage;
+using helgoboss::ModeProcessor;
+using helgoboss::Mode;
+using helgoboss::Source;
+using helgoboss::SourceProcessor;
+using helgoboss::SourceValue;
+using helgoboss::Target;
+using helgoboss::bench::BenchTarget;
+using helgoboss::bench::Runner;
+
+namespace {
+  // One bank of faders, each controlling many targets
+  constexpr int FADER_COUNT = 32;
+  constexpr int TARGETS_PER_FADER = 16;
+  constexpr int EVENT_COUNT = 4096;
+
+  struct BenchMapping {
+    SourceProcessor source;
+    ModeProcessor mode;
+    Target* target;
+  };
+
+  // Each mapping has its own source, as it's the case without the router
+  void measureIndividualSources(Runner& runner, std::vector<BenchTarget>& targets,
+      const std::vector<SourceValue>& values) {
+    std::vector<BenchMapping> mappings;
+    for (int i = 0; i < FADER_COUNT * TARGETS_PER_FADER; i++) {
+      Source source;
+      source.channel.set(0);
+      source.midiMessageNumber.set(i % FADER_COUNT);
+      Mode mode;
+      mode.minTargetValue.set((i % 5) / 10.0);
+      mappings.push_back({source.getProcessor(), mode.getProcessor(), &targets.at(i)});
+    }
+    runner.measure("fanOut/individualSources", EVENT_COUNT, [&mappings, &values] {
+      for (const auto& value : values) {
+        for (auto& mapping : mappings) {
+          if (mapping.source.processes(value)) {
+            mapping.mode.processSourceValuePreferringFixedPoint(value, mapping.source, *mapping.target);
+          }
+        }
+      }
+    });
+  }
+
+  void measureRouter(Runner& runner, std::vector<BenchTarget>& targets, const std::vector<SourceValue>& values) {
+    FanOutRouter router;
+    for (int i = 0; i < FADER_COUNT * TARGETS_PER_FADER; i++) {
+      Source source;
+      source.channel.set(0);
+      source.midiMessageNumber.set(i % FADER_COUNT);
+      Mode mode;
+      mode.minTargetValue.set((i % 5) / 10.0);
+      router.addMapping(source.getProcessor(), mode.getProcessor(), targets.at(i));
+    }
+    runner.measure("fanOut/router", EVENT_COUNT, [&router, &values] {
+      std::size_t matchedGroupCount = 0;
+      for (const auto& value : values) {
+        matchedGroupCount += router.process(value);
+      }
+      helgoboss::bench::keep(matchedGroupCount);
+    });
+  }
+
+  const int registered = helgoboss::bench::registerBenchmark([](Runner& runner) {
+    std::vector<BenchTarget> targets(FADER_COUNT * TARGETS_PER_FADER);
+    std::vector<SourceValue> values;
+    values.reserve(EVENT_COUNT);
+    for (int i = 0; i < EVENT_COUNT; i++) {
+      values.emplace_back(MidiMessage::controlChange(0, (i * 7) % FADER_COUNT, i % 128));
+    }
+    measureIndividualSources(runner, targets, values);
+    measureRouter(runner, targets, values);
+  });
+}
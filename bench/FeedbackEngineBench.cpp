@@ -0,0 +1,98 @@
+#include "Benchmark.h"
+#include <helgoboss-learn/FeedbackEngine.h>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+using helgoboss::FeedbackEngine;
+using helgoboss::MidiMessage;
+using helgoboss::Mode;
+using helgoboss::Source;
+using helgoboss::SourceContext;
+using helgoboss::Target;
+using helgoboss::TargetCharacter;
+using helgoboss::bench::Runner;
+
+namespace {
+  constexpr int MAPPING_COUNT = 4096;
+
+  // Simulates a target whose value is expensive to query (e.g. formatting or converting a host parameter)
+  class ExpensiveTarget : public Target {
+  private:
+    double value_;
+  public:
+    explicit ExpensiveTarget(double value) : value_(value) {
+    }
+
+    TargetCharacter getCharacter() const override {
+      return TargetCharacter::Continuous;
+    }
+    double getStepSize() const override {
+      return -1;
+    }
+    bool wantsToBeHitWithStepCounts() const override {
+      return false;
+    }
+    void hit(double normalizedValue, bool isStepCount) override {
+      value_ = normalizedValue;
+    }
+    double getCurrentValue() const override {
+      double x = value_;
+      for (int i = 0; i < 50; i++) {
+        x = std::sqrt(x * x + 1e-9);
+      }
+      return std::min(x, 1.0);
+    }
+    int getMaxStepCount() const override {
+      return -1;
+    }
+    bool canBeDiscrete() const override {
+      return false;
+    }
+  };
+
+  class CountingSourceContext : public SourceContext {
+  public:
+    long long messageCount = 0;
+
+    void processMidiFeedback(const void* source, const MidiMessage& message) override {
+      messageCount += 1;
+    }
+    void processMidiFeedbackTwo(const void* source, const std::array<MidiMessage, 2>& messages) override {
+      messageCount += 2;
+    }
+  };
+
+  // Feedback of all mappings at once (one feedback timer tick), depending on the number of workers
+  void measureWorkerCount(Runner& runner, std::vector<Source>& sources, std::vector<Mode>& modes,
+      const std::vector<ExpensiveTarget>& targets, std::size_t workerCount) {
+    FeedbackEngine engine(workerCount);
+    for (int i = 0; i < MAPPING_COUNT; i++) {
+      engine.addMapping(sources[i], modes[i], targets[i]);
+    }
+    runner.measure("feedbackEngine/workers/" + std::to_string(workerCount), MAPPING_COUNT, [&engine] {
+      CountingSourceContext context;
+      engine.feedback(context);
+      helgoboss::bench::keep(context.messageCount);
+    });
+  }
+
+  const int registered = helgoboss::bench::registerBenchmark([](Runner& runner) {
+    std::vector<Source> sources(MAPPING_COUNT);
+    std::vector<Mode> modes(MAPPING_COUNT);
+    std::vector<ExpensiveTarget> targets;
+    targets.reserve(MAPPING_COUNT);
+    for (int i = 0; i < MAPPING_COUNT; i++) {
+      sources[i].channel.set(i % 16);
+      sources[i].midiMessageNumber.set(i % 128);
+      targets.emplace_back((i % 128) / 127.0);
+    }
+    const auto maxWorkerCount = std::max(std::thread::hardware_concurrency(), 1u);
+    for (std::size_t workerCount = 1; workerCount <= maxWorkerCount; workerCount *= 2) {
+      measureWorkerCount(runner, sources, modes, targets, workerCount);
+    }
+    if ((maxWorkerCount & (maxWorkerCount - 1)) != 0) {
+      measureWorkerCount(runner, sources, modes, targets, maxWorkerCount);
+    }
+  });
+}
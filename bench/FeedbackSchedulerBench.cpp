@@ -0,0 +1,97 @@
+#include "Benchmark.h"
+#include <helgoboss-learn/FeedbackScheduler.h>
+#include <helgoboss-learn/ReactiveProperty.h>
+#include <helgoboss-learn/SourceContext.h>
+
+using helgoboss::FeedbackScheduler;
+using helgoboss::MidiMessage;
+using helgoboss::Mode;
+using helgoboss::ObservableTarget;
+using helgoboss::ReactiveProperty;
+using helgoboss::Source;
+using helgoboss::SourceContext;
+using helgoboss::TargetCharacter;
+using helgoboss::bench::Runner;
+
+namespace {
+  constexpr int MAPPING_COUNT = 4096;
+  // Targets which change between two feedback cycles
+  constexpr int CHANGE_COUNT = 16;
+
+  class BenchTarget : public ObservableTarget {
+  public:
+    ReactiveProperty<double> value{0.5};
+
+    TargetCharacter getCharacter() const override {
+      return TargetCharacter::Continuous;
+    }
+    double getStepSize() const override {
+      return -1;
+    }
+    bool wantsToBeHitWithStepCounts() const override {
+      return false;
+    }
+    void hit(double normalizedValue, bool isStepCount) override {
+      value.set(normalizedValue);
+    }
+    double getCurrentValue() const override {
+      return value.get();
+    }
+    int getMaxStepCount() const override {
+      return -1;
+    }
+    bool canBeDiscrete() const override {
+      return false;
+    }
+    rxcpp::observable<bool> changed() const override {
+      return value.changed();
+    }
+  };
+
+  class CountingSourceContext : public SourceContext {
+  public:
+    long long messageCount = 0;
+
+    void processMidiFeedback(const void* source, const MidiMessage& message) override {
+      messageCount += 1;
+    }
+    void processMidiFeedbackTwo(const void* source, const std::array<MidiMessage, 2>& messages) override {
+      messageCount += 2;
+    }
+  };
+
+  void changeSomeTargets(std::vector<BenchTarget>& targets, int& cycle) {
+    cycle += 1;
+    for (int i = 0; i < CHANGE_COUNT; i++) {
+      targets[(cycle * 997 + i * 257) % MAPPING_COUNT].hit((cycle % 128) / 127.0, false);
+    }
+  }
+
+  // One feedback cycle after a few target changes. Items are all mappings, so the numbers are comparable.
+  const int registered = helgoboss::bench::registerBenchmark([](Runner& runner) {
+    std::vector<Source> sources(MAPPING_COUNT);
+    std::vector<Mode> modes(MAPPING_COUNT);
+    std::vector<BenchTarget> targets(MAPPING_COUNT);
+    FeedbackScheduler scheduler;
+    for (int i = 0; i < MAPPING_COUNT; i++) {
+      sources[i].channel.set(i % 16);
+      sources[i].midiMessageNumber.set(i % 128);
+      scheduler.addMapping(sources[i], modes[i], targets[i]);
+    }
+    int cycle = 0;
+    runner.measure("feedbackScheduler/allMappings", MAPPING_COUNT, [&] {
+      changeSomeTargets(targets, cycle);
+      CountingSourceContext context;
+      for (int i = 0; i < MAPPING_COUNT; i++) {
+        modes[i].feedback(sources[i], targets[i], context);
+      }
+      helgoboss::bench::keep(context.messageCount);
+    });
+    runner.measure("feedbackScheduler/dirtyMappings", MAPPING_COUNT, [&] {
+      changeSomeTargets(targets, cycle);
+      CountingSourceContext context;
+      scheduler.feedback(context);
+      helgoboss::bench::keep(context.messageCount);
+    });
+  });
+}
@@ -0,0 +1,40 @@
+#include "HeapCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+  std::atomic<std::ptrdiff_t> liveHeapBytes{0};
+
+  // Each block starts with its size, padded so that the returned pointer keeps the default alignment
+  constexpr std::size_t HEADER_SIZE = alignof(std::max_align_t);
+}
+
+void* operator new(std::size_t size) {
+  if (auto* block = static_cast<unsigned char*>(std::malloc(HEADER_SIZE + size))) {
+    *reinterpret_cast<std::size_t*>(block) = size;
+    liveHeapBytes.fetch_add(static_cast<std::ptrdiff_t>(size), std::memory_order_relaxed);
+    return block + HEADER_SIZE;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  if (p == nullptr) {
+    return;
+  }
+  auto* block = static_cast<unsigned char*>(p) - HEADER_SIZE;
+  liveHeapBytes.fetch_sub(static_cast<std::ptrdiff_t>(*reinterpret_cast<std::size_t*>(block)),
+      std::memory_order_relaxed);
+  std::free(block);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  operator delete(p);
+}
+
+namespace helgoboss::bench {
+  std::ptrdiff_t getLiveHeapBytes() {
+    return liveHeapBytes.load(std::memory_order_relaxed);
+  }
+}
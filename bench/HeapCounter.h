@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstddef>
+
+namespace helgoboss::bench {
+  /**
+   * Returns the number of bytes currently allocated on the heap with the global operator new, by all threads.
+   *
+   * Works because the bench executable replaces the global operator new. Allocations with extended alignment (e.g. by
+   * MappingBank) are not counted.
+   */
+  std::ptrdiff_t getLiveHeapBytes();
+}
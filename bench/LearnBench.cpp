@@ -0,0 +1,78 @@
+#include "Benchmark.h"
+#include <rxcpp/rx.hpp>
+#include <helgoboss-learn/source-util.h>
+
+using helgoboss::MidiMessage;
+using helgoboss::Midi14BitCcMessage;
+using helgoboss::MidiParameterNumberMessage;
+using helgoboss::Source;
+using helgoboss::SourceDescriptor;
+using helgoboss::bench::Runner;
+
+namespace {
+  constexpr int LEARN_MESSAGE_COUNT = 100000;
+
+  // Simulates a dense controller: Mostly notes, pressure and pitch bend on all channels, mixed with CC bursts
+  std::vector<MidiMessage> createLearnMessages() {
+    std::vector<MidiMessage> messages;
+    messages.reserve(LEARN_MESSAGE_COUNT);
+    for (int i = 0; i < LEARN_MESSAGE_COUNT; i++) {
+      const int channel = i % 16;
+      switch (i % 5) {
+        case 0:
+          messages.push_back(MidiMessage::noteOn(channel, i % 128, 100));
+          break;
+        case 1:
+          messages.push_back(MidiMessage::polyphonicKeyPressure(channel, i % 128, i % 128));
+          break;
+        case 2:
+          messages.push_back(MidiMessage::pitchBendChange(channel, i % 16384));
+          break;
+        case 3:
+          messages.push_back(MidiMessage::channelPressure(channel, i % 128));
+          break;
+        default:
+          messages.push_back(MidiMessage::controlChange(0, 7, i % 128));
+          break;
+      }
+    }
+    return messages;
+  }
+
+  template<typename Parse>
+  void feedLearnPipeline(const std::vector<MidiMessage>& messages, Parse parse) {
+    // Timeouts are scheduled on a run loop which is never dispatched, so the benchmark measures just the pipeline
+    rxcpp::schedulers::run_loop runLoop;
+    const auto coordination = rxcpp::identity_one_worker(rxcpp::schedulers::make_run_loop(runLoop));
+    rxcpp::subjects::subject<MidiMessage> midiMessages;
+    long long candidateCount = 0;
+    auto subscription = parse(
+        midiMessages.get_observable(),
+        rxcpp::observable<>::empty<Midi14BitCcMessage>(),
+        rxcpp::observable<>::empty<MidiParameterNumberMessage>(),
+        coordination
+    ).subscribe([&candidateCount](const auto&) {
+      candidateCount += 1;
+    });
+    const auto subscriber = midiMessages.get_subscriber();
+    for (const auto& msg : messages) {
+      subscriber.on_next(msg);
+    }
+    subscription.unsubscribe();
+    helgoboss::bench::keep(candidateCount);
+  }
+
+  const int registered = helgoboss::bench::registerBenchmark([](Runner& runner) {
+    const auto messages = createLearnMessages();
+    runner.measure("learn/parseSources", LEARN_MESSAGE_COUNT, [&messages] {
+      feedLearnPipeline(messages, [](auto... args) {
+        return helgoboss::util::parseSources(args...);
+      });
+    });
+    runner.measure("learn/parseSourceDescriptors", LEARN_MESSAGE_COUNT, [&messages] {
+      feedLearnPipeline(messages, [](auto... args) {
+        return helgoboss::util::parseSourceDescriptors(args...);
+      });
+    });
+  });
+}
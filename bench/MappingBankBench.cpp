@@ -0,0 +1,90 @@
+#include "Benchmark.h"
+#include "BenchTarget.h"
+#include "CacheMissCounter.h"
+#include <helgoboss-learn/MappingBank.h>
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/Source.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using helgoboss::MappingBank;
+using helgoboss::MidiMessage;
+using helgoboss::Mode;
+using helgoboss::Source;
+using helgoboss::SourceType;
+using helgoboss::SourceValue;
+using helgoboss::bench::BenchTarget;
+using helgoboss::bench::Runner;
+
+namespace {
+  // Each event has to be checked against all mappings, only a few of them match
+  constexpr int MAPPING_COUNT = 10000;
+  constexpr int EVENT_COUNT = 256;
+
+  // Objects are allocated one by one, as in a host which loads them from a preset, so they are spread over the heap
+  struct BenchMappings {
+    std::vector<std::unique_ptr<Source>> sources;
+    std::vector<std::unique_ptr<Mode>> modes;
+    std::vector<BenchTarget> targets;
+
+    BenchMappings() : targets(MAPPING_COUNT) {
+      for (int i = 0; i < MAPPING_COUNT; i++) {
+        auto source = std::make_unique<Source>();
+        source->type.set(i % 3 == 0 ? SourceType::NoteVelocity : SourceType::ControlChangeValue);
+        source->channel.set(i % 16);
+        source->midiMessageNumber.set(i % 128);
+        auto mode = std::make_unique<Mode>();
+        mode->minTargetValue.set((i % 5) / 10.0);
+        mode->reverseIsEnabled.set(i % 2 == 1);
+        sources.push_back(std::move(source));
+        modes.push_back(std::move(mode));
+      }
+    }
+  };
+
+  // The point of the bank is touching fewer cache lines, which time alone only shows indirectly. Silently skipped
+  // where the hardware counters are not available (see CacheMissCounter).
+  void measureTimeAndCacheMisses(Runner& runner, const std::string& name, const std::function<void()>& run) {
+    runner.measure(name, EVENT_COUNT, run);
+    helgoboss::bench::CacheMissCounter cacheMissCounter;
+    if (!cacheMissCounter.isAvailable()) {
+      return;
+    }
+    cacheMissCounter.start();
+    run();
+    runner.recordCount(name, "cache misses", EVENT_COUNT, cacheMissCounter.stop());
+  }
+
+  const int registered = helgoboss::bench::registerBenchmark([](Runner& runner) {
+    BenchMappings mappings;
+    std::vector<SourceValue> values;
+    values.reserve(EVENT_COUNT);
+    for (int i = 0; i < EVENT_COUNT; i++) {
+      values.emplace_back(MidiMessage::controlChange(i % 16, (i * 7) % 128, i % 128));
+    }
+    measureTimeAndCacheMisses(runner, "mappingBank/process/objects/10k", [&mappings, &values] {
+      for (const auto& value : values) {
+        for (int i = 0; i < MAPPING_COUNT; i++) {
+          const auto& sourceProcessor = mappings.sources[i]->getProcessor();
+          if (sourceProcessor.processes(value)) {
+            mappings.modes[i]->getProcessor().processSourceValue(sourceProcessor.getNormalizedValue(value),
+                sourceProcessor, mappings.targets[i]);
+          }
+        }
+      }
+    });
+    MappingBank bank;
+    for (int i = 0; i < MAPPING_COUNT; i++) {
+      bank.addMapping(*mappings.sources[i], *mappings.modes[i], mappings.targets[i]);
+    }
+    measureTimeAndCacheMisses(runner, "mappingBank/process/bank/10k", [&bank, &values] {
+      std::size_t matchCount = 0;
+      for (const auto& value : values) {
+        matchCount += bank.process(value);
+      }
+      helgoboss::bench::keep(matchCount);
+    });
+  });
+}
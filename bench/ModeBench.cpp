@@ -0,0 +1,105 @@
+#include "Benchmark.h"
+#include "BenchTarget.h"
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/Source.h>
+#include <helgoboss-learn/SourceContext.h>
+
+using helgoboss::MidiClockTransportMessageType;
+using helgoboss::MidiMessage;
+using helgoboss::Mode;
+using helgoboss::ModeType;
+using helgoboss::Source;
+using helgoboss::SourceCharacter;
+using helgoboss::SourceContext;
+using helgoboss::SourceProcessor;
+using helgoboss::SourceType;
+using helgoboss::bench::BenchTarget;
+using helgoboss::bench::Runner;
+
+namespace {
+  constexpr int EVENT_COUNT = 16384;
+
+  class BenchSourceContext : public SourceContext {
+  public:
+    long long messageCount = 0;
+
+    void processMidiFeedback(const void* source, const MidiMessage& message) override {
+      messageCount += 1;
+    }
+    void processMidiFeedbackTwo(const void* source, const std::array<MidiMessage, 2>& messages) override {
+      messageCount += 2;
+    }
+  };
+
+  Mode createMode(ModeType type, bool withEel) {
+    Mode mode;
+    mode.type.set(type);
+    mode.minTargetValue.set(0.1);
+    mode.maxTargetValue.set(0.9);
+    if (withEel) {
+      mode.eelControlTransformation.set("y = x * x");
+      mode.eelFeedbackTransformation.set("x = 1 - y");
+    }
+    return mode;
+  }
+
+  SourceProcessor createSourceProcessor(SourceCharacter character) {
+    return SourceProcessor(SourceType::ControlChangeValue, 0, false, false, 7, character,
+        MidiClockTransportMessageType::Start);
+  }
+
+  // Normalized values as emitted by absolute sources, respectively step counts as emitted by encoders
+  std::vector<double> createSourceValues(bool stepCounts) {
+    std::vector<double> values;
+    values.reserve(EVENT_COUNT);
+    for (int i = 0; i < EVENT_COUNT; i++) {
+      values.push_back(stepCounts ? (i % 2 == 0 ? 1 : -1) : (i % 128) / 127.0);
+    }
+    return values;
+  }
+
+  void measureProcessing(Runner& runner, ModeType type, const std::string& typeName, bool withEel) {
+    const auto name = "modeProcessor/processSourceValue/" + typeName + (withEel ? "/eel" : "");
+    const bool isRelative = type == ModeType::Relative;
+    const auto sourceProcessor = createSourceProcessor(isRelative ? SourceCharacter::Encoder1 : SourceCharacter::Range);
+    const auto values = createSourceValues(isRelative);
+    auto mode = createMode(type, withEel);
+    runner.measure(name, EVENT_COUNT, [&mode, &sourceProcessor, &values] {
+      BenchTarget target;
+      auto& modeProcessor = mode.getProcessor();
+      for (const auto value : values) {
+        modeProcessor.processSourceValue(value, sourceProcessor, target);
+      }
+      helgoboss::bench::keep(target.getCurrentValue());
+    });
+  }
+
+  void measureFeedback(Runner& runner, bool withEel) {
+    auto mode = createMode(ModeType::Absolute, withEel);
+    Source source;
+    source.type.set(SourceType::ControlChangeValue);
+    source.channel.set(0);
+    source.midiMessageNumber.set(7);
+    std::vector<BenchTarget> targets(EVENT_COUNT);
+    for (int i = 0; i < EVENT_COUNT; i++) {
+      targets.at(i).hit((i % 128) / 127.0, false);
+    }
+    runner.measure(std::string("mode/feedback") + (withEel ? "/eel" : ""), EVENT_COUNT, [&mode, &source, &targets] {
+      BenchSourceContext context;
+      for (const auto& target : targets) {
+        mode.feedback(source, target, context);
+      }
+      helgoboss::bench::keep(context.messageCount);
+    });
+  }
+
+  const int registered = helgoboss::bench::registerBenchmark([](Runner& runner) {
+    for (const bool withEel : {false, true}) {
+      measureProcessing(runner, ModeType::Absolute, "absolute", withEel);
+      measureProcessing(runner, ModeType::Relative, "relative", withEel);
+      measureProcessing(runner, ModeType::Toggle, "toggle", withEel);
+    }
+    measureFeedback(runner, false);
+    measureFeedback(runner, true);
+  });
+}
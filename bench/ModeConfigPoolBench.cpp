@@ -0,0 +1,79 @@
+#include "Benchmark.h"
+#include "BenchTarget.h"
+#include "HeapCounter.h"
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/ModeConfigPool.h>
+#include <helgoboss-learn/Source.h>
+#include <string>
+#include <vector>
+
+using helgoboss::ModeConfigPool;
+using helgoboss::ModeProcessor;
+using helgoboss::ModeType;
+using helgoboss::Source;
+using helgoboss::bench::BenchTarget;
+using helgoboss::bench::Runner;
+
+namespace {
+  // A large preset in which most mappings use one of a few typical mode settings
+  constexpr int MAPPING_COUNT = 10000;
+  constexpr int DISTINCT_SETTING_COUNT = 8;
+
+  ModeProcessor createModeProcessor(int i) {
+    const int variant = i % DISTINCT_SETTING_COUNT;
+    return ModeProcessor(ModeType::Absolute, variant * 0.05, 1.0, 0.0, 1.0, variant % 2 == 1, false, 0.0, 1.0,
+        variant < DISTINCT_SETTING_COUNT / 2 ? "" : "y = x * x", false, false, 0.01, 0.01, false);
+  }
+
+  // One event fanned out to all mappings
+  void measureProcessing(Runner& runner, const std::string& name, std::vector<ModeProcessor>& processors) {
+    const auto sourceProcessor = Source().getProcessor();
+    std::vector<BenchTarget> targets(processors.size());
+    runner.measure(name, MAPPING_COUNT, [&processors, &sourceProcessor, &targets] {
+      for (std::size_t i = 0; i < processors.size(); i++) {
+        processors[i].processSourceValue(0.7, sourceProcessor, targets[i]);
+      }
+      helgoboss::bench::keep(targets.back().getCurrentValue());
+    });
+  }
+
+  const int registered = helgoboss::bench::registerBenchmark([](Runner& runner) {
+    runner.measure("modeConfigPool/construct/own/10k", MAPPING_COUNT, [] {
+      std::vector<ModeProcessor> processors;
+      processors.reserve(MAPPING_COUNT);
+      for (int i = 0; i < MAPPING_COUNT; i++) {
+        processors.push_back(createModeProcessor(i));
+      }
+      helgoboss::bench::keep(processors);
+    });
+    runner.measure("modeConfigPool/construct/pooled/10k", MAPPING_COUNT, [] {
+      ModeConfigPool pool;
+      std::vector<ModeProcessor> processors;
+      processors.reserve(MAPPING_COUNT);
+      for (int i = 0; i < MAPPING_COUNT; i++) {
+        processors.push_back(pool.intern(createModeProcessor(i)));
+      }
+      helgoboss::bench::keep(processors);
+    });
+    // Processors, configurations and (in the pooled case) the pool itself, per mapping
+    const auto ownHeapBytesBefore = helgoboss::bench::getLiveHeapBytes();
+    std::vector<ModeProcessor> ownProcessors;
+    ownProcessors.reserve(MAPPING_COUNT);
+    for (int i = 0; i < MAPPING_COUNT; i++) {
+      ownProcessors.push_back(createModeProcessor(i));
+    }
+    runner.recordCount("modeConfigPool/memory/own/10k", "bytes", MAPPING_COUNT,
+        helgoboss::bench::getLiveHeapBytes() - ownHeapBytesBefore);
+    const auto pooledHeapBytesBefore = helgoboss::bench::getLiveHeapBytes();
+    ModeConfigPool pool;
+    std::vector<ModeProcessor> pooledProcessors;
+    pooledProcessors.reserve(MAPPING_COUNT);
+    for (int i = 0; i < MAPPING_COUNT; i++) {
+      pooledProcessors.push_back(pool.intern(createModeProcessor(i)));
+    }
+    runner.recordCount("modeConfigPool/memory/pooled/10k", "bytes", MAPPING_COUNT,
+        helgoboss::bench::getLiveHeapBytes() - pooledHeapBytesBefore);
+    measureProcessing(runner, "modeConfigPool/process/own/10k", ownProcessors);
+    measureProcessing(runner, "modeConfigPool/process/pooled/10k", pooledProcessors);
+  });
+}
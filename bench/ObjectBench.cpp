@@ -0,0 +1,93 @@
+#include "Benchmark.h"
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/ReactiveProperty.h>
+#include <helgoboss-learn/Source.h>
+
+using helgoboss::Mode;
+using helgoboss::ModeType;
+using helgoboss::ReactiveProperty;
+using helgoboss::Source;
+using helgoboss::SourceType;
+using helgoboss::bench::Runner;
+
+namespace {
+  constexpr int OBJECT_COUNT = 1000;
+  constexpr int SET_COUNT = 100000;
+
+  Source createSource() {
+    Source source;
+    source.type.set(SourceType::ControlChangeValue);
+    source.channel.set(3);
+    source.midiMessageNumber.set(74);
+    return source;
+  }
+
+  Mode createMode() {
+    Mode mode;
+    mode.type.set(ModeType::Absolute);
+    mode.minTargetValue.set(0.1);
+    mode.maxTargetValue.set(0.9);
+    mode.eelControlTransformation.set("y = x * x");
+    return mode;
+  }
+
+  const int registered = helgoboss::bench::registerBenchmark([](Runner& runner) {
+    // Properties
+    runner.measure("reactiveProperty/set", SET_COUNT, [] {
+      ReactiveProperty<double> property{0.0};
+      for (int i = 0; i < SET_COUNT; i++) {
+        property.set(i);
+      }
+      helgoboss::bench::keep(property.get());
+    });
+    runner.measure("reactiveProperty/set/subscribed", SET_COUNT, [] {
+      ReactiveProperty<double> property{0.0};
+      long long changeCount = 0;
+      property.changed().subscribe([&changeCount](double) {
+        changeCount += 1;
+      });
+      for (int i = 0; i < SET_COUNT; i++) {
+        property.set(i);
+      }
+      helgoboss::bench::keep(changeCount);
+    });
+    // Construction and copying
+    runner.measure("source/construct", OBJECT_COUNT, [] {
+      std::vector<Source> sources(OBJECT_COUNT);
+      helgoboss::bench::keep(sources);
+    });
+    const std::vector<Source> sources(OBJECT_COUNT, createSource());
+    runner.measure("source/copy", OBJECT_COUNT, [&sources] {
+      const auto copies = sources;
+      helgoboss::bench::keep(copies);
+    });
+    runner.measure("mode/construct", OBJECT_COUNT, [] {
+      std::vector<Mode> modes(OBJECT_COUNT);
+      helgoboss::bench::keep(modes);
+    });
+    const std::vector<Mode> modes(OBJECT_COUNT, createMode());
+    runner.measure("mode/copy", OBJECT_COUNT, [&modes] {
+      const auto copies = modes;
+      helgoboss::bench::keep(copies);
+    });
+    // JSON round trips of single objects, see PresetBench for whole presets
+    std::vector<Source> sourceResults(OBJECT_COUNT);
+    runner.measure("json/source/roundTrip", OBJECT_COUNT, [&sources, &results = sourceResults] {
+      for (int i = 0; i < OBJECT_COUNT; i++) {
+        nlohmann::json j;
+        sources[i].serializeToJson(j);
+        results[i].updateFromJson(nlohmann::json::parse(j.dump()));
+      }
+      helgoboss::bench::keep(results);
+    });
+    std::vector<Mode> modeResults(OBJECT_COUNT);
+    runner.measure("json/mode/roundTrip", OBJECT_COUNT, [&modes, &results = modeResults] {
+      for (int i = 0; i < OBJECT_COUNT; i++) {
+        nlohmann::json j;
+        modes[i].serializeToJson(j);
+        results[i].updateFromJson(nlohmann::json::parse(j.dump()));
+      }
+      helgoboss::bench::keep(results);
+    });
+  });
+}
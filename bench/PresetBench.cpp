@@ -0,0 +1,169 @@
+#include "Benchmark.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <helgoboss-learn/preset-util.h>
+#include <helgoboss-learn/BinaryPreset.h>
+#include <helgoboss-learn/MappedFile.h>
+
+using helgoboss::ConstMappingRef;
+using helgoboss::MappingRef;
+using helgoboss::Mode;
+using helgoboss::ModeType;
+using helgoboss::ProcessorActivation;
+using helgoboss::Source;
+using helgoboss::SourceType;
+using helgoboss::bench::Runner;
+
+namespace {
+  constexpr int PRESET_MAPPING_COUNT = 5000;
+  constexpr int LARGE_PRESET_MAPPING_COUNT = 10000;
+
+  struct Preset {
+    int mappingCount;
+    std::vector<Source> sources;
+    std::vector<Mode> modes;
+
+    explicit Preset(int mappingCount = PRESET_MAPPING_COUNT) :
+        mappingCount(mappingCount),
+        sources(mappingCount),
+        modes(mappingCount) {
+      for (int i = 0; i < mappingCount; i++) {
+        auto& source = sources.at(i);
+        source.type.set(i % 4 == 0 ? SourceType::NoteVelocity : SourceType::ControlChangeValue);
+        source.channel.set(i % 16);
+        source.midiMessageNumber.set(i % 128);
+        auto& mode = modes.at(i);
+        mode.type.set(i % 3 == 0 ? ModeType::Relative : ModeType::Absolute);
+        mode.minTargetValue.set(0.1);
+        mode.maxTargetValue.set(0.9);
+        if (i % 10 == 0) {
+          mode.eelControlTransformation.set("y = x * x");
+        }
+      }
+    }
+
+    std::vector<ConstMappingRef> getConstMappings() const {
+      std::vector<ConstMappingRef> mappings;
+      for (int i = 0; i < mappingCount; i++) {
+        mappings.push_back({&sources.at(i), &modes.at(i)});
+      }
+      return mappings;
+    }
+
+    std::vector<MappingRef> getMappings() {
+      std::vector<MappingRef> mappings;
+      for (int i = 0; i < mappingCount; i++) {
+        mappings.push_back({&sources.at(i), &modes.at(i)});
+      }
+      return mappings;
+    }
+  };
+
+  const int registered = helgoboss::bench::registerBenchmark([](Runner& runner) {
+    Preset preset;
+    const auto constMappings = preset.getConstMappings();
+    runner.measure("preset/serialize/perObject", PRESET_MAPPING_COUNT, [&preset] {
+      auto j = nlohmann::json::array();
+      for (int i = 0; i < PRESET_MAPPING_COUNT; i++) {
+        nlohmann::json mappingJson;
+        preset.sources.at(i).serializeToJson(mappingJson["source"]);
+        preset.modes.at(i).serializeToJson(mappingJson["mode"]);
+        j.push_back(std::move(mappingJson));
+      }
+      helgoboss::bench::keep(j.dump());
+    });
+    runner.measure("preset/serialize/serializeMappings", PRESET_MAPPING_COUNT, [&constMappings] {
+      helgoboss::bench::keep(helgoboss::util::serializeMappings(constMappings));
+    });
+    const auto text = helgoboss::util::serializeMappings(constMappings);
+    Preset loadedPreset;
+    const auto loadedMappings = loadedPreset.getMappings();
+    runner.measure("preset/deserialize/perObject", PRESET_MAPPING_COUNT, [&text, &loadedPreset] {
+      const auto j = nlohmann::json::parse(text);
+      for (int i = 0; i < PRESET_MAPPING_COUNT; i++) {
+        const auto mappingJson = j.at(i);
+        loadedPreset.sources.at(i).updateFromJson(mappingJson.at("source"));
+        loadedPreset.modes.at(i).updateFromJson(mappingJson.at("mode"));
+      }
+    });
+    runner.measure("preset/deserialize/deserializeMappings", PRESET_MAPPING_COUNT, [&text, &loadedMappings] {
+      helgoboss::util::deserializeMappings(nlohmann::json::parse(text), loadedMappings);
+    });
+    runner.measure("preset/deserialize/loadMappings", PRESET_MAPPING_COUNT, [&text, &loadedMappings] {
+      std::istringstream input(text);
+      helgoboss::util::loadMappings(
+          input,
+          [&loadedMappings](std::size_t index) {
+            return loadedMappings.at(index);
+          },
+          [](std::size_t, MappingRef) {
+          }
+      );
+    });
+  });
+
+  // Unconfigured mappings, as created on startup before loading the preset
+  struct EmptyMappings {
+    std::vector<Source> sources;
+    std::vector<Mode> modes;
+    std::vector<MappingRef> mappings;
+
+    EmptyMappings(int mappingCount, ProcessorActivation activation) {
+      sources.reserve(mappingCount);
+      modes.reserve(mappingCount);
+      for (int i = 0; i < mappingCount; i++) {
+        sources.emplace_back(activation);
+        modes.emplace_back(activation);
+        mappings.push_back({&sources.back(), &modes.back()});
+      }
+    }
+  };
+
+  void writeFile(const std::string& path, const std::string& contents) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(contents.data(), contents.size());
+  }
+
+  std::string readFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  const int registeredColdStart = helgoboss::bench::registerBenchmark([](Runner& runner) {
+    const auto tempDir = std::filesystem::temp_directory_path();
+    const auto jsonPath = (tempDir / "helgoboss-learn-bench-preset.json").string();
+    const auto binaryPath = (tempDir / "helgoboss-learn-bench-preset.bin").string();
+    {
+      const Preset preset(LARGE_PRESET_MAPPING_COUNT);
+      const auto constMappings = preset.getConstMappings();
+      writeFile(jsonPath, helgoboss::util::serializeMappings(constMappings));
+      writeFile(binaryPath, helgoboss::util::serializeMappingsToBinary(constMappings));
+    }
+    // Loads into freshly created mappings, just like on startup
+    runner.measure("preset/coldStart/json", LARGE_PRESET_MAPPING_COUNT, [&jsonPath] {
+      Preset loadedPreset(LARGE_PRESET_MAPPING_COUNT);
+      helgoboss::util::deserializeMappings(nlohmann::json::parse(readFile(jsonPath)), loadedPreset.getMappings());
+    });
+    runner.measure("preset/coldStart/binary", LARGE_PRESET_MAPPING_COUNT, [&binaryPath] {
+      Preset loadedPreset(LARGE_PRESET_MAPPING_COUNT);
+      const helgoboss::MappedFile file(binaryPath);
+      helgoboss::BinaryPresetView(file.getData(), file.getSize()).loadMappings(loadedPreset.getMappings());
+    });
+    // Time until all mappings are ready to receive events
+    runner.measure("preset/startup/eager", LARGE_PRESET_MAPPING_COUNT, [&binaryPath] {
+      EmptyMappings loaded(LARGE_PRESET_MAPPING_COUNT, ProcessorActivation::Eager);
+      const helgoboss::MappedFile file(binaryPath);
+      helgoboss::BinaryPresetView(file.getData(), file.getSize()).loadMappings(loaded.mappings);
+    });
+    runner.measure("preset/startup/lazy", LARGE_PRESET_MAPPING_COUNT, [&binaryPath] {
+      EmptyMappings loaded(LARGE_PRESET_MAPPING_COUNT, ProcessorActivation::Lazy);
+      const helgoboss::MappedFile file(binaryPath);
+      helgoboss::BinaryPresetView(file.getData(), file.getSize()).loadMappings(loaded.mappings);
+    });
+    std::remove(jsonPath.c_str());
+    std::remove(binaryPath.c_str());
+  });
+}
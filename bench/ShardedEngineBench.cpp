@@ -0,0 +1,61 @@
+#include "Benchmark.h"
+#include "BenchTarget.h"
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/ShardedEngine.h>
+#include <helgoboss-learn/Source.h>
+#include <algorithm>
+#include <thread>
+
+using helgoboss::MidiMessage;
+using helgoboss::Mode;
+using helgoboss::PortEvent;
+using helgoboss::ShardedEngine;
+using helgoboss::Source;
+using helgoboss::SourceValue;
+using helgoboss::bench::BenchTarget;
+using helgoboss::bench::Runner;
+
+namespace {
+  constexpr int PORT_COUNT = 16;
+  // Two channels with 128 CCs each
+  constexpr int MAPPINGS_PER_PORT = 256;
+  constexpr int EVENT_COUNT = 4096;
+
+  // Throughput of one batch of events spread evenly across all ports, depending on the number of workers. Each port
+  // has its own targets, so the shards don't interfere.
+  void measureWorkerCount(Runner& runner, std::vector<BenchTarget>& targets, const std::vector<PortEvent>& events,
+      std::size_t workerCount) {
+    ShardedEngine engine(workerCount);
+    for (int port = 0; port < PORT_COUNT; port++) {
+      for (int i = 0; i < MAPPINGS_PER_PORT; i++) {
+        Source source;
+        source.channel.set(i / 128);
+        source.midiMessageNumber.set(i % 128);
+        Mode mode;
+        mode.maxTargetJump.set(0.5);
+        engine.addMapping(port, source.getProcessor(), mode.getProcessor(),
+            targets.at(port * MAPPINGS_PER_PORT + i));
+      }
+    }
+    runner.measure("shardedEngine/workers/" + std::to_string(workerCount), EVENT_COUNT, [&engine, &events] {
+      engine.process(events);
+    });
+  }
+
+  const int registered = helgoboss::bench::registerBenchmark([](Runner& runner) {
+    std::vector<BenchTarget> targets(PORT_COUNT * MAPPINGS_PER_PORT);
+    std::vector<PortEvent> events;
+    events.reserve(EVENT_COUNT);
+    for (int i = 0; i < EVENT_COUNT; i++) {
+      const auto channel = (i / PORT_COUNT) % 2;
+      events.push_back({i % PORT_COUNT, SourceValue(MidiMessage::controlChange(channel, (i * 7) % 128, i % 128))});
+    }
+    const auto maxWorkerCount = std::max(std::thread::hardware_concurrency(), 1u);
+    for (std::size_t workerCount = 1; workerCount <= maxWorkerCount; workerCount *= 2) {
+      measureWorkerCount(runner, targets, events, workerCount);
+    }
+    if ((maxWorkerCount & (maxWorkerCount - 1)) != 0) {
+      measureWorkerCount(runner, targets, events, maxWorkerCount);
+    }
+  });
+}
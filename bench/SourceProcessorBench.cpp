@@ -0,0 +1,194 @@
+#include "Benchmark.h"
+#include <helgoboss-learn/SourceProcessor.h>
+
+using helgoboss::Midi14BitCcMessage;
+using helgoboss::MidiClockTransportMessageType;
+using helgoboss::MidiMessage;
+using helgoboss::MidiParameterNumberMessage;
+using helgoboss::SourceCharacter;
+using helgoboss::SourceProcessor;
+using helgoboss::SourceType;
+using helgoboss::SourceValue;
+using helgoboss::SourceValueType;
+using helgoboss::Tempo;
+using helgoboss::TempoMessage;
+using helgoboss::bench::Runner;
+
+namespace {
+  constexpr int EVENT_COUNT = 16384;
+
+  SourceProcessor createProcessor(SourceType type) {
+    return SourceProcessor(type, -1, false, false, -1, SourceCharacter::Range, MidiClockTransportMessageType::Start);
+  }
+
+  template<typename CreateMessage>
+  std::vector<SourceValue> createSourceValues(CreateMessage createMessage) {
+    std::vector<SourceValue> values;
+    values.reserve(EVENT_COUNT);
+    for (int i = 0; i < EVENT_COUNT; i++) {
+      values.emplace_back(createMessage(i));
+    }
+    return values;
+  }
+
+  // Per-event cost of converting incoming MIDI into normalized values
+  void measureNormalization(Runner& runner, const std::string& name, const SourceProcessor& processor,
+      const std::vector<SourceValue>& values) {
+    runner.measure(name, EVENT_COUNT, [&processor, &values] {
+      double sum = 0;
+      for (const auto& value : values) {
+        sum += processor.getNormalizedValue(value);
+      }
+      helgoboss::bench::keep(sum);
+    });
+  }
+
+  // Same with the integer fixed-point variant
+  void measureFixedPointNormalization(Runner& runner, const std::string& name, const SourceProcessor& processor,
+      const std::vector<SourceValue>& values) {
+    runner.measure(name, EVENT_COUNT, [&processor, &values] {
+      long long sum = 0;
+      for (const auto& value : values) {
+        sum += *processor.getFixedPointValue(value);
+      }
+      helgoboss::bench::keep(static_cast<double>(sum));
+    });
+  }
+
+  // Per-event cost of deciding whether incoming MIDI is relevant for a source. Half of the events don't match.
+  void measureMatching(Runner& runner, const std::string& name, const SourceProcessor& processor,
+      const std::vector<SourceValue>& values) {
+    runner.measure(name, EVENT_COUNT, [&processor, &values] {
+      long long matchCount = 0;
+      for (const auto& value : values) {
+        matchCount += processor.processes(value) ? 1 : 0;
+      }
+      helgoboss::bench::keep(matchCount);
+    });
+  }
+
+  struct SourceTypeCase {
+    std::string name;
+    SourceProcessor processor;
+    std::vector<SourceValue> values;
+  };
+
+  std::vector<SourceTypeCase> createSourceTypeCases() {
+    return {
+        {
+            "controlChange", createProcessor(SourceType::ControlChangeValue),
+            createSourceValues([](int i) {
+              return MidiMessage::controlChange(i % 16, i % 128, i % 128);
+            })
+        },
+        {
+            "controlChange14Bit",
+            SourceProcessor(SourceType::ControlChangeValue, -1, true, false, -1, SourceCharacter::Range,
+                MidiClockTransportMessageType::Start),
+            createSourceValues([](int i) {
+              return Midi14BitCcMessage(i % 16, i % 32, i % 16384);
+            })
+        },
+        {
+            "noteVelocity", createProcessor(SourceType::NoteVelocity),
+            createSourceValues([](int i) {
+              return MidiMessage::noteOn(i % 16, i % 128, i % 127 + 1);
+            })
+        },
+        {
+            "noteKeyNumber", createProcessor(SourceType::NoteKeyNumber),
+            createSourceValues([](int i) {
+              return MidiMessage::noteOn(i % 16, i % 128, 100);
+            })
+        },
+        {
+            "pitchBend", createProcessor(SourceType::PitchBendChangeValue),
+            createSourceValues([](int i) {
+              return MidiMessage::pitchBendChange(i % 16, i % 16384);
+            })
+        },
+        {
+            "channelPressure", createProcessor(SourceType::ChannelPressureAmount),
+            createSourceValues([](int i) {
+              return MidiMessage::channelPressure(i % 16, i % 128);
+            })
+        },
+        {
+            "polyphonicKeyPressure", createProcessor(SourceType::PolyphonicKeyPressureAmount),
+            createSourceValues([](int i) {
+              return MidiMessage::polyphonicKeyPressure(i % 16, i % 128, i % 128);
+            })
+        },
+        {
+            "programChange", createProcessor(SourceType::ProgramChangeNumber),
+            createSourceValues([](int i) {
+              return MidiMessage::programChange(i % 16, i % 128);
+            })
+        },
+        {
+            "parameterNumber",
+            SourceProcessor(SourceType::ParameterNumberMessageValue, -1, true, true, -1, SourceCharacter::Range,
+                MidiClockTransportMessageType::Start),
+            createSourceValues([](int i) {
+              return MidiParameterNumberMessage(i % 16, i % 16384, i % 16384, true, true);
+            })
+        },
+        {
+            "clockTempo", createProcessor(SourceType::ClockTempo),
+            createSourceValues([](int i) {
+              return TempoMessage{60.0 + i % 200};
+            })
+        }
+    };
+  }
+
+  // Same values but every second one is of the wrong kind, so processes() has to reject it
+  std::vector<SourceValue> mixWithNonMatchingValues(const std::vector<SourceValue>& values) {
+    std::vector<SourceValue> mixedValues = values;
+    for (std::size_t i = 1; i < mixedValues.size(); i += 2) {
+      mixedValues[i] = mixedValues[i].getType() == SourceValueType::MidiMessage
+          ? SourceValue(TempoMessage{120.0})
+          : SourceValue(MidiMessage::controlChange(0, 1, 0));
+    }
+    return mixedValues;
+  }
+
+  const int registered = helgoboss::bench::registerBenchmark([](Runner& runner) {
+    const auto sourceTypeCases = createSourceTypeCases();
+    for (const auto& sourceTypeCase : sourceTypeCases) {
+      measureMatching(runner, "sourceProcessor/processes/" + sourceTypeCase.name, sourceTypeCase.processor,
+          mixWithNonMatchingValues(sourceTypeCase.values));
+    }
+    for (const auto& sourceTypeCase : sourceTypeCases) {
+      measureNormalization(runner, "sourceProcessor/getNormalizedValue/" + sourceTypeCase.name,
+          sourceTypeCase.processor, sourceTypeCase.values);
+    }
+    for (const auto& sourceTypeCase : sourceTypeCases) {
+      if (sourceTypeCase.name == "pitchBend" || sourceTypeCase.name == "controlChange14Bit") {
+        measureFixedPointNormalization(runner, "sourceProcessor/getFixedPointValue/" + sourceTypeCase.name,
+            sourceTypeCase.processor, sourceTypeCase.values);
+      }
+    }
+    // Inputs are not known at compile time, otherwise the whole loop could be folded
+    std::vector<double> bpms;
+    std::vector<double> normalizedValues;
+    for (int i = 0; i < EVENT_COUNT; i++) {
+      bpms.push_back(60.0 + i % 200);
+      normalizedValues.push_back(i / double(EVENT_COUNT));
+    }
+    runner.measure("tempo/normalizedValue", EVENT_COUNT, [&bpms] {
+      double sum = 0;
+      for (const auto bpm : bpms) {
+        sum += Tempo(bpm).normalizedValue();
+      }
+      helgoboss::bench::keep(sum);
+    });
+    runner.measure("tempo/ofNormalizedValue", EVENT_COUNT, [&normalizedValues] {
+      double sum = 0;
+      for (const auto normalizedValue : normalizedValues) {
+        sum += Tempo::ofNormalizedValue(normalizedValue).bpm();
+      }
+      helgoboss::bench::keep(sum);
+    });
+  });
+}
@@ -0,0 +1,125 @@
+#include "Benchmark.h"
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+using helgoboss::bench::BenchmarkResult;
+using helgoboss::bench::CounterResult;
+using helgoboss::bench::Runner;
+
+namespace {
+  constexpr int JSON_FORMAT_VERSION = 1;
+
+  nlohmann::json toJson(const std::vector<BenchmarkResult>& results, const std::vector<CounterResult>& counterResults,
+      int runCount) {
+    auto resultsJson = nlohmann::json::array();
+    for (const auto& result : results) {
+      resultsJson.push_back({
+          {"name", result.name},
+          {"itemCount", result.itemCount},
+          {"nanosPerItem", result.nanosPerItem},
+          {"itemsPerSecond", result.itemsPerSecond()}
+      });
+    }
+    auto counterResultsJson = nlohmann::json::array();
+    for (const auto& result : counterResults) {
+      counterResultsJson.push_back({
+          {"name", result.name},
+          {"unit", result.unit},
+          {"itemCount", result.itemCount},
+          {"countPerItem", result.countPerItem}
+      });
+    }
+    return {
+        {"version", JSON_FORMAT_VERSION},
+        {"runCount", runCount},
+        {"results", resultsJson},
+        {"counterResults", counterResultsJson}
+    };
+  }
+
+  // Nanoseconds per item by benchmark name, as written by an earlier run with --json
+  std::map<std::string, double> readBaseline(const std::string& path) {
+    std::ifstream file(path);
+    if (!file) {
+      throw std::runtime_error("couldn't open baseline file " + path);
+    }
+    const auto j = nlohmann::json::parse(file);
+    std::map<std::string, double> baseline;
+    for (const auto& result : j.at("results")) {
+      baseline[result.at("name").get<std::string>()] = result.at("nanosPerItem").get<double>();
+    }
+    return baseline;
+  }
+
+  void printTable(const std::vector<BenchmarkResult>& results, const std::map<std::string, double>& baseline) {
+    std::printf("%-60s %12s %14s %16s", "benchmark", "items", "ns/item", "items/s");
+    std::printf(baseline.empty() ? "\n" : " %14s\n", "vs baseline");
+    for (const auto& result : results) {
+      std::printf("%-60s %12lld %14.2f %16.0f",
+          result.name.c_str(), result.itemCount, result.nanosPerItem, result.itemsPerSecond());
+      if (baseline.empty()) {
+        std::printf("\n");
+        continue;
+      }
+      const auto it = baseline.find(result.name);
+      if (it == baseline.end() || it->second == 0) {
+        std::printf(" %14s\n", "-");
+      } else {
+        // Positive means slower than baseline
+        std::printf(" %+13.1f%%\n", (result.nanosPerItem / it->second - 1) * 100);
+      }
+    }
+  }
+
+  void printCounterTable(const std::vector<CounterResult>& results) {
+    if (results.empty()) {
+      return;
+    }
+    std::printf("\n%-60s %12s %14s %s\n", "counter", "items", "count/item", "unit");
+    for (const auto& result : results) {
+      std::printf("%-60s %12lld %14.2f %s\n",
+          result.name.c_str(), result.itemCount, result.countPerItem, result.unit.c_str());
+    }
+  }
+}
+
+// Usage: helgoboss-learn-bench [--json] [--baseline FILE] [FILTER] [RUN_COUNT]
+//
+// --json prints the results as JSON instead of a table. Such output can be passed as baseline to a later run (e.g.
+// after checking out another commit), which then prints the relative change of each benchmark.
+int main(int argc, char* argv[]) {
+  bool printJson = false;
+  std::string baselinePath;
+  std::vector<std::string> positionalArgs;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--json") {
+      printJson = true;
+    } else if (arg == "--baseline" && i + 1 < argc) {
+      baselinePath = argv[++i];
+    } else {
+      positionalArgs.push_back(arg);
+    }
+  }
+  const std::string filter = positionalArgs.size() > 0 ? positionalArgs[0] : "";
+  const int runCount = positionalArgs.size() > 1 ? std::max(1, std::atoi(positionalArgs[1].c_str())) : 5;
+  const auto baseline = baselinePath.empty() ? std::map<std::string, double>() : readBaseline(baselinePath);
+  Runner runner(filter, runCount);
+  for (const auto& benchmark : helgoboss::bench::getRegisteredBenchmarks()) {
+    benchmark(runner);
+  }
+  if (printJson) {
+    std::cout << toJson(runner.getResults(), runner.getCounterResults(), runCount).dump(2) << std::endl;
+  } else {
+    printTable(runner.getResults(), baseline);
+    printCounterTable(runner.getCounterResults());
+  }
+  return 0;
+}
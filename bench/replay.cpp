@@ -0,0 +1,102 @@
+#include <helgoboss-learn/MappedFile.h>
+#include <helgoboss-learn/SessionReplay.h>
+#include <cstdio>
+#include <exception>
+#include <stdexcept>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <nlohmann/json.hpp>
+
+using helgoboss::MappedFile;
+using helgoboss::SessionCaptureView;
+using helgoboss::SessionReplayResult;
+
+namespace {
+  void printResult(const SessionReplayResult& result) {
+    std::printf("%-24s %llu\n", "events", static_cast<unsigned long long>(result.eventCount));
+    std::printf("%-24s %llu\n", "mappings", static_cast<unsigned long long>(result.mappingCount));
+    std::printf("%-24s %.3f\n", "seconds", result.elapsedSeconds);
+    std::printf("%-24s %.0f\n", "events/s", result.getEventsPerSecond());
+    std::printf("%-24s %llu\n", "target hits", static_cast<unsigned long long>(result.targetHitCount));
+    std::printf("%-24s %llu\n", "feedback messages", static_cast<unsigned long long>(result.feedbackMessageCount));
+    std::printf("%-24s %016llx\n", "control checksum", static_cast<unsigned long long>(result.controlChecksum));
+    std::printf("%-24s %016llx\n", "feedback checksum", static_cast<unsigned long long>(result.feedbackChecksum));
+    std::printf("\n%-16s %12s %10s %10s %10s %10s %10s\n", "stage (ns)", "count", "mean", "p50", "p99", "p99.9", "max");
+    for (const auto& stage : result.latencies.items()) {
+      const auto& h = stage.value();
+      std::printf("%-16s %12llu %10.0f %10llu %10llu %10llu %10llu\n", stage.key().c_str(),
+          h.at("count").get<unsigned long long>(), h.at("mean").get<double>(),
+          h.at("p50").get<unsigned long long>(), h.at("p99").get<unsigned long long>(),
+          h.at("p999").get<unsigned long long>(), h.at("max").get<unsigned long long>());
+    }
+  }
+
+  // Returns false if the behavior differs from the baseline
+  bool compareWithBaseline(const SessionReplayResult& result, const std::string& baselinePath) {
+    std::ifstream file(baselinePath);
+    if (!file) {
+      throw std::runtime_error("couldn't open baseline file " + baselinePath);
+    }
+    const auto baseline = nlohmann::json::parse(file);
+    const auto current = result.toJson();
+    const auto baselineEventsPerSecond = baseline.at("eventsPerSecond").get<double>();
+    if (baselineEventsPerSecond > 0) {
+      // Positive means faster than baseline
+      std::fprintf(stderr, "throughput vs baseline: %+.1f%%\n",
+          (result.getEventsPerSecond() / baselineEventsPerSecond - 1) * 100);
+    }
+    bool behaviorIsEqual = true;
+    for (const auto* key : {"targetHitCount", "feedbackMessageCount", "controlChecksum", "feedbackChecksum"}) {
+      if (current.at(key) != baseline.at(key)) {
+        std::fprintf(stderr, "behavior differs from baseline: %s\n", key);
+        behaviorIsEqual = false;
+      }
+    }
+    return behaviorIsEqual;
+  }
+}
+
+// Usage: helgoboss-learn-replay [--json] [--no-feedback] [--baseline FILE] CAPTURE_FILE
+//
+// Replays a session capture written by SessionRecorder. --json prints the result as JSON, which can be passed as
+// baseline to a later run. The exit code is 1 if the behavior (hits, feedback, checksums) differs from the baseline.
+int main(int argc, char* argv[]) {
+  bool printJson = false;
+  bool withFeedback = true;
+  std::string baselinePath;
+  std::string capturePath;
+  for (int i = 1; i < argc; i++) {
+    const std::string arg = argv[i];
+    if (arg == "--json") {
+      printJson = true;
+    } else if (arg == "--no-feedback") {
+      withFeedback = false;
+    } else if (arg == "--baseline" && i + 1 < argc) {
+      baselinePath = argv[++i];
+    } else {
+      capturePath = arg;
+    }
+  }
+  if (capturePath.empty()) {
+    std::fprintf(stderr, "Usage: helgoboss-learn-replay [--json] [--no-feedback] [--baseline FILE] CAPTURE_FILE\n");
+    return 2;
+  }
+  try {
+    const MappedFile file(capturePath);
+    const SessionCaptureView capture(file.getData(), file.getSize());
+    const auto result = helgoboss::util::replaySession(capture, withFeedback);
+    if (printJson) {
+      std::cout << result.toJson().dump(2) << std::endl;
+    } else {
+      printResult(result);
+    }
+    if (!baselinePath.empty() && !compareWithBaseline(result, baselinePath)) {
+      return 1;
+    }
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 2;
+  }
+  return 0;
+}
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "preset-util.h"
+
+namespace helgoboss {
+  namespace internal {
+    // Layout of version 1. Numbers are stored in the byte order of the machine which wrote the preset.
+    struct BinaryPresetHeader {
+      char magic[8];
+      std::uint32_t version;
+      std::uint32_t byteOrderMark;
+      std::uint32_t mappingCount;
+      std::uint32_t mappingRecordSize;
+      // Relative to the beginning of the preset
+      std::uint64_t stringTableOffset;
+      std::uint64_t stringTableSize;
+    };
+
+    struct BinaryMappingRecord {
+      // Source
+      std::int32_t sourceType;
+      std::int32_t channel;
+      std::int32_t midiMessageNumber;
+      std::int32_t parameterNumberMessageNumber;
+      std::int32_t customCharacter;
+      std::int32_t midiClockTransportMessageType;
+      std::uint8_t is14Bit;
+      std::uint8_t isRegistered;
+      std::uint8_t sourcePadding[2];
+      // Mode
+      std::int32_t modeType;
+      double minTargetValue;
+      double maxTargetValue;
+      double minSourceValue;
+      double maxSourceValue;
+      double minTargetJump;
+      double maxTargetJump;
+      double minStepSize;
+      double maxStepSize;
+      std::uint8_t reverseIsEnabled;
+      std::uint8_t ignoreOutOfRangeSourceValuesIsEnabled;
+      std::uint8_t roundTargetValue;
+      std::uint8_t scaleModeEnabled;
+      std::uint8_t rotateIsEnabled;
+      std::uint8_t modePadding[3];
+      // Indexes into the string table
+      std::uint32_t eelControlTransformation;
+      std::uint32_t eelFeedbackTransformation;
+      // Room for settings added in later versions
+      std::uint8_t reserved[16];
+    };
+
+    // The string table starts with an entry count, followed by the entries and the concatenated (not
+    // null-terminated) string contents. Entry 0 is always the empty string.
+    struct BinaryStringTableEntry {
+      // Relative to the beginning of the string table
+      std::uint32_t offset;
+      std::uint32_t length;
+    };
+
+    static_assert(sizeof(BinaryPresetHeader) == 40, "Binary preset header layout must not change");
+    static_assert(sizeof(BinaryMappingRecord) == 128, "Binary mapping record layout must not change");
+    static_assert(std::is_trivially_copyable<BinaryMappingRecord>::value, "Binary mapping record must be plain data");
+  }
+
+  /**
+   * Read-only access to a preset in binary format, e.g. in a memory-mapped file.
+   *
+   * Doesn't copy anything. Numeric settings are read directly from their fixed positions, so there's no parsing
+   * involved. The data must outlive this view.
+   */
+  class BinaryPresetView {
+  public:
+    static constexpr std::uint32_t VERSION = 1;
+  private:
+    const char* data_;
+    std::size_t size_;
+    internal::BinaryPresetHeader header_;
+  public:
+    /**
+     * Throws std::runtime_error if the data doesn't look like a binary preset which can be read on this machine.
+     */
+    BinaryPresetView(const void* data, std::size_t size);
+
+    std::size_t getMappingCount() const;
+
+    /**
+     * Updates the given source and mode with the settings of the mapping at the given index. Each of them gets its
+     * processor updated just once.
+     */
+    void loadMapping(std::size_t index, MappingRef mapping) const;
+
+    void loadMappings(const std::vector<MappingRef>& mappings) const;
+  private:
+    internal::BinaryMappingRecord getMappingRecord(std::size_t index) const;
+    std::string getString(std::uint32_t index) const;
+  };
+
+  namespace util {
+    /**
+     * Serializes all settings of the given mappings in the binary preset format. EEL scripts are deduplicated.
+     */
+    std::string serializeMappingsToBinary(const std::vector<ConstMappingRef>& mappings);
+  }
+}
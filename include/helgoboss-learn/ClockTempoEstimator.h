@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <boost/optional.hpp>
+#include <helgoboss-midi/MidiMessage.h>
+#include "SourceValue.h"
+
+namespace helgoboss {
+  /**
+   * Estimates the tempo from MIDI clock ticks (24 per quarter note), so that ClockTempo sources can be fed without the
+   * host having to do that itself.
+   *
+   * The estimate is the slope of a least-squares regression line through the timestamps of the most recent ticks,
+   * which averages out timing jitter much better than looking at the intervals between single ticks. All state has a
+   * fixed size, so feeding never allocates.
+   *
+   * A gap which is longer than the tick interval at Tempo::MIN_BPM (e.g. because the clock has been stopped) or a
+   * timestamp going backwards starts a new estimation from scratch. Repeated timestamps don't, they are taken into
+   * account like all others.
+   */
+  class ClockTempoEstimator {
+  public:
+    static constexpr int TICKS_PER_QUARTER_NOTE = 24;
+    // Ticks taken into account for the regression (4 beats)
+    static constexpr std::size_t WINDOW_SIZE = 4 * TICKS_PER_QUARTER_NOTE;
+    // Ticks needed for the first estimate (1 beat)
+    static constexpr std::size_t MIN_TICK_COUNT = TICKS_PER_QUARTER_NOTE;
+    static constexpr double DEFAULT_BPM_THRESHOLD = 0.1;
+  private:
+    double bpmThreshold_;
+    // Ring buffer of tick timestamps in seconds
+    std::array<double, WINDOW_SIZE> timestamps_{};
+    std::size_t nextIndex_ = 0;
+    std::size_t tickCount_ = 0;
+    boost::optional<double> estimatedBpm_;
+    boost::optional<double> emittedBpm_;
+  public:
+    /**
+     * Tempo messages are only emitted if the estimated tempo differs from the last emitted one by more than the given
+     * number of bpm.
+     */
+    explicit ClockTempoEstimator(double bpmThreshold = DEFAULT_BPM_THRESHOLD);
+
+    /**
+     * Feeds the given timestamp (in seconds, from any monotonic clock) of a MIDI clock tick. Returns a source value
+     * containing a tempo message if the estimated tempo has changed noticeably.
+     */
+    boost::optional<SourceValue> feedTick(double timestamp);
+
+    /**
+     * Like feedTick() but accepts any MIDI message. Messages other than timing clock are ignored.
+     */
+    boost::optional<SourceValue> feed(const MidiMessage& msg, double timestamp);
+
+    /**
+     * Returns the current estimate, even if it hasn't been emitted because of the threshold.
+     */
+    boost::optional<double> getEstimatedBpm() const;
+
+    void reset();
+  private:
+    double computeSecondsPerTick() const;
+  };
+}
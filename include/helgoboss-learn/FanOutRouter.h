@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "ModeProcessor.h"
+#include "SourceProcessor.h"
+#include "SourceValue.h"
+#include "Target.h"
+
+namespace helgoboss {
+  namespace internal {
+    struct FanOutMapping {
+      ModeProcessor mode;
+      Target* target;
+      // Taken over from the source processor given to addMapping(), not owned
+      ProcessorStatistics* sourceStatistics;
+    };
+
+    // Mappings whose source processors are equal, so they react to the same events with the same values
+    struct FanOutGroup {
+      // Without statistics, matched events are counted per mapping
+      SourceProcessor source;
+      // Indexes into mappings, ascending
+      std::vector<std::size_t> mappingIndexes;
+    };
+  }
+
+  /**
+   * Routes source values to mappings which share their source. Mappings with equal source processors (see
+   * SourceProcessor::equals()) end up in the same group, so for each event the source is matched and normalized only
+   * once per group instead of once per mapping. The normalized value is then passed to the mode processors of all
+   * mappings in the group.
+   *
+   * Targets are hit group by group (in order of their first mapping) and within a group in mapping order. Statistics
+   * attached to the source processors given to addMapping() are kept per mapping, so each of them counts the events
+   * matched by the group, just as if the mapping processed the events on its own.
+   *
+   * Targets must stay alive as long as the router.
+   */
+  class FanOutRouter {
+  private:
+    std::vector<internal::FanOutMapping> mappings_;
+    std::vector<internal::FanOutGroup> groups_;
+    std::unordered_map<SourceProcessor, std::size_t> groupIndexBySource_;
+  public:
+    /**
+     * Returns the index of the mapping.
+     */
+    std::size_t addMapping(SourceProcessor source, ModeProcessor mode, Target& target);
+
+    std::size_t getMappingCount() const;
+
+    /**
+     * Returns the number of distinct sources.
+     */
+    std::size_t getGroupCount() const;
+
+    /**
+     * Hits the targets of all mappings whose source reacts to the given value. Returns the number of matched groups.
+     */
+    std::size_t process(const SourceValue& value);
+
+  private:
+    void processGroup(internal::FanOutGroup& group, const SourceValue& value);
+  };
+}
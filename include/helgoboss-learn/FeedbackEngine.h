@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include <helgoboss-midi/MidiMessage.h>
+#include "Mode.h"
+#include "Source.h"
+#include "SourceContext.h"
+#include "Target.h"
+#include "WorkerPool.h"
+
+namespace helgoboss {
+  namespace internal {
+    struct FeedbackMapping {
+      Source* source;
+      Mode* mode;
+      const Target* target;
+    };
+
+    struct BufferedFeedback {
+      const void* source;
+      // If messageCount is 1, only the first message counts
+      std::array<MidiMessage, 2> messages;
+      int messageCount;
+    };
+
+    // Messages of one chunk of mappings, located in the buffer of the worker which processed the chunk
+    struct FeedbackChunk {
+      std::size_t workerIndex;
+      std::size_t begin;
+      std::size_t end;
+    };
+
+    // Aligned in order to not share cache lines between the chunk counters of different workers
+    struct alignas(64) FeedbackWorker {
+      std::vector<BufferedFeedback> messages;
+      // The worker's own range of chunks. Other workers steal from it as soon as they run out of work.
+      std::atomic<std::size_t> nextChunkIndex{0};
+      std::size_t endChunkIndex = 0;
+    };
+  }
+
+  /**
+   * Computes the feedback of many mappings in parallel. The mappings are split into chunks, and each worker starts with
+   * its own contiguous range of chunks. Workers which are done steal the remaining chunks of others, so one range with
+   * expensive targets doesn't hold up the whole run.
+   *
+   * Workers write the feedback messages to their own buffers. Afterwards, the messages are passed to the given source
+   * context on the calling thread in mapping order, so the output is exactly the same as when calling Mode::feedback()
+   * for each mapping one after the other.
+   *
+   * Requirements during feedback():
+   * - Sources, modes and targets must not be changed by anyone else.
+   * - Each source and mode must belong to only one mapping (they are not thread-safe). Targets may be shared, but then
+   *   getCurrentValue() must be safe to call concurrently.
+   * - Statistics attached to sources or modes must not be shared between mappings.
+   */
+  class FeedbackEngine {
+  private:
+    std::vector<internal::FeedbackMapping> mappings_;
+    std::vector<internal::FeedbackWorker> workers_;
+    std::vector<internal::FeedbackChunk> chunks_;
+    WorkerPool workerPool_;
+  public:
+    // Number of mappings which are processed by one worker at a time
+    static constexpr std::size_t CHUNK_SIZE = 32;
+
+    /**
+     * Starts workerCount - 1 threads.
+     */
+    explicit FeedbackEngine(std::size_t workerCount);
+
+    /**
+     * Source, mode and target must stay alive as long as the engine. Warms up source and mode. Returns the index of the
+     * mapping.
+     */
+    std::size_t addMapping(Source& source, Mode& mode, const Target& target);
+
+    std::size_t getMappingCount() const;
+
+    /**
+     * Computes the feedback of all mappings and passes it to the given context in mapping order. Blocks until done.
+     * Rethrows the first exception thrown by a worker, in which case no feedback is passed at all.
+     */
+    void feedback(SourceContext& context);
+
+  private:
+    void runWorker(std::size_t workerIndex);
+    void processChunks(internal::FeedbackWorker& owner, std::size_t workerIndex);
+    void processChunk(std::size_t chunkIndex, std::size_t workerIndex);
+  };
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+#include <rxcpp/rx.hpp>
+#include "Mode.h"
+#include "ObservableTarget.h"
+#include "Source.h"
+#include "Target.h"
+
+namespace helgoboss {
+  namespace internal {
+    struct ScheduledFeedbackMapping {
+      Source* source;
+      Mode* mode;
+      const Target* target;
+      bool isDirty;
+    };
+  }
+
+  /**
+   * Computes feedback only for mappings which might send something different than last time: The ones whose observable
+   * target, source or mode has changed since the last cycle. Feedback for mappings with targets which are not
+   * observable (see ObservableTarget) is computed in each cycle. So the cost of one cycle depends on the number of
+   * changes rather than on the number of mappings.
+   *
+   * Change notifications must arrive on the thread which calls feedback() (the same is true for the change
+   * notifications of sources and modes anyway).
+   */
+  class FeedbackScheduler {
+  private:
+    std::vector<internal::ScheduledFeedbackMapping> mappings_;
+    std::vector<std::size_t> dirtyMappingIndexes_;
+    // Mappings with targets which are not observable, so we need to compute their feedback in each cycle
+    std::vector<std::size_t> polledMappingIndexes_;
+    // Reused in each cycle in order to not allocate
+    std::vector<std::size_t> scheduledMappingIndexes_;
+    std::vector<rxcpp::composite_subscription> subscriptions_;
+  public:
+    FeedbackScheduler() = default;
+    FeedbackScheduler(const FeedbackScheduler& other) = delete;
+    FeedbackScheduler& operator=(const FeedbackScheduler& other) = delete;
+    ~FeedbackScheduler();
+
+    /**
+     * Source, mode and target must stay alive as long as the scheduler. Warms up source and mode. The mapping is dirty
+     * initially. Returns the index of the mapping.
+     */
+    std::size_t addMapping(Source& source, Mode& mode, const Target& target);
+
+    /**
+     * Makes sure the feedback of the given mapping is computed in the next cycle. Useful for changes the scheduler
+     * can't know about, e.g. if the feedback has been sent somewhere else in the meantime.
+     */
+    void markDirty(std::size_t mappingIndex);
+
+    void markAllDirty();
+
+    // Doesn't include mappings with targets which are not observable
+    std::size_t getDirtyMappingCount() const;
+
+    /**
+     * Computes the feedback of all dirty and polled mappings, in mapping order. Returns the number of mappings for which
+     * feedback has been computed.
+     */
+    template<typename SourceContext>
+    std::size_t feedback(SourceContext& context) {
+      // Changes during this cycle end up in the next one
+      scheduledMappingIndexes_.clear();
+      scheduledMappingIndexes_.swap(dirtyMappingIndexes_);
+      for (const auto i : scheduledMappingIndexes_) {
+        mappings_[i].isDirty = false;
+      }
+      scheduledMappingIndexes_.insert(
+          scheduledMappingIndexes_.end(), polledMappingIndexes_.begin(), polledMappingIndexes_.end());
+      std::sort(scheduledMappingIndexes_.begin(), scheduledMappingIndexes_.end());
+      // Polled mappings might be dirty as well because of a source or mode change
+      scheduledMappingIndexes_.erase(
+          std::unique(scheduledMappingIndexes_.begin(), scheduledMappingIndexes_.end()),
+          scheduledMappingIndexes_.end());
+      for (const auto i : scheduledMappingIndexes_) {
+        const auto& mapping = mappings_[i];
+        mapping.mode->feedback(*mapping.source, *mapping.target, context);
+      }
+      return scheduledMappingIndexes_.size();
+    }
+  };
+}
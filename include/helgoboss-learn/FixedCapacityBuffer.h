@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace helgoboss {
+  /**
+   * A sequence container with a fixed maximum size whose items are stored inline, so it never allocates.
+   *
+   * In contrast to std::array, it has a variable size and doesn't require the item type to be default-constructible.
+   */
+  template<typename Item, std::size_t Capacity>
+  class FixedCapacityBuffer {
+  private:
+    typename std::aligned_storage<sizeof(Item), alignof(Item)>::type storage_[Capacity];
+    std::size_t size_ = 0;
+  public:
+    FixedCapacityBuffer() = default;
+
+    FixedCapacityBuffer(std::initializer_list<Item> items) {
+      for (const auto& item : items) {
+        push_back(item);
+      }
+    }
+
+    FixedCapacityBuffer(const FixedCapacityBuffer& other) {
+      for (const auto& item : other) {
+        push_back(item);
+      }
+    }
+
+    FixedCapacityBuffer& operator=(const FixedCapacityBuffer& other) {
+      if (this != &other) {
+        clear();
+        for (const auto& item : other) {
+          push_back(item);
+        }
+      }
+      return *this;
+    }
+
+    ~FixedCapacityBuffer() {
+      clear();
+    }
+
+    static constexpr std::size_t capacity() {
+      return Capacity;
+    }
+
+    std::size_t size() const {
+      return size_;
+    }
+
+    bool empty() const {
+      return size_ == 0;
+    }
+
+    bool full() const {
+      return size_ == Capacity;
+    }
+
+    /**
+     * Throws if the buffer is full already.
+     */
+    void push_back(const Item& item) {
+      if (full()) {
+        throw std::length_error("FixedCapacityBuffer is full");
+      }
+      new(&storage_[size_]) Item(item);
+      size_ += 1;
+    }
+
+    void clear() {
+      for (std::size_t i = 0; i < size_; i++) {
+        (*this)[i].~Item();
+      }
+      size_ = 0;
+    }
+
+    Item& operator[](std::size_t index) {
+      return *std::launder(reinterpret_cast<Item*>(&storage_[index]));
+    }
+
+    const Item& operator[](std::size_t index) const {
+      return *std::launder(reinterpret_cast<const Item*>(&storage_[index]));
+    }
+
+    const Item& at(std::size_t index) const {
+      if (index >= size_) {
+        throw std::out_of_range("FixedCapacityBuffer index out of range");
+      }
+      return (*this)[index];
+    }
+
+    const Item& front() const {
+      return at(0);
+    }
+
+    const Item& back() const {
+      return at(size_ - 1);
+    }
+
+    Item* begin() {
+      return reinterpret_cast<Item*>(&storage_[0]);
+    }
+
+    Item* end() {
+      return begin() + size_;
+    }
+
+    const Item* begin() const {
+      return reinterpret_cast<const Item*>(&storage_[0]);
+    }
+
+    const Item* end() const {
+      return begin() + size_;
+    }
+
+    friend bool operator==(const FixedCapacityBuffer& lhs, const FixedCapacityBuffer& rhs) {
+      if (lhs.size() != rhs.size()) {
+        return false;
+      }
+      for (std::size_t i = 0; i < lhs.size(); i++) {
+        if (!(lhs[i] == rhs[i])) {
+          return false;
+        }
+      }
+      return true;
+    }
+
+    friend bool operator!=(const FixedCapacityBuffer& lhs, const FixedCapacityBuffer& rhs) {
+      return !(rhs == lhs);
+    }
+  };
+}
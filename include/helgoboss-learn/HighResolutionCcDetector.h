@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <boost/optional.hpp>
+#include <helgoboss-midi/MidiMessage.h>
+#include "SourceDescriptor.h"
+
+namespace helgoboss {
+  /**
+   * Recognizes 14-bit CC messages (MSB/LSB pairs) and (N)RPN messages in a raw stream of CC messages, on all
+   * channels at once.
+   *
+   * An MSB counts as part of a 14-bit CC message only if the very next CC message on the same channel is the
+   * corresponding LSB and arrives within MAX_PART_INTERVAL. Data entry (CC 6 and 38) is only considered after a
+   * parameter number has been selected and is never a 14-bit CC message on its own. A data entry MSB which isn't
+   * followed by its LSB within MAX_PART_INTERVAL makes a 7-bit parameter number message. That's reported with the next
+   * data entry MSB, the next selection of a different parameter number or the next CC message on the channel after
+   * MAX_PART_INTERVAL, whatever comes first. Selecting the current parameter number again, as many controllers do
+   * before each data entry, doesn't interrupt this.
+   *
+   * feed() must always be called from the same thread. isPartOfHighResolutionMessage() may be called from any thread.
+   */
+  class HighResolutionCcDetector {
+  public:
+    // Maximum seconds between the parts of one high-resolution message
+    static constexpr double MAX_PART_INTERVAL = 0.1;
+  private:
+    struct ChannelState {
+      int pendingMsbControllerNumber = -1;
+      double pendingMsbTimestamp = 0.0;
+      int parameterNumberMsb = -1;
+      int parameterNumberLsb = -1;
+      bool isRegistered = false;
+      bool dataEntryMsbIsPending = false;
+      double dataEntryMsbTimestamp = 0.0;
+    };
+    std::array<ChannelState, 16> channelStates_;
+    // One bit per controller number, two words per channel
+    std::array<std::atomic<std::uint64_t>, 32> highResolutionControllerNumbers_{};
+  public:
+    /**
+     * Feeds the next CC message with its timestamp (in seconds, from any monotonic clock). Returns a descriptor of the
+     * high-resolution source if this message completes a 14-bit CC message or (N)RPN message or if it reveals that a
+     * previous parameter number message came without LSB data entry.
+     */
+    boost::optional<SourceDescriptor> feed(const MidiMessage& ccMessage, double timestamp);
+
+    /**
+     * Returns whether CC messages with the given controller number on the given channel have turned out to be part of
+     * 14-bit CC messages or (N)RPN messages. Such messages shouldn't be treated as 7-bit CC messages.
+     */
+    bool isPartOfHighResolutionMessage(int channel, int controllerNumber) const;
+
+    void reset();
+  private:
+    boost::optional<SourceDescriptor> processMessage(int channel, int controllerNumber, int value, double timestamp,
+        ChannelState& state);
+    void markAsPartOfHighResolutionMessage(int channel, int controllerNumber);
+    static bool parameterNumberIsSelected(const ChannelState& state);
+    // Returns the 7-bit parameter number source if a data entry MSB is pending and forgets about it
+    static boost::optional<SourceDescriptor> takePendingDataEntryMsb(int channel, ChannelState& state);
+    static boost::optional<SourceDescriptor> describeParameterNumberSource(int channel, const ChannelState& state,
+        bool is14Bit);
+  };
+}
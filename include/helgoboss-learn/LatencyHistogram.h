@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <nlohmann/json.hpp>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace helgoboss {
+  namespace internal {
+    inline int findHighestSetBit(std::uint64_t value) {
+#if defined(_MSC_VER)
+      unsigned long index;
+      _BitScanReverse64(&index, value);
+      return static_cast<int>(index);
+#else
+      return 63 - __builtin_clzll(value);
+#endif
+    }
+  }
+
+  /**
+   * Histogram of latencies in nanoseconds with a fixed number of buckets, in the style of HdrHistogram: Each power of
+   * two is divided into SUB_BUCKET_COUNT linear buckets, so recorded values are kept with a relative error of at most
+   * 1 / SUB_BUCKET_COUNT over the whole 64-bit range. Recording is a handful of integer instructions and never
+   * allocates.
+   *
+   * Like ProcessorStatistics, it must only be written by one thread, but can be read from any thread.
+   */
+  class LatencyHistogram {
+  public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr std::uint64_t SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+    static constexpr std::size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+  private:
+    std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> buckets_{};
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> sum_{0};
+    std::atomic<std::uint64_t> min_{UINT64_MAX};
+    std::atomic<std::uint64_t> max_{0};
+  public:
+    void record(std::uint64_t nanos) {
+      increment(buckets_[getBucketIndex(nanos)], 1);
+      increment(count_, 1);
+      increment(sum_, nanos);
+      if (nanos < min_.load(std::memory_order_relaxed)) {
+        min_.store(nanos, std::memory_order_relaxed);
+      }
+      if (nanos > max_.load(std::memory_order_relaxed)) {
+        max_.store(nanos, std::memory_order_relaxed);
+      }
+    }
+
+    std::uint64_t getCount() const;
+
+    // Returns 0 if nothing has been recorded
+    std::uint64_t getMin() const;
+
+    std::uint64_t getMax() const;
+
+    double getMean() const;
+
+    /**
+     * Returns the value below or at which the given percentage (0 to 100) of recorded values lie, rounded up to the
+     * highest value of its bucket. Returns 0 if nothing has been recorded.
+     */
+    std::uint64_t getValueAtPercentile(double percentile) const;
+
+    /**
+     * Returns count, min, max, mean and the usual percentiles.
+     */
+    nlohmann::json exportToJson() const;
+
+    /**
+     * Must not be called concurrently with record().
+     */
+    void reset();
+
+    static std::size_t getBucketIndex(std::uint64_t value) {
+      if (value < SUB_BUCKET_COUNT) {
+        return static_cast<std::size_t>(value);
+      }
+      const int shift = internal::findHighestSetBit(value) - SUB_BUCKET_BITS;
+      return static_cast<std::size_t>((shift + 1) * SUB_BUCKET_COUNT + ((value >> shift) & (SUB_BUCKET_COUNT - 1)));
+    }
+
+    static std::uint64_t getHighestValueInBucket(std::size_t index);
+
+  private:
+    static void increment(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+      counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+  };
+}
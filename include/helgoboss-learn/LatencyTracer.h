@@ -0,0 +1,118 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <nlohmann/json.hpp>
+#include <helgoboss-midi/MidiMessage.h>
+#include "LatencyHistogram.h"
+
+namespace helgoboss {
+  enum class LatencyStage {
+    // SourceProcessor::processes()
+    Match,
+    // SourceProcessor::getNormalizedValue() respectively getFixedPointValue()
+    Normalize,
+    // ModeProcessor::processSourceValue() as a whole, including Eel and Hit
+    ModeTransform,
+    // Execution of the EEL control transformation
+    Eel,
+    // Target::hit()
+    Hit,
+    // From arrival of the source value until the target has been hit
+    EndToEnd,
+    // From the target value change until the feedback MIDI messages have been handed to the source context
+    Feedback
+  };
+
+  constexpr std::size_t NUM_LATENCY_STAGES = 7;
+
+  namespace util {
+    const char* getLatencyStageName(LatencyStage stage);
+  }
+
+  /**
+   * Nanosecond timestamps from a monotonic clock. Tests can inject a fake clock.
+   */
+  using LatencyClock = std::function<std::uint64_t()>;
+
+  /**
+   * Records how long the stages of control and feedback processing take, one histogram per stage. Attach it to a
+   * mode with Mode::setLatencyTracer() and run the control chain with ModeProcessor::processTraced(). Feedback is traced
+   * by passing a TracingSourceContext to Mode::feedback().
+   *
+   * One tracer can be shared by many mappings as long as all of them are controlled from one thread and receive
+   * feedback on one thread.
+   */
+  class LatencyTracer {
+  private:
+    LatencyClock clock_;
+    std::array<LatencyHistogram, NUM_LATENCY_STAGES> histograms_;
+  public:
+    // Uses std::chrono::steady_clock
+    LatencyTracer();
+
+    explicit LatencyTracer(LatencyClock clock);
+
+    std::uint64_t now() const {
+      return clock_();
+    }
+
+    /**
+     * Records the time passed since the given timestamp for the given stage and returns the current timestamp, so
+     * consecutive stages can be measured with one clock reading each.
+     */
+    std::uint64_t recordSince(LatencyStage stage, std::uint64_t startTimestamp) {
+      const auto endTimestamp = now();
+      record(stage, endTimestamp >= startTimestamp ? endTimestamp - startTimestamp : 0);
+      return endTimestamp;
+    }
+
+    void record(LatencyStage stage, std::uint64_t nanos) {
+      histograms_[static_cast<std::size_t>(stage)].record(nanos);
+    }
+
+    const LatencyHistogram& getHistogram(LatencyStage stage) const {
+      return histograms_[static_cast<std::size_t>(stage)];
+    }
+
+    /**
+     * Returns an object with one entry per stage, see LatencyHistogram::exportToJson().
+     */
+    nlohmann::json exportToJson() const;
+
+    /**
+     * Must not be called concurrently with recording.
+     */
+    void reset();
+  };
+
+  /**
+   * Source context decorator which records the Feedback stage whenever feedback messages are sent through it.
+   */
+  template<typename SourceContext>
+  class TracingSourceContext {
+  private:
+    SourceContext& context_;
+    LatencyTracer& tracer_;
+    std::uint64_t changeTimestamp_;
+  public:
+    /**
+     * The change timestamp should be taken with LatencyTracer::now() when the target value changed.
+     */
+    TracingSourceContext(SourceContext& context, LatencyTracer& tracer, std::uint64_t changeTimestamp) :
+        context_(context), tracer_(tracer), changeTimestamp_(changeTimestamp) {
+    }
+
+    void processMidiFeedback(const void* source, const MidiMessage& message) {
+      context_.processMidiFeedback(source, message);
+      tracer_.recordSince(LatencyStage::Feedback, changeTimestamp_);
+    }
+
+    void processMidiFeedbackTwo(const void* source, const std::array<MidiMessage, 2>& messages) {
+      context_.processMidiFeedbackTwo(source, messages);
+      tracer_.recordSince(LatencyStage::Feedback, changeTimestamp_);
+    }
+  };
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+namespace helgoboss {
+  /**
+   * Maps a file into memory for reading. The mapping is released on destruction.
+   */
+  class MappedFile {
+  private:
+    const void* data_ = nullptr;
+    std::size_t size_ = 0;
+  public:
+    /**
+     * Throws std::system_error if the file can't be mapped.
+     */
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile& operator=(const MappedFile& other) = delete;
+    ~MappedFile();
+
+    const void* getData() const;
+    std::size_t getSize() const;
+  };
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include <rxcpp/rx.hpp>
+#include "Mode.h"
+#include "Source.h"
+#include "SourceProcessor.h"
+#include "SourceValue.h"
+#include "Target.h"
+
+namespace helgoboss {
+  namespace internal {
+    constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+    // Lets arrays start at a cache line boundary
+    template<typename T>
+    struct CacheLineAllocator {
+      using value_type = T;
+
+      CacheLineAllocator() = default;
+      template<typename U>
+      CacheLineAllocator(const CacheLineAllocator<U>&) noexcept {
+      }
+
+      T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(CACHE_LINE_SIZE)));
+      }
+      void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(CACHE_LINE_SIZE));
+      }
+
+      template<typename U>
+      friend bool operator==(const CacheLineAllocator&, const CacheLineAllocator<U>&) {
+        return true;
+      }
+      template<typename U>
+      friend bool operator!=(const CacheLineAllocator&, const CacheLineAllocator<U>&) {
+        return false;
+      }
+    };
+
+    template<typename T>
+    using CacheLineVector = std::vector<T, CacheLineAllocator<T>>;
+  }
+
+  /**
+   * Keeps the processing parameters of many mappings in contiguous arrays, so processing an event walks through a few
+   * compact arrays instead of visiting each mapping's source and mode objects on the heap.
+   *
+   * Routing of short MIDI messages (note, CC, pitch bend, pressure, program change) is one loop over the source
+   * channel, number and accepted message kinds of all mappings. These are separate arrays (struct of arrays) because
+   * the loop reads them for every mapping. Absolute mode without EEL control transformation, which is what most
+   * mappings use, is done by the bank using the same code as ModeProcessor. Its settings are kept as one array of
+   * structs instead, because they are only read for the few matched mappings but then all of them, so one mapping's
+   * settings take one or two cache lines rather than ten. Other sources (14-bit CC, (N)RPN, MIDI clock) are matched by
+   * their source processors and other modes are left to the mode's processor.
+   *
+   * The bank follows all changes of the sources and modes. Change notifications must arrive on the thread which calls
+   * process(). Matched events, target hits and everything else are counted in the statistics attached to the sources
+   * and modes, just as if the mappings were processed by their own processors.
+   */
+  class MappingBank {
+  private:
+    // Objects, used for keeping in sync and for everything the bank doesn't process itself
+    std::vector<const Source*> sources_;
+    std::vector<Mode*> modes_;
+    std::vector<Target*> targets_;
+    // Routing, acceptedEventKinds is 0 for mappings whose source is matched by the source processor
+    internal::CacheLineVector<std::uint8_t> acceptedEventKinds_;
+    internal::CacheLineVector<std::int8_t> channels_;
+    internal::CacheLineVector<std::int8_t> numbers_;
+    // Normalization
+    std::vector<SourceProcessor> sourceProcessors_;
+    // Absolute mode, processedByBank is 1 for mappings in absolute mode without EEL control transformation
+    internal::CacheLineVector<internal::AbsoluteModeSettings> absoluteModeSettings_;
+    internal::CacheLineVector<std::uint8_t> processedByBank_;
+    // Mappings whose source is matched by the source processor
+    std::vector<std::size_t> unroutedMappingIndexes_;
+    // Reused in each call in order to not allocate
+    std::vector<std::size_t> matchedMappingIndexes_;
+    std::vector<rxcpp::composite_subscription> subscriptions_;
+  public:
+    MappingBank() = default;
+    MappingBank(const MappingBank& other) = delete;
+    MappingBank& operator=(const MappingBank& other) = delete;
+    ~MappingBank();
+
+    /**
+     * Source, mode and target must stay alive as long as the bank. Warms up the mode. Returns the index of the mapping.
+     */
+    std::size_t addMapping(const Source& source, Mode& mode, Target& target);
+
+    std::size_t getMappingCount() const;
+
+    /**
+     * Hits the targets of all mappings whose source reacts to the given value, in mapping order. Returns the number of
+     * matched mappings.
+     */
+    std::size_t process(const SourceValue& value);
+
+  private:
+    void updateMapping(std::size_t mappingIndex);
+    void routeMidiMessage(const MidiMessage& msg);
+    void processMatchedMapping(std::size_t mappingIndex, const SourceValue& value);
+  };
+}
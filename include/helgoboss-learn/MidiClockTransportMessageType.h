@@ -15,6 +15,11 @@ namespace helgoboss {
   void to_json(nlohmann::json& j, const MidiClockTransportMessageType& o);
   void from_json(const nlohmann::json& j, MidiClockTransportMessageType& o);
 
+  namespace internal {
+    // Like util::getMidiClockTransportMessageTypeLabel() but without allocating
+    const char* getMidiClockTransportMessageTypeLabel(MidiClockTransportMessageType type);
+  }
+
   namespace util {
     std::string getMidiClockTransportMessageTypeLabel(MidiClockTransportMessageType type);
     boost::optional<MidiMessageType> mapMidiClockTransportMessageTypeToMidiMessageType(MidiClockTransportMessageType type);
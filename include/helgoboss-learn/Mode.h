@@ -3,16 +3,23 @@
 #include <rxcpp/rx.hpp>
 #include <nlohmann/json.hpp>
 #include <memory>
+#include <mutex>
 #include <eel2/ns-eel.h>
 #include "ReactiveProperty.h"
 #include "ModeType.h"
 #include "Source.h"
 #include "ModeProcessor.h"
+#include "ModeConfigPool.h"
 #include "TargetCharacter.h"
+#include "ProcessorActivation.h"
+#include "ProcessorSync.h"
+#include "ProcessorStatistics.h"
 #include <string>
+#include <chrono>
 #include <cmath>
 #include "math-util.h"
 #include <boost/algorithm/string.hpp>
+#include <boost/optional.hpp>
 
 #undef min
 #undef max
@@ -45,16 +52,30 @@ namespace helgoboss {
     ReactiveProperty<double> maxStepSize{internal::DEFAULT_MAX_STEP_SIZE, internal::keepInRange(0.0, 1.0)};
     ReactiveProperty<bool> rotateIsEnabled{internal::DEFAULT_ROTATE_IS_ENABLED};
   private:
-    ModeProcessor processor_ = createProcessor();
-    std::unique_ptr<void, decltype(&NSEEL_VM_free)> feedbackVm_{NSEEL_VM_alloc(), NSEEL_VM_free};
-    std::unique_ptr<void, decltype(&NSEEL_code_free)> feedbackCodeHandle_{nullptr, NSEEL_code_free};
+    // Processor and feedback VM are built on warm-up or first use if lazy
+    mutable boost::optional<ModeProcessor> processor_;
+    internal::ProcessorSync processorSync_;
+    mutable std::unique_ptr<void, decltype(&NSEEL_VM_free)> feedbackVm_{nullptr, NSEEL_VM_free};
+    mutable std::unique_ptr<void, decltype(&NSEEL_code_free)> feedbackCodeHandle_{nullptr, NSEEL_code_free};
     // Will be deleted together with VM
-    double* feedbackVariableX_{NSEEL_VM_regvar(feedbackVm_.get(), "x")};
-    double* feedbackVariableY_{NSEEL_VM_regvar(feedbackVm_.get(), "y")};
+    mutable double* feedbackVariableX_ = nullptr;
+    mutable double* feedbackVariableY_ = nullptr;
+    // Not owned, not taken over by copies
+    ProcessorStatistics* statistics_ = nullptr;
+    // Not owned, not taken over by copies
+    LatencyTracer* latencyTracer_ = nullptr;
+    // Not owned, not taken over by copies
+    ModeConfigPool* configPool_ = nullptr;
 
   public:
-    Mode() {
+    Mode() : Mode(ProcessorActivation::Eager) {
+    }
+
+    explicit Mode(ProcessorActivation activation) {
       initialize();
+      if (activation == ProcessorActivation::Eager) {
+        warmUp();
+      }
     }
 
     Mode(const Mode& other) :
@@ -73,9 +94,11 @@ namespace helgoboss {
         eelFeedbackTransformation(other.eelFeedbackTransformation),
         minStepSize(other.minStepSize),
         maxStepSize(other.maxStepSize),
-        rotateIsEnabled(other.rotateIsEnabled.get()),
-        processor_(createProcessor()) {
+        rotateIsEnabled(other.rotateIsEnabled.get()) {
       initialize();
+      if (other.isWarmedUp()) {
+        warmUp();
+      }
     }
     // TODO Right now move constructor will invoke copy constructor. Maybe optimize later.
     // Default move assignment is okay because object and therefore reactive properties stay the same, just not their
@@ -207,47 +230,71 @@ namespace helgoboss {
       }
     }
     void updateFromJson(const nlohmann::json& j) {
-      {
-        const int typeIndex = j.at("type");
-        type.set(static_cast<ModeType>(typeIndex));
-      }
-      minSourceValue.set(j.at("minSourceValue"));
-      maxSourceValue.set(j.at("maxSourceValue"));
-      minTargetValue.set(j.at("minTargetValue"));
-      maxTargetValue.set(j.at("maxTargetValue"));
-      if (j.count("reverseIsEnabled")) {
-        reverseIsEnabled.set(j.at("reverseIsEnabled"));
-      }
-      if (j.count("ignoreOutOfRangeSourceValuesIsEnabled")) {
-        ignoreOutOfRangeSourceValuesIsEnabled.set(j.at("ignoreOutOfRangeSourceValuesIsEnabled"));
-      }
-      if (j.count("roundTargetValue")) {
-        roundTargetValue.set(j.at("roundTargetValue"));
-      }
-      if (j.count("scaleModeEnabled")) {
-        scaleModeEnabled.set(j.at("scaleModeEnabled"));
-      }
-      if (j.count("minTargetJump")) {
-        minTargetJump.set(j.at("minTargetJump"));
-      }
-      if (j.count("maxTargetJump")) {
-        maxTargetJump.set(j.at("maxTargetJump"));
-      }
-      if (j.count("eelControlTransformation")) {
-        eelControlTransformation.set(j.at("eelControlTransformation"));
-      }
-      if (j.count("eelFeedbackTransformation")) {
-        eelFeedbackTransformation.set(j.at("eelFeedbackTransformation"));
-      }
-      if (j.count("minStepSize")) {
-        minStepSize.set(j.at("minStepSize"));
-      }
-      if (j.count("maxStepSize")) {
-        maxStepSize.set(j.at("maxStepSize"));
-      }
-      if (j.count("rotateIsEnabled")) {
-        rotateIsEnabled.set(j.at("rotateIsEnabled"));
-      }
+      modifyInBatch([this, &j] {
+        {
+          const int typeIndex = j.at("type");
+          type.set(static_cast<ModeType>(typeIndex));
+        }
+        minSourceValue.set(j.at("minSourceValue"));
+        maxSourceValue.set(j.at("maxSourceValue"));
+        minTargetValue.set(j.at("minTargetValue"));
+        maxTargetValue.set(j.at("maxTargetValue"));
+        const auto end = j.end();
+        const auto reverseIsEnabledIt = j.find("reverseIsEnabled");
+        if (reverseIsEnabledIt != end) {
+          reverseIsEnabled.set(*reverseIsEnabledIt);
+        }
+        const auto ignoreOutOfRangeSourceValuesIsEnabledIt = j.find("ignoreOutOfRangeSourceValuesIsEnabled");
+        if (ignoreOutOfRangeSourceValuesIsEnabledIt != end) {
+          ignoreOutOfRangeSourceValuesIsEnabled.set(*ignoreOutOfRangeSourceValuesIsEnabledIt);
+        }
+        const auto roundTargetValueIt = j.find("roundTargetValue");
+        if (roundTargetValueIt != end) {
+          roundTargetValue.set(*roundTargetValueIt);
+        }
+        const auto scaleModeEnabledIt = j.find("scaleModeEnabled");
+        if (scaleModeEnabledIt != end) {
+          scaleModeEnabled.set(*scaleModeEnabledIt);
+        }
+        const auto minTargetJumpIt = j.find("minTargetJump");
+        if (minTargetJumpIt != end) {
+          minTargetJump.set(*minTargetJumpIt);
+        }
+        const auto maxTargetJumpIt = j.find("maxTargetJump");
+        if (maxTargetJumpIt != end) {
+          maxTargetJump.set(*maxTargetJumpIt);
+        }
+        const auto eelControlTransformationIt = j.find("eelControlTransformation");
+        if (eelControlTransformationIt != end) {
+          eelControlTransformation.set(eelControlTransformationIt->get_ref<const std::string&>());
+        }
+        const auto eelFeedbackTransformationIt = j.find("eelFeedbackTransformation");
+        if (eelFeedbackTransformationIt != end) {
+          eelFeedbackTransformation.set(eelFeedbackTransformationIt->get_ref<const std::string&>());
+        }
+        const auto minStepSizeIt = j.find("minStepSize");
+        if (minStepSizeIt != end) {
+          minStepSize.set(*minStepSizeIt);
+        }
+        const auto maxStepSizeIt = j.find("maxStepSize");
+        if (maxStepSizeIt != end) {
+          maxStepSize.set(*maxStepSizeIt);
+        }
+        const auto rotateIsEnabledIt = j.find("rotateIsEnabled");
+        if (rotateIsEnabledIt != end) {
+          rotateIsEnabled.set(*rotateIsEnabledIt);
+        }
+      });
+    }
+    /**
+     * Executes the given function, which is supposed to change several properties, and updates the processor just
+     * once at the end instead of on each property change. Change notifications are still fired.
+     */
+    template<typename F>
+    void modifyInBatch(F modify) {
+      processorSync_.modifyInBatch(modify, [this] {
+        syncProcessor();
+      });
     }
     template<typename Target>
     bool settingsMakeSense(const Source& source, const Target& target) const {
@@ -285,16 +332,91 @@ namespace helgoboss {
     //endregion
 
     //region Processing
+    /**
+     * Builds the processor and compiles the EEL scripts if this mode has been created with lazy activation and hasn't
+     * been used yet. Otherwise the first use does it, which allocates and compiles on whatever thread that happens. So
+     * warm up lazy modes on the control thread (or see util::warmUpInBackground()) before using them on the real-time
+     * thread. Must not be called concurrently with other methods of this mode.
+     */
+    void warmUp() const {
+      if (processor_) {
+        return;
+      }
+      processor_ = createProcessor();
+      {
+        std::lock_guard<std::mutex> lock(internal::getEelCompilationMutex());
+        feedbackVm_.reset(NSEEL_VM_alloc());
+        feedbackVariableX_ = NSEEL_VM_regvar(feedbackVm_.get(), "x");
+        feedbackVariableY_ = NSEEL_VM_regvar(feedbackVm_.get(), "y");
+      }
+      compileEelFeedbackTransformation();
+    }
+
+    bool isWarmedUp() const {
+      return processor_.has_value();
+    }
+
+    /**
+     * Warms this mode up first if it hasn't been used yet (see warmUp()).
+     */
     ModeProcessor& getProcessor() {
-      return processor_;
+      warmUp();
+      return *processor_;
     }
 
     const ModeProcessor& getProcessor() const {
-      return processor_;
+      warmUp();
+      return *processor_;
+    }
+
+    /**
+     * Attaches statistics which from now on count target hits, out-of-range source values, suppressed jumps and EEL
+     * execution times. Pass nullptr to detach. The statistics must outlive this mode or be detached before they are
+     * destroyed.
+     */
+    void setStatistics(ProcessorStatistics* statistics) {
+      statistics_ = statistics;
+      if (processor_) {
+        processor_->setStatistics(statistics);
+      }
+    }
+
+    ProcessorStatistics* getStatistics() const {
+      return statistics_;
     }
 
+    /**
+     * Attaches a latency tracer, see ModeProcessor::processTraced(). Pass nullptr to detach.
+     */
+    void setLatencyTracer(LatencyTracer* latencyTracer) {
+      latencyTracer_ = latencyTracer;
+      if (processor_) {
+        processor_->setLatencyTracer(latencyTracer);
+      }
+    }
+
+    LatencyTracer* getLatencyTracer() const {
+      return latencyTracer_;
+    }
+
+    /**
+     * Makes the processor of this mode share its configuration with processors of other modes with equal settings, now
+     * and whenever the settings change. Pass nullptr to stop sharing. The pool must outlive this mode or be detached
+     * before it is destroyed.
+     */
+    void setConfigPool(ModeConfigPool* configPool) {
+      configPool_ = configPool;
+      if (processor_) {
+        processor_ = createProcessor();
+      }
+    }
+
+    /**
+     * Warms this mode up first if it hasn't been used yet (see warmUp()).
+     */
     template<typename SourceContext, typename Target>
     void feedback(Source& source, const Target& target, SourceContext& sourceContext) {
+      warmUp();
       switch (type.get()) {
         case ModeType::Absolute:
           feedbackInAbsoluteMode(source, target, sourceContext);
@@ -319,10 +441,18 @@ namespace helgoboss {
 
     void keepProcessorInSync() {
       changed().subscribe([this](bool) {
-        processor_ = createProcessor();
+        if (!processorSync_.isSuspended()) {
+          syncProcessor();
+        }
       });
     }
 
+    void syncProcessor() {
+      if (isWarmedUp()) {
+        processor_ = createProcessor();
+      }
+    }
+
     template<typename Target>
     double getDefaultMinStepSize(const Target& target) const {
       if (target.getCharacter() == TargetCharacter::Discrete) {
@@ -383,7 +513,13 @@ namespace helgoboss {
       }
       *feedbackVariableX_ = normalizedValue;
       *feedbackVariableY_ = normalizedValue;
-      NSEEL_code_execute(feedbackCodeHandle_.get());
+      if (statistics_ == nullptr) {
+        NSEEL_code_execute(feedbackCodeHandle_.get());
+      } else {
+        const auto start = std::chrono::steady_clock::now();
+        NSEEL_code_execute(feedbackCodeHandle_.get());
+        statistics_->countFeedbackTransformation(std::chrono::steady_clock::now() - start);
+      }
       return *feedbackVariableX_;
     }
     void ensureThatMinValsAlwaysLowerThanMaxVals() {
@@ -393,16 +529,18 @@ namespace helgoboss {
       internal::ensureThatMinAlwaysLowerThanMax(minStepSize, maxStepSize);
     }
     void initEelTransformation() {
-      compileEelFeedbackTransformation();
       // @closureIsSafe
       eelFeedbackTransformation.changed().subscribe([this](bool) {
-        compileEelFeedbackTransformation();
+        if (isWarmedUp()) {
+          compileEelFeedbackTransformation();
+        }
       });
     }
-    void compileEelFeedbackTransformation() {
+    void compileEelFeedbackTransformation() const {
       if (boost::trim_copy(eelFeedbackTransformation.get()).empty()) {
         feedbackCodeHandle_.reset(nullptr);
       } else {
+        std::lock_guard<std::mutex> lock(internal::getEelCompilationMutex());
         NSEEL_CODEHANDLE raw = NSEEL_code_compile(feedbackVm_.get(), eelFeedbackTransformation.get().c_str(), 0);
         feedbackCodeHandle_.reset(raw);
       }
@@ -436,7 +574,7 @@ namespace helgoboss {
       }
     }
     ModeProcessor createProcessor() const {
-      return ModeProcessor(
+      ModeProcessor processor(
           type.get(),
           minTargetValue.get(),
           maxTargetValue.get(),
@@ -453,6 +591,9 @@ namespace helgoboss {
           maxStepSize.get(),
           rotateIsEnabled.get()
       );
+      processor.setStatistics(statistics_);
+      processor.setLatencyTracer(latencyTracer_);
+      return configPool_ == nullptr ? std::move(processor) : configPool_->intern(std::move(processor));
     }
   };
 }
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include "ModeProcessor.h"
+
+namespace helgoboss {
+  namespace internal {
+    struct ModeConfigHash {
+      std::size_t operator()(const std::shared_ptr<const ModeConfig>& config) const;
+    };
+
+    struct ModeConfigEqual {
+      bool operator()(const std::shared_ptr<const ModeConfig>& lhs,
+          const std::shared_ptr<const ModeConfig>& rhs) const {
+        return lhs->hasSameSettingsAs(*rhs);
+      }
+    };
+  }
+
+  /**
+   * Makes mode processors with equal settings share one configuration (flyweight), so large presets with many similar
+   * mappings need one configuration per distinct setting instead of one per mapping. It also keeps the shared
+   * configuration in cache when one event is passed to many mappings. Configurations with EEL control transformation
+   * are not pooled because executing the transformation writes its variables.
+   *
+   * Configurations stay in the pool until removeUnusedConfigs() is called, even if no processor uses them anymore.
+   * Processors keep their configuration alive, so they can outlive the pool. Thread-safe, because modes which use the
+   * pool might be warmed up in the background (see util::warmUpInBackground()) while others change on the control
+   * thread.
+   */
+  class ModeConfigPool {
+  private:
+    mutable std::mutex mutex_;
+    std::unordered_set<std::shared_ptr<const internal::ModeConfig>, internal::ModeConfigHash,
+        internal::ModeConfigEqual> configs_;
+  public:
+    /**
+     * Returns a processor which behaves exactly like the given one but uses the pooled configuration with the same
+     * settings. If there's none yet, the configuration of the given processor is added to the pool. Statistics and
+     * latency tracer are kept. Processors with EEL control transformation are returned as they are.
+     */
+    ModeProcessor intern(ModeProcessor processor);
+
+    std::size_t getConfigCount() const;
+
+    /**
+     * Removes all configurations which are not used by any processor anymore. Returns the number of removed ones.
+     */
+    std::size_t removeUnusedConfigs();
+  };
+}
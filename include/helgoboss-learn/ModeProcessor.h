@@ -2,12 +2,18 @@
 
 #include <string>
 #include <memory>
+#include <mutex>
 #include <cmath>
+#include <stdexcept>
 #include <boost/algorithm/string.hpp>
 #include <eel2/ns-eel.h>
 #include "math-util.h"
+#include "fixed-point-util.h"
 #include "ModeType.h"
 #include "SourceProcessor.h"
+#include "ProcessorStatistics.h"
+#include "LatencyTracer.h"
+#include <chrono>
 
 namespace helgoboss {
   namespace internal {
@@ -27,33 +33,282 @@ namespace helgoboss {
     constexpr bool DEFAULT_SCALE_MODE_ENABLED = false;
 
     double alignToStepSize(double value, double stepSize);
+
+    // Compiling EEL code touches global state, so it's serialized with this. Executing it doesn't need it.
+    std::mutex& getEelCompilationMutex();
+
+    /**
+     * The settings which absolute mode needs apart from the EEL control transformation.
+     */
+    struct AbsoluteModeSettings {
+      double minSourceValue{DEFAULT_MIN_SOURCE_VALUE};
+      double maxSourceValue{DEFAULT_MAX_SOURCE_VALUE};
+      double minTargetValue{DEFAULT_MIN_TARGET_VALUE};
+      double maxTargetValue{DEFAULT_MAX_TARGET_VALUE};
+      double minTargetJump{DEFAULT_MIN_TARGET_JUMP};
+      double maxTargetJump{DEFAULT_MAX_TARGET_JUMP};
+      bool reverseIsEnabled{DEFAULT_REVERSE_IS_ENABLED};
+      bool ignoreOutOfRangeSourceValuesIsEnabled{DEFAULT_IGNORE_OUT_OF_RANGE_SOURCE_VALUES_IS_ENABLED};
+      bool roundTargetValue{DEFAULT_ROUND_TARGET_VALUE};
+      bool scaleModeEnabled{DEFAULT_SCALE_MODE_ENABLED};
+    };
+
+    // Statistics and latency tracer may be nullptr
+    template<typename Target>
+    void hitTarget(Target& target, double value, bool isStepCount, ProcessorStatistics* statistics,
+        LatencyTracer* latencyTracer) {
+      if (statistics != nullptr) {
+        statistics->countTargetHit();
+      }
+      if (latencyTracer == nullptr) {
+        target.hit(value, isStepCount);
+      } else {
+        const auto start = latencyTracer->now();
+        target.hit(value, isStepCount);
+        latencyTracer->recordSince(LatencyStage::Hit, start);
+      }
+    }
+
+    template<typename Target>
+    void hitTargetAbsolutelyConsideringMaxJump(const AbsoluteModeSettings& settings, Target& target,
+        double absoluteValue, ProcessorStatistics* statistics, LatencyTracer* latencyTracer) {
+      const double currentTargetValue = target.getCurrentValue();
+      const double jump = std::abs(absoluteValue - currentTargetValue);
+      if (jump <= settings.maxTargetJump) {
+        if (jump >= settings.minTargetJump) {
+          hitTarget(target, absoluteValue, false, statistics, latencyTracer);
+        } else if (statistics != nullptr) {
+          statistics->countSuppressedJump();
+        }
+      } else if (settings.scaleModeEnabled) {
+        const double approachJump =
+            util::mapNormalizedValueToValueInRange(jump, settings.minTargetJump, settings.maxTargetJump);
+        if (absoluteValue < currentTargetValue) {
+          hitTarget(target, currentTargetValue - approachJump, false, statistics, latencyTracer);
+        } else {
+          hitTarget(target, currentTargetValue + approachJump, false, statistics, latencyTracer);
+        }
+      } else if (statistics != nullptr) {
+        statistics->countSuppressedJump();
+      }
+    }
+
+    template<typename Target>
+    double roundValueIfNecessary(const AbsoluteModeSettings& settings, double absoluteValue, const Target& target) {
+      if (settings.roundTargetValue && target.canBeDiscrete()) {
+        const int targetValueSpan = static_cast<int>(1 / target.getStepSize());
+        return std::round(absoluteValue * targetValueSpan) / targetValueSpan;
+      } else {
+        return absoluteValue;
+      }
+    }
+
+    /**
+     * The absolute mode of ModeProcessor. The control transformation is applied to the source value after mapping it
+     * to the source range, it's the identity function if there's no EEL control transformation.
+     */
+    template<typename ControlTransformation, typename Target>
+    void processSourceValueInAbsoluteMode(const AbsoluteModeSettings& settings, double normalizedSourceValue,
+        const ControlTransformation& transformControlValue, Target& target, ProcessorStatistics* statistics,
+        LatencyTracer* latencyTracer) {
+      if (normalizedSourceValue >= settings.minSourceValue && normalizedSourceValue <= settings.maxSourceValue) {
+        const double mappedSourceValue = util::mapValueInRangeToNormalizedValue(
+            normalizedSourceValue, settings.minSourceValue, settings.maxSourceValue);
+        const double transformedSourceValue = transformControlValue(mappedSourceValue);
+        const double tmpValue = util::mapNormalizedValueToValueInRange(
+            transformedSourceValue, settings.minTargetValue, settings.maxTargetValue);
+        const double absoluteValue = settings.reverseIsEnabled ? 1 - tmpValue : tmpValue;
+        const double potentiallyDiscreteValue = roundValueIfNecessary(settings, absoluteValue, target);
+        hitTargetAbsolutelyConsideringMaxJump(settings, target, potentiallyDiscreteValue, statistics, latencyTracer);
+      } else {
+        if (statistics != nullptr) {
+          statistics->countOutOfRangeEvent();
+        }
+        if (settings.ignoreOutOfRangeSourceValuesIsEnabled) {
+          return;
+        }
+        if (normalizedSourceValue < settings.minSourceValue) {
+          hitTargetAbsolutelyConsideringMaxJump(settings, target, settings.minTargetValue, statistics, latencyTracer);
+        } else {
+          hitTargetAbsolutelyConsideringMaxJump(settings, target, settings.maxTargetValue, statistics, latencyTracer);
+        }
+      }
+    }
+
+    /**
+     * Everything about a mode processor which doesn't change after construction: The settings, values derived from
+     * them and the compiled EEL control transformation. The only thing that's written after construction are the EEL
+     * variables, whenever the transformation is executed. That's why configurations with EEL control transformation are
+     * never shared between processors.
+     */
+    struct ModeConfig {
+      ModeType type{ModeType::Absolute};
+      double minTargetValue{DEFAULT_MIN_TARGET_VALUE};
+      double maxTargetValue{DEFAULT_MAX_TARGET_VALUE};
+      double minSourceValue{DEFAULT_MIN_SOURCE_VALUE};
+      double maxSourceValue{DEFAULT_MAX_SOURCE_VALUE};
+      bool reverseIsEnabled{DEFAULT_REVERSE_IS_ENABLED};
+      bool ignoreOutOfRangeSourceValuesIsEnabled{DEFAULT_IGNORE_OUT_OF_RANGE_SOURCE_VALUES_IS_ENABLED};
+      double minTargetJump{DEFAULT_MIN_TARGET_JUMP};
+      double maxTargetJump{DEFAULT_MAX_TARGET_JUMP};
+      bool roundTargetValue{DEFAULT_ROUND_TARGET_VALUE};
+      bool scaleModeEnabled{DEFAULT_SCALE_MODE_ENABLED};
+      double minStepSize{DEFAULT_MIN_STEP_SIZE};
+      double maxStepSize{DEFAULT_MAX_STEP_SIZE};
+      bool rotateIsEnabled{DEFAULT_ROTATE_IS_ENABLED};
+      std::string eelControlTransformation{DEFAULT_EEL_CONTROL_TRANSFORMATION};
+      // Derived from the settings above
+      AbsoluteModeSettings absoluteModeSettings{};
+      // Derived from the settings above, used by the fixed-point path only
+      util::FixedPointValue minTargetValueFixed{};
+      util::FixedPointValue maxTargetValueFixed{};
+      util::FixedPointValue minSourceValueFixed{};
+      util::FixedPointValue maxSourceValueFixed{};
+      // Only allocated if there's a transformation
+      std::unique_ptr<void, decltype(&NSEEL_VM_free)> controlVm{nullptr, NSEEL_VM_free};
+      std::unique_ptr<void, decltype(&NSEEL_code_free)> controlCodeHandle{nullptr, NSEEL_code_free};
+      // Will be deleted together with VM
+      double* controlVariableX = nullptr;
+      double* controlVariableY = nullptr;
+
+      ModeConfig() {
+        initialize();
+      }
+
+      // Shared by all processors which have been moved from, allocated on first use
+      static const std::shared_ptr<const ModeConfig>& getDefault() {
+        static const auto config = std::make_shared<const ModeConfig>();
+        return config;
+      }
+
+      ModeConfig(
+          ModeType type,
+          double minTargetValue,
+          double maxTargetValue,
+          double minSourceValue,
+          double maxSourceValue,
+          bool reverseIsEnabled,
+          bool ignoreOutOfRangeSourceValuesIsEnabled,
+          double minTargetJump,
+          double maxTargetJump,
+          std::string eelControlTransformation,
+          bool roundTargetValue,
+          bool scaleModeEnabled,
+          double minStepSize,
+          double maxStepSize,
+          bool rotateIsEnabled
+      ) : type(type),
+          minTargetValue(minTargetValue),
+          maxTargetValue(maxTargetValue),
+          minSourceValue(minSourceValue),
+          maxSourceValue(maxSourceValue),
+          reverseIsEnabled(reverseIsEnabled),
+          ignoreOutOfRangeSourceValuesIsEnabled(ignoreOutOfRangeSourceValuesIsEnabled),
+          minTargetJump(minTargetJump),
+          maxTargetJump(maxTargetJump),
+          roundTargetValue(roundTargetValue),
+          scaleModeEnabled(scaleModeEnabled),
+          minStepSize(minStepSize),
+          maxStepSize(maxStepSize),
+          rotateIsEnabled(rotateIsEnabled),
+          eelControlTransformation(std::move(eelControlTransformation)) {
+        initialize();
+      }
+
+      // Compiles the EEL transformation again, so the copy has its own VM
+      ModeConfig(const ModeConfig& other) : ModeConfig(
+          other.type,
+          other.minTargetValue,
+          other.maxTargetValue,
+          other.minSourceValue,
+          other.maxSourceValue,
+          other.reverseIsEnabled,
+          other.ignoreOutOfRangeSourceValuesIsEnabled,
+          other.minTargetJump,
+          other.maxTargetJump,
+          other.eelControlTransformation,
+          other.roundTargetValue,
+          other.scaleModeEnabled,
+          other.minStepSize,
+          other.maxStepSize,
+          other.rotateIsEnabled
+      ) {
+      }
+      ModeConfig& operator=(const ModeConfig& other) = delete;
+
+      bool hasEelControlTransformation() const {
+        return controlCodeHandle != nullptr;
+      }
+
+      // Compares the settings only
+      bool hasSameSettingsAs(const ModeConfig& other) const {
+        return type == other.type
+            && minTargetValue == other.minTargetValue
+            && maxTargetValue == other.maxTargetValue
+            && minSourceValue == other.minSourceValue
+            && maxSourceValue == other.maxSourceValue
+            && reverseIsEnabled == other.reverseIsEnabled
+            && ignoreOutOfRangeSourceValuesIsEnabled == other.ignoreOutOfRangeSourceValuesIsEnabled
+            && minTargetJump == other.minTargetJump
+            && maxTargetJump == other.maxTargetJump
+            && roundTargetValue == other.roundTargetValue
+            && scaleModeEnabled == other.scaleModeEnabled
+            && minStepSize == other.minStepSize
+            && maxStepSize == other.maxStepSize
+            && rotateIsEnabled == other.rotateIsEnabled
+            && eelControlTransformation == other.eelControlTransformation;
+      }
+
+    private:
+      void initialize() {
+        absoluteModeSettings = {
+            minSourceValue,
+            maxSourceValue,
+            minTargetValue,
+            maxTargetValue,
+            minTargetJump,
+            maxTargetJump,
+            reverseIsEnabled,
+            ignoreOutOfRangeSourceValuesIsEnabled,
+            roundTargetValue,
+            scaleModeEnabled
+        };
+        minTargetValueFixed = util::toFixedPoint(minTargetValue);
+        maxTargetValueFixed = util::toFixedPoint(maxTargetValue);
+        minSourceValueFixed = util::toFixedPoint(minSourceValue);
+        maxSourceValueFixed = util::toFixedPoint(maxSourceValue);
+        if (!eelControlTransformation.empty()) {
+          std::lock_guard<std::mutex> lock(getEelCompilationMutex());
+          controlVm.reset(NSEEL_VM_alloc());
+          controlVariableX = NSEEL_VM_regvar(controlVm.get(), "x");
+          controlVariableY = NSEEL_VM_regvar(controlVm.get(), "y");
+          NSEEL_CODEHANDLE raw = NSEEL_code_compile(controlVm.get(), eelControlTransformation.c_str(), 0);
+          controlCodeHandle.reset(raw);
+        }
+      }
+    };
   }
+
+  class ModeConfigPool;
+
+  /**
+   * Applies the mode settings to source values and hits the target. The settings live in an immutable configuration
+   * which can be shared between processors, so only the statistics and latency tracer are per processor.
+   *
+   * Copies share the configuration unless it contains an EEL control transformation. In that case the copy compiles
+   * its own, so original and copy can be used on different threads. The same goes for processors interned in a
+   * ModeConfigPool. A moved-from processor falls back to the default settings.
+   */
   class ModeProcessor {
+    friend class ModeConfigPool;
   private:
-    ModeType type_{ModeType::Absolute};
-    double minTargetValue_{internal::DEFAULT_MIN_TARGET_VALUE};
-    double maxTargetValue_{internal::DEFAULT_MAX_TARGET_VALUE};
-    double minSourceValue_{internal::DEFAULT_MIN_SOURCE_VALUE};
-    double maxSourceValue_{internal::DEFAULT_MAX_SOURCE_VALUE};
-    bool reverseIsEnabled_{internal::DEFAULT_REVERSE_IS_ENABLED};
-    bool ignoreOutOfRangeSourceValuesIsEnabled_{internal::DEFAULT_IGNORE_OUT_OF_RANGE_SOURCE_VALUES_IS_ENABLED};
-    double minTargetJump_{internal::DEFAULT_MIN_TARGET_JUMP};
-    double maxTargetJump_{internal::DEFAULT_MAX_TARGET_JUMP};
-    bool roundTargetValue_{internal::DEFAULT_ROUND_TARGET_VALUE};
-    bool scaleModeEnabled_{internal::DEFAULT_SCALE_MODE_ENABLED};
-    double minStepSize_{internal::DEFAULT_MIN_STEP_SIZE};
-    double maxStepSize_{internal::DEFAULT_MAX_STEP_SIZE};
-    bool rotateIsEnabled_{internal::DEFAULT_ROTATE_IS_ENABLED};
-    std::unique_ptr<void, decltype(&NSEEL_VM_free)> controlVm_{NSEEL_VM_alloc(), NSEEL_VM_free};
-    // Only needed for copying
-    std::string eelControlTransformation_{internal::DEFAULT_EEL_CONTROL_TRANSFORMATION};
-    std::unique_ptr<void, decltype(&NSEEL_code_free)> controlCodeHandle_{nullptr, NSEEL_code_free};
-    // Will be deleted together with VM
-    double* controlVariableX_{NSEEL_VM_regvar(controlVm_.get(), "x")};
-    double* controlVariableY_{NSEEL_VM_regvar(controlVm_.get(), "y")};
+    std::shared_ptr<const internal::ModeConfig> config_;
+    // Not owned
+    ProcessorStatistics* statistics_ = nullptr;
+    // Not owned
+    LatencyTracer* latencyTracer_ = nullptr;
   public:
-    ModeProcessor() {
-      initialize();
+    ModeProcessor() : config_(std::make_shared<const internal::ModeConfig>()) {
     };
 
     ModeProcessor(
@@ -72,50 +327,60 @@ namespace helgoboss {
         double minStepSize,
         double maxStepSize,
         bool rotateIsEnabled
-    ) : type_(type),
-        minTargetValue_(minTargetValue),
-        maxTargetValue_(maxTargetValue),
-        minSourceValue_(minSourceValue),
-        maxSourceValue_(maxSourceValue),
-        reverseIsEnabled_(reverseIsEnabled),
-        ignoreOutOfRangeSourceValuesIsEnabled_(ignoreOutOfRangeSourceValuesIsEnabled),
-        minTargetJump_(minTargetJump),
-        maxTargetJump_(maxTargetJump),
-        roundTargetValue_(roundTargetValue),
-        scaleModeEnabled_(scaleModeEnabled),
-        minStepSize_(minStepSize),
-        maxStepSize_(maxStepSize),
-        rotateIsEnabled_(rotateIsEnabled),
-        eelControlTransformation_(boost::trim_copy(eelControlTransformation)) {
-      initialize();
+    ) : config_(std::make_shared<const internal::ModeConfig>(
+        type,
+        minTargetValue,
+        maxTargetValue,
+        minSourceValue,
+        maxSourceValue,
+        reverseIsEnabled,
+        ignoreOutOfRangeSourceValuesIsEnabled,
+        minTargetJump,
+        maxTargetJump,
+        boost::trim_copy(eelControlTransformation),
+        roundTargetValue,
+        scaleModeEnabled,
+        minStepSize,
+        maxStepSize,
+        rotateIsEnabled
+    )) {
     }
 
     ModeProcessor(const ModeProcessor& other) :
-        type_(other.type_),
-        minTargetValue_(other.minTargetValue_),
-        maxTargetValue_(other.maxTargetValue_),
-        minSourceValue_(other.minSourceValue_),
-        maxSourceValue_(other.maxSourceValue_),
-        reverseIsEnabled_(other.reverseIsEnabled_),
-        ignoreOutOfRangeSourceValuesIsEnabled_(other.ignoreOutOfRangeSourceValuesIsEnabled_),
-        minTargetJump_(other.minTargetJump_),
-        maxTargetJump_(other.maxTargetJump_),
-        roundTargetValue_(other.roundTargetValue_),
-        scaleModeEnabled_(other.scaleModeEnabled_),
-        minStepSize_(other.minStepSize_),
-        maxStepSize_(other.maxStepSize_),
-        rotateIsEnabled_(other.rotateIsEnabled_),
-        eelControlTransformation_(other.eelControlTransformation_) {
-      initialize();
-    }
-    // TODO Right now move constructor will invoke copy constructor. Maybe optimize later.
-    ModeProcessor& operator=(ModeProcessor&& other) noexcept = default;
+        config_(other.config_->hasEelControlTransformation()
+            ? std::make_shared<const internal::ModeConfig>(*other.config_)
+            : other.config_),
+        statistics_(other.statistics_),
+        latencyTracer_(other.latencyTracer_) {
+    }
+    ModeProcessor(ModeProcessor&& other) noexcept :
+        config_(std::move(other.config_)),
+        statistics_(other.statistics_),
+        latencyTracer_(other.latencyTracer_) {
+      other.config_ = internal::ModeConfig::getDefault();
+    }
+    ModeProcessor& operator=(ModeProcessor&& other) noexcept {
+      if (this != &other) {
+        config_ = std::move(other.config_);
+        statistics_ = other.statistics_;
+        latencyTracer_ = other.latencyTracer_;
+        other.config_ = internal::ModeConfig::getDefault();
+      }
+      return *this;
+    }
     // Right now not needed
     ModeProcessor& operator=(const ModeProcessor& other) = delete;
 
+    /**
+     * Returns whether this processor uses the very same configuration as the given one (not just equal settings).
+     */
+    bool sharesConfigWith(const ModeProcessor& other) const {
+      return config_ == other.config_;
+    }
+
     template<typename Target>
     void processSourceValue(double normalizedSourceValue, const SourceProcessor& sourceProcessor, Target& target) {
-      switch (type_) {
+      switch (config_->type) {
         case ModeType::Absolute:
           processSourceValueInAbsoluteMode(normalizedSourceValue, sourceProcessor, target);
           break;
@@ -130,6 +395,127 @@ namespace helgoboss {
       }
     }
 
+    /**
+     * Returns whether processFixedPointSourceValue() can be used, which is the case in absolute mode as long as no EEL
+     * control transformation is involved.
+     */
+    bool supportsFixedPointProcessing() const {
+      return config_->type == ModeType::Absolute && !config_->hasEelControlTransformation();
+    }
+
+    /**
+     * Like processSourceValue() but takes the source value in fixed-point format (see
+     * SourceProcessor::getFixedPointValue()) and does all computations up to the final target value with integer
+     * arithmetic. The result deviates from the one of processSourceValue() by at most a few fixed-point units. If the
+     * target value is rounded to the step size of a target with not too many steps (e.g. 128), the result is exactly
+     * the same.
+     *
+     * Pitch bend is the exception because its center is mapped to exactly 0.5 here (see
+     * SourceProcessor::getFixedPointValue()). It deviates by up to 6 fixed-point units when the source range is
+     * narrowed, so a rounded target value can end up one step next to the one of the double path.
+     *
+     * Only the control direction has a fixed-point path. Feedback (Mode::feedback(), Source::feedback()) is always
+     * computed with doubles.
+     *
+     * Throws std::logic_error if supportsFixedPointProcessing() returns false.
+     */
+    template<typename Target>
+    void processFixedPointSourceValue(
+        util::FixedPointValue sourceValue, const SourceProcessor& sourceProcessor, Target& target) {
+      if (!supportsFixedPointProcessing()) {
+        throw std::logic_error("Mode doesn't support fixed-point processing");
+      }
+      if (sourceValue >= config_->minSourceValueFixed && sourceValue <= config_->maxSourceValueFixed) {
+        const util::FixedPointValue mappedSourceValue = util::mapFixedPointInRangeToNormalizedFixedPoint(
+            sourceValue, config_->minSourceValueFixed, config_->maxSourceValueFixed);
+        const util::FixedPointValue tmpValue = util::mapNormalizedFixedPointToFixedPointInRange(
+            mappedSourceValue, config_->minTargetValueFixed, config_->maxTargetValueFixed);
+        const util::FixedPointValue absoluteValue =
+            config_->reverseIsEnabled ? util::FIXED_POINT_ONE - tmpValue : tmpValue;
+        hitTargetAbsolutelyConsideringMaxJump(target, roundFixedPointValueIfNecessary(absoluteValue, target));
+      } else {
+        countOutOfRangeEvent();
+        if (config_->ignoreOutOfRangeSourceValuesIsEnabled) {
+          return;
+        }
+        if (sourceValue < config_->minSourceValueFixed) {
+          hitTargetAbsolutelyConsideringMaxJump(target, config_->minTargetValue);
+        } else {
+          hitTargetAbsolutelyConsideringMaxJump(target, config_->maxTargetValue);
+        }
+      }
+    }
+
+    /**
+     * Processes the given source value, taking the fixed-point path whenever both this mode and the source support it.
+     */
+    template<typename Target>
+    void processSourceValuePreferringFixedPoint(
+        const SourceValue& value, const SourceProcessor& sourceProcessor, Target& target) {
+      if (supportsFixedPointProcessing()) {
+        if (const auto fixedPointValue = sourceProcessor.getFixedPointValue(value)) {
+          processFixedPointSourceValue(*fixedPointValue, sourceProcessor, target);
+          return;
+        }
+      }
+      processSourceValue(sourceProcessor.getNormalizedValue(value), sourceProcessor, target);
+    }
+
+    /**
+     * Makes this processor count out-of-range source values, target hits, suppressed jumps and EEL executions in the
+     * given statistics. Pass nullptr to stop counting.
+     */
+    void setStatistics(ProcessorStatistics* statistics) {
+      statistics_ = statistics;
+    }
+
+    /**
+     * Makes this processor record the Eel and Hit stages in the given tracer, which is also required for
+     * processTraced(). Pass nullptr to stop recording.
+     */
+    void setLatencyTracer(LatencyTracer* latencyTracer) {
+      latencyTracer_ = latencyTracer;
+    }
+
+    /**
+     * Runs the complete control chain for the given source value (match, normalize, mode transform) like
+     * processSourceValuePreferringFixedPoint() and records the duration of each stage in the attached latency tracer.
+     * The arrival timestamp must come from LatencyTracer::now() and is used for the EndToEnd stage. Returns whether the
+     * source processor matched the value.
+     *
+     * Throws std::logic_error if no latency tracer is attached.
+     */
+    template<typename Target>
+    bool processTraced(const SourceValue& value, std::uint64_t arrivalTimestamp,
+        const SourceProcessor& sourceProcessor, Target& target) {
+      if (latencyTracer_ == nullptr) {
+        throw std::logic_error("No latency tracer attached");
+      }
+      auto& tracer = *latencyTracer_;
+      const auto matchStart = tracer.now();
+      const bool matches = sourceProcessor.processes(value);
+      const auto normalizeStart = tracer.recordSince(LatencyStage::Match, matchStart);
+      if (!matches) {
+        return false;
+      }
+      std::uint64_t transformEnd;
+      const auto fixedPointValue = supportsFixedPointProcessing()
+          ? sourceProcessor.getFixedPointValue(value)
+          : boost::none;
+      if (fixedPointValue) {
+        const auto transformStart = tracer.recordSince(LatencyStage::Normalize, normalizeStart);
+        processFixedPointSourceValue(*fixedPointValue, sourceProcessor, target);
+        transformEnd = tracer.recordSince(LatencyStage::ModeTransform, transformStart);
+      } else {
+        const double normalizedValue = sourceProcessor.getNormalizedValue(value);
+        const auto transformStart = tracer.recordSince(LatencyStage::Normalize, normalizeStart);
+        processSourceValue(normalizedValue, sourceProcessor, target);
+        transformEnd = tracer.recordSince(LatencyStage::ModeTransform, transformStart);
+      }
+      tracer.record(LatencyStage::EndToEnd, transformEnd >= arrivalTimestamp ? transformEnd - arrivalTimestamp : 0);
+      return true;
+    }
+
   private:
     template<typename Target>
     void processSourceValueInRelativeMode(
@@ -142,7 +528,7 @@ namespace helgoboss {
             // Target wants step counts
             const int peppedUpStepCount = pepUpStepCount(stepCount, sourceProcessor, target);
             if (peppedUpStepCount != 0) {
-              target.hit(peppedUpStepCount, true);
+              hitTarget(target, peppedUpStepCount, true);
             }
           } else {
             // Target wants absolute values
@@ -153,8 +539,8 @@ namespace helgoboss {
                   stepCount,
                   getMinSourceStepCount(sourceProcessor),
                   getMaxSourceStepCount(sourceProcessor),
-                  minStepSize_,
-                  maxStepSize_
+                  config_->minStepSize,
+                  config_->maxStepSize
               );
               hitTargetAbsolutelyWithStepSize(target, getReverseFactor() * stepSize);
             } else {
@@ -164,21 +550,21 @@ namespace helgoboss {
             }
           }
         }
-      } else if (normalizedSourceValue > 0 && normalizedSourceValue >= minSourceValue_
-          && normalizedSourceValue <= maxSourceValue_) {
+      } else if (normalizedSourceValue > 0 && normalizedSourceValue >= config_->minSourceValue
+          && normalizedSourceValue <= config_->maxSourceValue) {
         // Relative one direction mode
         if (target.wantsToBeHitWithStepCounts()) {
           // Target wants step counts
           const double intermediateStepCount = util::mapValueInRangeToValueInRange(
               normalizedSourceValue,
-              minSourceValue_,
-              maxSourceValue_,
+              config_->minSourceValue,
+              config_->maxSourceValue,
               getMinStepCount(target),
               getMaxStepCount(target)
           );
           const double peppedUpStepCount = getReverseFactor() * static_cast<int>(std::round(intermediateStepCount));
           if (peppedUpStepCount != 0) {
-            target.hit(peppedUpStepCount, true);
+            hitTarget(target, peppedUpStepCount, true);
           }
         } else {
           // Target wants absolute values
@@ -187,20 +573,20 @@ namespace helgoboss {
             // Continuous target
             const double stepSize = util::mapValueInRangeToValueInRange(
                 normalizedSourceValue,
-                minSourceValue_,
-                maxSourceValue_,
-                minStepSize_,
-                maxStepSize_
+                config_->minSourceValue,
+                config_->maxSourceValue,
+                config_->minStepSize,
+                config_->maxStepSize
             );
             hitTargetAbsolutelyWithStepSize(target, getReverseFactor() * stepSize);
           } else {
             // Discrete target
-            const double alignedMinStepSize = internal::alignToStepSize(minStepSize_, targetStepSize);
-            const double alignedMaxStepSize = internal::alignToStepSize(maxStepSize_, targetStepSize);
+            const double alignedMinStepSize = internal::alignToStepSize(config_->minStepSize, targetStepSize);
+            const double alignedMaxStepSize = internal::alignToStepSize(config_->maxStepSize, targetStepSize);
             const double mappedStepSize = util::mapValueInRangeToValueInRange(
                 normalizedSourceValue,
-                minSourceValue_,
-                maxSourceValue_,
+                config_->minSourceValue,
+                config_->maxSourceValue,
                 alignedMinStepSize,
                 alignedMaxStepSize
             );
@@ -208,35 +594,32 @@ namespace helgoboss {
             hitTargetAbsolutelyWithStepSize(target, getReverseFactor() * alignedMappedStepSize);
           }
         }
+      } else if (normalizedSourceValue > 0) {
+        countOutOfRangeEvent();
       }
     }
     template<typename Target>
     void processSourceValueInAbsoluteMode(
         double normalizedSourceValue, const SourceProcessor& sourceProcessor, Target& target) {
-      if (normalizedSourceValue >= minSourceValue_ && normalizedSourceValue <= maxSourceValue_) {
-        const double mappedSourceValue =
-            util::mapValueInRangeToNormalizedValue(normalizedSourceValue, minSourceValue_, maxSourceValue_);
-        const double transformedSourceValue = transformControlValue(mappedSourceValue);
-        const double tmpValue =
-            util::mapNormalizedValueToValueInRange(transformedSourceValue, minTargetValue_, maxTargetValue_);
-        const double absoluteValue = reverseIsEnabled_ ? 1 - tmpValue : tmpValue;
-        const double potentiallyDiscreteValue = roundValueIfNecessary(absoluteValue, target);
-        hitTargetAbsolutelyConsideringMaxJump(target, potentiallyDiscreteValue);
-      } else if (!ignoreOutOfRangeSourceValuesIsEnabled_) {
-        if (normalizedSourceValue < minSourceValue_) {
-          hitTargetAbsolutelyConsideringMaxJump(target, minTargetValue_);
-        } else {
-          hitTargetAbsolutelyConsideringMaxJump(target, maxTargetValue_);
-        }
-      }
+      internal::processSourceValueInAbsoluteMode(
+          config_->absoluteModeSettings,
+          normalizedSourceValue,
+          [this](double value) {
+            return transformControlValue(value);
+          },
+          target,
+          statistics_,
+          latencyTracer_
+      );
     }
     template<typename Target>
     void processSourceValueInToggleMode(
         double normalizedSourceValue, const SourceProcessor& sourceProcessor, Target& target) {
       if (normalizedSourceValue > 0.0) {
-        const double centerTargetValue = (minTargetValue_ + maxTargetValue_) / 2;
-        const double absoluteValue = target.getCurrentValue() > centerTargetValue ? minTargetValue_ : maxTargetValue_;
-        target.hit(absoluteValue, false);
+        const double centerTargetValue = (config_->minTargetValue + config_->maxTargetValue) / 2;
+        const double absoluteValue =
+            target.getCurrentValue() > centerTargetValue ? config_->minTargetValue : config_->maxTargetValue;
+        hitTarget(target, absoluteValue, false);
       }
     }
     template<typename Target>
@@ -254,21 +637,21 @@ namespace helgoboss {
       return getReverseFactor() * static_cast<int>(std::round(intermediateStepCount));
     }
     int getReverseFactor() const {
-      return reverseIsEnabled_ ? -1 : 1;
+      return config_->reverseIsEnabled ? -1 : 1;
     }
     template<typename Target>
     int getMinStepCount(const Target& target) const {
-      return convertStepSizeToStepCount(minStepSize_, target);
+      return convertStepSizeToStepCount(config_->minStepSize, target);
     }
     template<typename Target>
     int getMaxStepCount(const Target& target) const {
-      return convertStepSizeToStepCount(maxStepSize_, target);
+      return convertStepSizeToStepCount(config_->maxStepSize, target);
     }
     int getMinSourceStepCount(const SourceProcessor& sourceProcessor) const {
-      return convertSourceValueToStepCount(minSourceValue_, sourceProcessor);
+      return convertSourceValueToStepCount(config_->minSourceValue, sourceProcessor);
     }
     int getMaxSourceStepCount(const SourceProcessor& sourceProcessor) const {
-      return convertSourceValueToStepCount(maxSourceValue_, sourceProcessor);
+      return convertSourceValueToStepCount(config_->maxSourceValue, sourceProcessor);
     }
     int convertSourceValueToStepCount(double normalizedValue, const SourceProcessor& sourceProcessor) const {
       return static_cast<int>(
@@ -286,67 +669,70 @@ namespace helgoboss {
       if (stepSize != 0) {
         const double absoluteTargetValue = target.getCurrentValue() + stepSize;
         const double peppedUpAbsoluteTargetValue = pepUpAbsoluteTargetValue(absoluteTargetValue, target);
-        target.hit(peppedUpAbsoluteTargetValue, false);
+        hitTarget(target, peppedUpAbsoluteTargetValue, false);
       }
     }
     template<typename Target>
     double pepUpAbsoluteTargetValue(double absoluteTargetValue, Target& target) const {
       const double alignedValue = internal::alignToStepSize(absoluteTargetValue, target.getStepSize());
       double tmpResult = alignedValue;
-      if (rotateIsEnabled_) {
-        if (tmpResult < minTargetValue_) {
-          tmpResult = maxTargetValue_;
-        } else if (tmpResult > maxTargetValue_) {
-          tmpResult = minTargetValue_;
+      if (config_->rotateIsEnabled) {
+        if (tmpResult < config_->minTargetValue) {
+          tmpResult = config_->maxTargetValue;
+        } else if (tmpResult > config_->maxTargetValue) {
+          tmpResult = config_->minTargetValue;
         }
       }
-      return std::max(minTargetValue_, std::min(maxTargetValue_, tmpResult));
+      return std::max(config_->minTargetValue, std::min(config_->maxTargetValue, tmpResult));
     }
     double transformControlValue(double normalizedValue) const {
-      if (controlCodeHandle_ == nullptr) {
+      if (!config_->hasEelControlTransformation()) {
         return normalizedValue;
       }
-      *controlVariableX_ = normalizedValue;
-      *controlVariableY_ = normalizedValue;
-      NSEEL_code_execute(controlCodeHandle_.get());
-      return *controlVariableY_;
+      *config_->controlVariableX = normalizedValue;
+      *config_->controlVariableY = normalizedValue;
+      if (statistics_ == nullptr && latencyTracer_ == nullptr) {
+        NSEEL_code_execute(config_->controlCodeHandle.get());
+      } else {
+        executeControlCodeMeasured();
+      }
+      return *config_->controlVariableY;
+    }
+    void executeControlCodeMeasured() const {
+      const auto start = std::chrono::steady_clock::now();
+      const auto traceStart = latencyTracer_ == nullptr ? 0 : latencyTracer_->now();
+      NSEEL_code_execute(config_->controlCodeHandle.get());
+      if (latencyTracer_ != nullptr) {
+        latencyTracer_->recordSince(LatencyStage::Eel, traceStart);
+      }
+      if (statistics_ != nullptr) {
+        statistics_->countControlTransformation(std::chrono::steady_clock::now() - start);
+      }
+    }
+    template<typename Target>
+    void hitTarget(Target& target, double value, bool isStepCount) {
+      internal::hitTarget(target, value, isStepCount, statistics_, latencyTracer_);
+    }
+    void countOutOfRangeEvent() {
+      if (statistics_ != nullptr) {
+        statistics_->countOutOfRangeEvent();
+      }
     }
     template<typename Target>
-    double roundValueIfNecessary(double absoluteValue, const Target& target) {
-      if (roundTargetValue_ && target.canBeDiscrete()) {
+    double roundFixedPointValueIfNecessary(util::FixedPointValue absoluteValue, const Target& target) {
+      if (config_->roundTargetValue && target.canBeDiscrete()) {
         const int targetValueSpan = static_cast<int>(1 / target.getStepSize());
-        return std::round(absoluteValue * targetValueSpan) / targetValueSpan;
+        const auto discreteValue = internal::divideRounded(
+            static_cast<std::int64_t>(absoluteValue) * targetValueSpan, util::FIXED_POINT_ONE);
+        return static_cast<double>(discreteValue) / targetValueSpan;
       } else {
-        return absoluteValue;
+        return util::fromFixedPoint(absoluteValue);
       }
     }
     template<typename Target>
     void hitTargetAbsolutelyConsideringMaxJump(Target& target, double absoluteValue) {
-      const double currentTargetValue = target.getCurrentValue();
-      const double jump = std::abs(absoluteValue - currentTargetValue);
-      if (jump <= maxTargetJump_) {
-        if (jump >= minTargetJump_) {
-          target.hit(absoluteValue, false);
-        }
-      } else if (scaleModeEnabled_) {
-        const double approachJump = util::mapNormalizedValueToValueInRange(jump, minTargetJump_, maxTargetJump_);
-        if (absoluteValue < currentTargetValue) {
-          target.hit(currentTargetValue - approachJump, false);
-        } else {
-          target.hit(currentTargetValue + approachJump, false);
-        }
-      }
-    }
-
-    void initialize() {
-      initEelTransformation();
-    }
-
-    void initEelTransformation() {
-      if (!eelControlTransformation_.empty()) {
-        NSEEL_CODEHANDLE raw = NSEEL_code_compile(controlVm_.get(), eelControlTransformation_.c_str(), 0);
-        controlCodeHandle_.reset(raw);
-      }
+      internal::hitTargetAbsolutelyConsideringMaxJump(
+          config_->absoluteModeSettings, target, absoluteValue, statistics_, latencyTracer_);
     }
   };
 }
\ No newline at end of file
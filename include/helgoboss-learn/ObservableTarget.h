@@ -0,0 +1,17 @@
+#pragma once
+
+#include <rxcpp/rx.hpp>
+#include "Target.h"
+
+namespace helgoboss {
+  /**
+   * Optional extension of Target for targets which can tell when their current value changes. Feedback for such
+   * targets only needs to be computed after a change (see FeedbackScheduler).
+   */
+  class ObservableTarget : public Target {
+  public:
+    // Fires whenever the current value has changed, no matter why (hit or changed by someone else). Firing more often
+    // is okay, firing less often means missing feedback.
+    virtual rxcpp::observable<bool> changed() const = 0;
+  };
+}
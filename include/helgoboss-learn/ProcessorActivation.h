@@ -0,0 +1,11 @@
+#pragma once
+
+namespace helgoboss {
+  // Determines when a source or mode builds its processor (and compiles its EEL scripts)
+  enum class ProcessorActivation {
+    // Right away and again on each change
+    Eager,
+    // When warmUp() is called or the object is used for processing, whatever comes first. After that like Eager.
+    Lazy
+  };
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace helgoboss {
+  /**
+   * Counter values of ProcessorStatistics at one point in time. Rates can be computed by subtracting two snapshots.
+   */
+  struct ProcessorStatisticsSnapshot {
+    // Events for which SourceProcessor::processes() returned true
+    std::uint64_t matchedEventCount = 0;
+    // Source values outside of the mode's source value range
+    std::uint64_t outOfRangeEventCount = 0;
+    std::uint64_t targetHitCount = 0;
+    // Target values not sent because of the mode's target jump settings
+    std::uint64_t suppressedJumpCount = 0;
+    std::uint64_t feedbackMessageCount = 0;
+    std::uint64_t controlTransformationCount = 0;
+    std::uint64_t controlTransformationNanos = 0;
+    std::uint64_t feedbackTransformationCount = 0;
+    std::uint64_t feedbackTransformationNanos = 0;
+
+    /**
+     * Returns all counters in one line of plain text, e.g. for logging.
+     */
+    std::string toString() const;
+  };
+
+  ProcessorStatisticsSnapshot operator-(const ProcessorStatisticsSnapshot& lhs, const ProcessorStatisticsSnapshot& rhs);
+
+  /**
+   * Runtime counters of one mapping, which can be attached to its source and mode via Source::setStatistics() and
+   * Mode::setStatistics(). Nothing is counted if no statistics are attached.
+   *
+   * Each counter must only be written by one thread: All control processing of a mapping must happen on one thread
+   * (typically the real-time thread) and all feedback on one thread (which can be another one). That's why
+   * incrementing doesn't need a read-modify-write instruction, it's just a relaxed load and store. getSnapshot() can be
+   * called from any thread at any time.
+   */
+  class ProcessorStatistics {
+  private:
+    std::atomic<std::uint64_t> matchedEventCount_{0};
+    std::atomic<std::uint64_t> outOfRangeEventCount_{0};
+    std::atomic<std::uint64_t> targetHitCount_{0};
+    std::atomic<std::uint64_t> suppressedJumpCount_{0};
+    std::atomic<std::uint64_t> feedbackMessageCount_{0};
+    std::atomic<std::uint64_t> controlTransformationCount_{0};
+    std::atomic<std::uint64_t> controlTransformationNanos_{0};
+    std::atomic<std::uint64_t> feedbackTransformationCount_{0};
+    std::atomic<std::uint64_t> feedbackTransformationNanos_{0};
+  public:
+    void countMatchedEvent() {
+      increment(matchedEventCount_, 1);
+    }
+
+    void countOutOfRangeEvent() {
+      increment(outOfRangeEventCount_, 1);
+    }
+
+    void countTargetHit() {
+      increment(targetHitCount_, 1);
+    }
+
+    void countSuppressedJump() {
+      increment(suppressedJumpCount_, 1);
+    }
+
+    void countFeedbackMessages(std::uint64_t count) {
+      increment(feedbackMessageCount_, count);
+    }
+
+    void countControlTransformation(std::chrono::steady_clock::duration duration) {
+      increment(controlTransformationCount_, 1);
+      increment(controlTransformationNanos_, toNanos(duration));
+    }
+
+    void countFeedbackTransformation(std::chrono::steady_clock::duration duration) {
+      increment(feedbackTransformationCount_, 1);
+      increment(feedbackTransformationNanos_, toNanos(duration));
+    }
+
+    /**
+     * Counters are read one after the other, so the snapshot isn't necessarily consistent across counters.
+     */
+    ProcessorStatisticsSnapshot getSnapshot() const;
+
+  private:
+    static void increment(std::atomic<std::uint64_t>& counter, std::uint64_t amount) {
+      counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static std::uint64_t toNanos(std::chrono::steady_clock::duration duration) {
+      return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count());
+    }
+  };
+}
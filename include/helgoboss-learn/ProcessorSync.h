@@ -0,0 +1,36 @@
+#pragma once
+
+#include <gsl/gsl>
+
+namespace helgoboss::internal {
+  /**
+   * Keeps track of whether a source or mode currently changes several properties in a batch, in which case its
+   * processor isn't rebuilt on each property change but just once at the end.
+   */
+  class ProcessorSync {
+  private:
+    bool isSuspended_ = false;
+  public:
+    bool isSuspended() const {
+      return isSuspended_;
+    }
+
+    /**
+     * Executes modify with the sync suspended and calls sync at the end, even if modify throws. Nested batches just
+     * execute modify, the outermost one syncs.
+     */
+    template<typename Modify, typename Sync>
+    void modifyInBatch(Modify modify, Sync sync) {
+      if (isSuspended_) {
+        modify();
+        return;
+      }
+      isSuspended_ = true;
+      auto resume = gsl::finally([this, &sync] {
+        isSuspended_ = false;
+        sync();
+      });
+      modify();
+    }
+  };
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "BinaryPreset.h"
+#include "SourceValue.h"
+#include "preset-util.h"
+
+namespace helgoboss {
+  namespace internal {
+    // Layout of version 1. Numbers are stored in the byte order of the machine which wrote the capture.
+    //
+    // The header is followed by the preset in binary format (see BinaryPresetView) and the events. Each event starts
+    // with the nanoseconds since the previous event (since 0 for the first one) as unsigned LEB128 varint, followed
+    // by a SourceValueType byte and the content:
+    // - MidiMessage: status byte, data byte 1, data byte 2
+    // - MidiParameterNumberMessage: channel, flags (bit 0 = registered, bit 1 = 14-bit), number and value as varints
+    // - Midi14BitCcMessage: channel, MSB controller number, value as varint
+    // - TempoMessage: bpm as double
+    struct SessionCaptureHeader {
+      char magic[8];
+      std::uint32_t version;
+      std::uint32_t byteOrderMark;
+      std::uint64_t presetSize;
+      std::uint64_t eventCount;
+    };
+
+    static_assert(sizeof(SessionCaptureHeader) == 32, "Session capture header layout must not change");
+  }
+
+  struct CapturedEvent {
+    // Nanoseconds from any monotonic clock
+    std::uint64_t timestamp;
+    SourceValue value;
+  };
+
+  /**
+   * Records incoming source values together with the preset they were processed with, so that a user session can be
+   * replayed offline (see util::replaySession()). A typical MIDI event takes 5 bytes.
+   *
+   * Recording only allocates if the expected event count passed to the constructor is exceeded.
+   */
+  class SessionRecorder {
+  private:
+    std::string preset_;
+    std::string events_;
+    std::uint64_t eventCount_ = 0;
+    std::uint64_t lastTimestamp_ = 0;
+  public:
+    explicit SessionRecorder(const std::vector<ConstMappingRef>& mappings, std::size_t expectedEventCount = 0);
+
+    /**
+     * Timestamps must not decrease.
+     */
+    void record(std::uint64_t timestamp, const SourceValue& value);
+
+    std::uint64_t getEventCount() const;
+
+    /**
+     * Returns the complete capture. Recording can go on afterwards.
+     */
+    std::string toBytes() const;
+
+    /**
+     * Throws std::runtime_error if the file can't be written.
+     */
+    void writeToFile(const std::string& path) const;
+  };
+
+  /**
+   * Read-only access to a session capture, e.g. in a memory-mapped file. The data must outlive this view.
+   */
+  class SessionCaptureView {
+  public:
+    static constexpr std::uint32_t VERSION = 1;
+  private:
+    const char* data_;
+    std::size_t size_;
+    internal::SessionCaptureHeader header_;
+  public:
+    /**
+     * Throws std::runtime_error if the data doesn't look like a session capture which can be read on this machine.
+     */
+    SessionCaptureView(const void* data, std::size_t size);
+
+    BinaryPresetView getPreset() const;
+
+    std::uint64_t getEventCount() const;
+
+    /**
+     * Decodes all events. Throws std::runtime_error if the capture is truncated or corrupt.
+     */
+    std::vector<CapturedEvent> readEvents() const;
+  };
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include "SessionCapture.h"
+
+namespace helgoboss {
+  struct SessionReplayResult {
+    std::uint64_t eventCount = 0;
+    std::uint64_t mappingCount = 0;
+    std::uint64_t targetHitCount = 0;
+    std::uint64_t feedbackMessageCount = 0;
+    double elapsedSeconds = 0;
+    // FNV-1a hashes over all target hits (mapping index and value) respectively all feedback MIDI messages, in the
+    // order in which they happened. Equal checksums mean equal behavior.
+    std::uint64_t controlChecksum = 0;
+    std::uint64_t feedbackChecksum = 0;
+    // See LatencyTracer::exportToJson()
+    nlohmann::json latencies;
+
+    double getEventsPerSecond() const;
+
+    nlohmann::json toJson() const;
+  };
+
+  namespace util {
+    /**
+     * Loads the preset of the given capture into fresh mappings and sends all events through them as fast as
+     * possible, using the same path as a real host: ModeProcessor::processTraced() for control and, after each target
+     * hit, Mode::feedback(). Each mapping controls its own synthetic continuous target.
+     *
+     * The result doesn't depend on the timestamps in the capture, so two replays of the same capture with the same
+     * library version yield the same checksums.
+     */
+    SessionReplayResult replaySession(const SessionCaptureView& capture, bool withFeedback = true);
+  }
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "ModeProcessor.h"
+#include "SourceProcessor.h"
+#include "SourceValue.h"
+#include "Target.h"
+#include "WorkerPool.h"
+
+namespace helgoboss {
+  // Source value which arrived on the given input port (e.g. one per controller)
+  struct PortEvent {
+    int inputPort;
+    SourceValue value;
+  };
+
+  namespace internal {
+    struct ShardMapping {
+      int inputPort;
+      SourceProcessor source;
+      ModeProcessor mode;
+      std::size_t targetIndex;
+      // Global index, used for ordering hits
+      std::size_t mappingIndex;
+    };
+
+    struct ShardHit {
+      std::size_t eventIndex;
+      std::size_t mappingIndex;
+      std::size_t targetIndex;
+      double value;
+      bool isStepCount;
+    };
+
+    struct Shard {
+      std::vector<ShardMapping> mappings;
+      // Router: indexes into mappings by input port
+      std::unordered_map<int, std::vector<std::size_t>> mappingsByPort;
+      // Queue: indexes of the events of the current batch which arrived on ports of this shard
+      std::vector<std::size_t> eventIndexes;
+      // Target values as seen by this shard, indexed by target index
+      std::vector<double> targetValues;
+      std::vector<ShardHit> hits;
+    };
+  }
+
+  /**
+   * Processes events of independent controllers in parallel. Mappings are partitioned into shards by input port, and
+   * each shard is processed by its own worker thread (the calling thread is one of them).
+   *
+   * Workers don't touch the targets while processing. Each shard sees the target values as of the start of the batch
+   * plus its own hits, and records its hits. After all shards are done, the hits are applied in event order (and
+   * mapping order for hits caused by the same event). Input ports whose mappings control a common target are always
+   * processed by the same shard, so the targets end up the same no matter how many workers there are.
+   *
+   * Targets must stay alive as long as the engine and must not be changed by anyone else during process().
+   */
+  class ShardedEngine {
+  private:
+    std::vector<internal::Shard> shards_;
+    std::unordered_map<int, std::size_t> shardIndexByPort_;
+    std::vector<Target*> targets_;
+    std::unordered_map<Target*, std::size_t> targetIndexes_;
+    std::size_t mappingCount_ = 0;
+    std::vector<internal::ShardHit> mergedHits_;
+    // Mappings added since the last process() call, not yet assigned to a shard
+    std::vector<internal::ShardMapping> newMappings_;
+    WorkerPool workerPool_;
+  public:
+    /**
+     * Starts workerCount - 1 threads. Input ports which control a common target form a group. Groups are assigned to
+     * the shards in the order in which they are first used in addMapping(), round robin.
+     */
+    explicit ShardedEngine(std::size_t workerCount);
+
+    /**
+     * Must not be called during process(). Returns the index of the mapping.
+     */
+    std::size_t addMapping(int inputPort, SourceProcessor source, ModeProcessor mode, Target& target);
+
+    std::size_t getShardCount() const;
+
+    /**
+     * Processes the given batch of events and hits the targets. Blocks until done. Rethrows the first exception thrown
+     * while processing a shard.
+     */
+    void process(const std::vector<PortEvent>& events);
+
+  private:
+    void assignMappingsToShards();
+    void processShard(internal::Shard& shard, const std::vector<PortEvent>& events);
+    void applyHits();
+  };
+}
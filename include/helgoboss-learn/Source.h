@@ -2,6 +2,8 @@
 
 #include <rxcpp/rx.hpp>
 #include <nlohmann/json.hpp>
+#include <boost/optional.hpp>
+#include <array>
 #include <memory>
 #include <string>
 #include "SourceValue.h"
@@ -12,11 +14,14 @@
 #include "Tempo.h"
 #include <gsl/gsl>
 #include <cmath>
-#include <sstream>
 #include "SourceType.h"
 #include "SourceCharacter.h"
 #include "SourceProcessor.h"
+#include "SourceDescriptor.h"
 #include "MidiClockTransportMessageType.h"
+#include "ProcessorActivation.h"
+#include "ProcessorSync.h"
+#include "ProcessorStatistics.h"
 
 namespace helgoboss {
   class Source {
@@ -30,10 +35,19 @@ namespace helgoboss {
     ReactiveProperty<SourceCharacter> customCharacter{SourceCharacter::Range};
     ReactiveProperty<MidiClockTransportMessageType> midiClockTransportMessageType{MidiClockTransportMessageType::Start};
   private:
-    SourceProcessor processor_ = createProcessor();
+    // Built on warm-up or first use if lazy
+    mutable boost::optional<SourceProcessor> processor_;
+    internal::ProcessorSync processorSync_;
+    // Not owned, not taken over by copies
+    ProcessorStatistics* statistics_ = nullptr;
   public:
-    Source() {
+    Source() : Source(ProcessorActivation::Eager) {
+    }
+    explicit Source(ProcessorActivation activation) {
       initialize();
+      if (activation == ProcessorActivation::Eager) {
+        warmUp();
+      }
     }
     Source(const Source& other) :
         type(other.type),
@@ -45,12 +59,32 @@ namespace helgoboss {
         customCharacter(other.customCharacter),
         midiClockTransportMessageType(other.midiClockTransportMessageType),
         processor_(other.processor_) {
+      if (processor_) {
+        processor_->setStatistics(nullptr);
+      }
       initialize();
     }
     // TODO Right now move constructor will invoke copy constructor. Maybe optimize later.
-    // Default assignment is okay because object and therefore reactive properties stay the same, just not their values.
-    Source& operator=(const Source& other) = default;
-    Source& operator=(Source&& other) noexcept = default;
+    // Takes over the property values only. Statistics and activation stay as they are, so the processor is rebuilt
+    // (once) only if this source is warmed up already.
+    Source& operator=(const Source& other) {
+      if (this != &other) {
+        modifyInBatch([this, &other] {
+          type = other.type;
+          channel = other.channel;
+          is14Bit = other.is14Bit;
+          isRegistered = other.isRegistered;
+          midiMessageNumber = other.midiMessageNumber;
+          parameterNumberMessageNumber = other.parameterNumberMessageNumber;
+          customCharacter = other.customCharacter;
+          midiClockTransportMessageType = other.midiClockTransportMessageType;
+        });
+      }
+      return *this;
+    }
+    Source& operator=(Source&& other) noexcept {
+      return *this = other;
+    }
 
     //region Property support queries
 
@@ -164,103 +198,142 @@ namespace helgoboss {
     }
     void updateFromJson(const nlohmann::json& j) {
       using nlohmann::json;
-      // Important to set type first
-      {
-        const auto typeJson = j.at("type");
-        if (typeJson.type() == json::value_t::string) {
-          type.set(typeJson);
-        } else {
-          const int typeIndex = typeJson;
-          type.set(static_cast<SourceType>(typeIndex));
+      modifyInBatch([this, &j] {
+        // Important to set type first
+        {
+          const auto& typeJson = j.at("type");
+          if (typeJson.type() == json::value_t::string) {
+            type.set(typeJson);
+          } else {
+            const int typeIndex = typeJson;
+            type.set(static_cast<SourceType>(typeIndex));
+          }
         }
-      }
-      if (j.count("channel")) {
-        channel.set(j.at("channel"));
-      }
-      if (j.count("number")) {
-        const int number = j.at("number");
-        if (supportsMidiMessageNumber()) {
-          midiMessageNumber.set(number);
-        } else if (supportsParameterNumberMessageNumber()) {
-          parameterNumberMessageNumber.set(number);
+        const auto end = j.end();
+        const auto channelIt = j.find("channel");
+        if (channelIt != end) {
+          channel.set(*channelIt);
         }
-      }
-      if (j.count("character")) {
-        const auto characterJson = j.at("character");
-        if (characterJson.type() == json::value_t::string) {
-          customCharacter.set(characterJson);
-        } else {
-          const int characterIndex = characterJson;
-          customCharacter.set(static_cast<SourceCharacter>(characterIndex));
+        const auto numberIt = j.find("number");
+        if (numberIt != end) {
+          const int number = *numberIt;
+          if (supportsMidiMessageNumber()) {
+            midiMessageNumber.set(number);
+          } else if (supportsParameterNumberMessageNumber()) {
+            parameterNumberMessageNumber.set(number);
+          }
         }
-      }
-      if (j.count("isRegistered")) {
-        isRegistered.set(j.at("isRegistered"));
-      }
-      if (j.count("is14Bit")) {
-        is14Bit.set(j.at("is14Bit"));
-      }
-      if (j.count("message")) {
-        const auto messageJson = j.at("message");
-        if (messageJson.type() == json::value_t::string) {
-          midiClockTransportMessageType.set(messageJson);
-        } else {
-          const int index = messageJson;
-          midiClockTransportMessageType.set(static_cast<MidiClockTransportMessageType>(index));
+        const auto characterIt = j.find("character");
+        if (characterIt != end) {
+          if (characterIt->type() == json::value_t::string) {
+            customCharacter.set(*characterIt);
+          } else {
+            const int characterIndex = *characterIt;
+            customCharacter.set(static_cast<SourceCharacter>(characterIndex));
+          }
         }
-      }
+        const auto isRegisteredIt = j.find("isRegistered");
+        if (isRegisteredIt != end) {
+          isRegistered.set(*isRegisteredIt);
+        }
+        const auto is14BitIt = j.find("is14Bit");
+        if (is14BitIt != end) {
+          is14Bit.set(*is14BitIt);
+        }
+        const auto messageIt = j.find("message");
+        if (messageIt != end) {
+          if (messageIt->type() == json::value_t::string) {
+            midiClockTransportMessageType.set(*messageIt);
+          } else {
+            const int index = *messageIt;
+            midiClockTransportMessageType.set(static_cast<MidiClockTransportMessageType>(index));
+          }
+        }
+      });
     }
+    /**
+     * Executes the given function, which is supposed to change several properties, and updates the processor just
+     * once at the end instead of on each property change. Change notifications are still fired.
+     */
+    template<typename F>
+    void modifyInBatch(F modify) {
+      processorSync_.modifyInBatch(modify, [this] {
+        syncProcessor();
+      });
+    }
+    // Buffer size which is always enough for toString() and formatNormalizedValue()
+    static constexpr std::size_t MAX_STRING_SIZE = 64;
+
     std::string toString() const {
-      std::stringstream ss;
-      ss << getMainLabel();
+      char buffer[MAX_STRING_SIZE];
+      return std::string(buffer, toString(buffer, sizeof(buffer)));
+    }
+    /**
+     * Like toString() but writes into the given buffer without allocating memory. Returns the number of written
+     * characters (excluding the terminating null character).
+     */
+    std::size_t toString(char* buffer, std::size_t bufferSize) const {
+      util::BufferWriter writer(buffer, bufferSize);
+      writeMainLabel(writer);
       if (supportsChannel()) {
         if (channel.get() == -1) {
-          ss << "\nAny channel";
+          writer.append("\nAny channel");
         } else {
-          ss << "\nChannel " << channel.get() + 1;
+          writer.append("\nChannel ").append(channel.get() + 1);
         }
       }
       switch (type.get()) {
         case SourceType::NoteVelocity:
         case SourceType::PolyphonicKeyPressureAmount:
           if (midiMessageNumber.get() == -1) {
-            ss << "\nAny note";
+            writer.append("\nAny note");
           } else {
-            ss << "\nNote number " << midiMessageNumber.get();
+            writer.append("\nNote number ").append(midiMessageNumber.get());
           }
           break;
         case SourceType::ControlChangeValue:
           if (midiMessageNumber.get() == -1) {
-            ss << "\nAny CC";
+            writer.append("\nAny CC");
           } else {
-            ss << "\nCC number " << midiMessageNumber.get();
+            writer.append("\nCC number ").append(midiMessageNumber.get());
           }
           break;
         case SourceType::ParameterNumberMessageValue:
-          ss << "\nNumber " << parameterNumberMessageNumber.get();
+          writer.append("\nNumber ").append(parameterNumberMessageNumber.get());
           break;
         default:
           break;
       }
-      return ss.str();
+      return writer.getSize();
     }
     std::string formatNormalizedValue(double normalizedValue) const {
+      char buffer[MAX_STRING_SIZE];
+      return std::string(buffer, formatNormalizedValue(normalizedValue, buffer, sizeof(buffer)));
+    }
+    /**
+     * Like formatNormalizedValue() but writes into the given buffer. Doesn't allocate memory as long as the processor
+     * has been built already (see warmUp()).
+     */
+    std::size_t formatNormalizedValue(double normalizedValue, char* buffer, std::size_t bufferSize) const {
+      util::BufferWriter writer(buffer, bufferSize);
       switch (type.get()) {
         case SourceType::ClockTempo:
-          return util::toString(8, [normalizedValue](char* buffer, int maxSize) {
-            sprintf(buffer, "%.2f", Tempo::ofNormalizedValue(normalizedValue).bpm());
-          });
+          writer.appendFixed(Tempo::ofNormalizedValue(normalizedValue).bpm(), 2);
+          break;
         case SourceType::ClockTransport:
-          return "1";
+          writer.append("1");
+          break;
         default:
-          return std::to_string(makeDiscrete(normalizedValue));
+          writer.append(makeDiscrete(normalizedValue));
+          break;
       }
+      return writer.getSize();
     }
     double normalizeDiscreteValue(double discreteValue) const {
       return util::mapValueInRangeToNormalizedValue(
           discreteValue,
-          processor_.getMinDiscreteValue(),
-          processor_.getMaxDiscreteValue()
+          getMinDiscreteValue(),
+          getMaxDiscreteValue()
       );
     }
     void updateFromMidiMessage(const MidiMessage& msg) {
@@ -289,34 +362,36 @@ namespace helgoboss {
       midiMessageNumber.set(msg.getMsbControllerNumber());
       is14Bit.set(true);
     }
+    void updateFromDescriptor(const SourceDescriptor& descriptor) {
+      type.set(descriptor.type);
+      channel.set(descriptor.channel);
+      is14Bit.set(descriptor.is14Bit);
+      isRegistered.set(descriptor.isRegistered);
+      midiMessageNumber.set(descriptor.midiMessageNumber);
+      parameterNumberMessageNumber.set(descriptor.parameterNumberMessageNumber);
+      customCharacter.set(descriptor.customCharacter);
+      midiClockTransportMessageType.set(descriptor.midiClockTransportMessageType);
+    }
+    SourceDescriptor toDescriptor() const {
+      SourceDescriptor descriptor;
+      descriptor.type = type.get();
+      descriptor.channel = channel.get();
+      descriptor.is14Bit = is14Bit.get();
+      descriptor.isRegistered = isRegistered.get();
+      descriptor.midiMessageNumber = midiMessageNumber.get();
+      descriptor.parameterNumberMessageNumber = parameterNumberMessageNumber.get();
+      descriptor.customCharacter = customCharacter.get();
+      descriptor.midiClockTransportMessageType = midiClockTransportMessageType.get();
+      return descriptor;
+    }
     bool equals(const Source& rhs, bool ignoreCustomCharacter, bool ignoreChannel) const {
-      if (type != rhs.type) {
-        return false;
-      }
-      switch (type.get()) {
-        case SourceType::ControlChangeValue:
-          return (ignoreChannel || channel == rhs.channel) && midiMessageNumber == rhs.midiMessageNumber
-              && is14Bit == rhs.is14Bit
-              && (is14Bit.get() || (ignoreCustomCharacter || customCharacter == rhs.customCharacter));
-        case SourceType::NoteVelocity:
-        case SourceType::PolyphonicKeyPressureAmount:
-          return (ignoreChannel || channel == rhs.channel) && midiMessageNumber == rhs.midiMessageNumber;
-        case SourceType::NoteKeyNumber:
-        case SourceType::PitchBendChangeValue:
-        case SourceType::ChannelPressureAmount:
-        case SourceType::ProgramChangeNumber:
-          return (ignoreChannel || channel == rhs.channel);
-        case SourceType::ParameterNumberMessageValue:
-          return (ignoreChannel || channel == rhs.channel)
-              && parameterNumberMessageNumber == rhs.parameterNumberMessageNumber && is14Bit == rhs.is14Bit
-              && isRegistered == rhs.isRegistered;
-        case SourceType::ClockTempo:
-          return true;
-        case SourceType::ClockTransport:
-          return midiClockTransportMessageType == rhs.midiClockTransportMessageType;
-        default:
-          return false;
-      }
+      return internal::sourceIdentitiesAreEqual(getIdentity(), rhs.getIdentity(), ignoreCustomCharacter, ignoreChannel);
+    }
+    /**
+     * Consistent with equals() given the same flags, so equal sources have equal hashes.
+     */
+    std::size_t hash(bool ignoreCustomCharacter, bool ignoreChannel) const {
+      return internal::hashSourceIdentity(getIdentity(), ignoreCustomCharacter, ignoreChannel);
     }
     friend bool operator==(const Source& lhs, const Source& rhs) {
       return lhs.equals(rhs, false, false);
@@ -327,8 +402,60 @@ namespace helgoboss {
     //endregion
 
     //region Processing
+    /**
+     * Builds the processor if this source has been created with lazy activation and the processor hasn't been needed
+     * yet. Otherwise the first call of getProcessor() does it. Must not be called concurrently with other methods of
+     * this source.
+     */
+    void warmUp() const {
+      if (!processor_) {
+        processor_ = createProcessor();
+      }
+    }
+
+    bool isWarmedUp() const {
+      return processor_.has_value();
+    }
+
+    /**
+     * Builds a new processor from the current property values. In contrast to getProcessor(), this also reflects changes
+     * made within a batch (see modifyInBatch()) which is still in progress.
+     */
+    SourceProcessor createProcessor() const {
+      SourceProcessor processor(
+          type.get(),
+          channel.get(),
+          is14Bit.get(),
+          isRegistered.get(),
+          supportsMidiMessageNumber() ? midiMessageNumber.get() : parameterNumberMessageNumber.get(),
+          customCharacter.get(),
+          midiClockTransportMessageType.get()
+      );
+      processor.setStatistics(statistics_);
+      return processor;
+    }
+
+    /**
+     * Warms this source up first if it hasn't been used yet (see warmUp()).
+     */
     const SourceProcessor& getProcessor() const {
-      return processor_;
+      warmUp();
+      return *processor_;
+    }
+
+    /**
+     * Attaches statistics which from now on count matched events and sent feedback messages. Pass nullptr to detach.
+     * The statistics must outlive this source or be detached before they are destroyed.
+     */
+    void setStatistics(ProcessorStatistics* statistics) {
+      statistics_ = statistics;
+      if (processor_) {
+        processor_->setStatistics(statistics);
+      }
+    }
+
+    ProcessorStatistics* getStatistics() const {
+      return statistics_;
     }
 
     template<typename SourceContext>
@@ -345,32 +472,32 @@ namespace helgoboss {
       }
       switch (type.get()) {
         case SourceType::NoteVelocity: {
-          context.processMidiFeedback(this,
+          sendFeedback(context,
               MidiMessage::noteOn(channel.get(), midiMessageNumber.get(), makeDiscrete(normalizedTargetValue)));
           break;
         }
         case SourceType::NoteKeyNumber: {
-          context.processMidiFeedback(this,
+          sendFeedback(context,
               MidiMessage::noteOn(channel.get(), makeDiscrete(normalizedTargetValue), 127));
           break;
         }
         case SourceType::ProgramChangeNumber: {
-          context.processMidiFeedback(this,
+          sendFeedback(context,
               MidiMessage::programChange(channel.get(), makeDiscrete(normalizedTargetValue)));
           break;
         }
         case SourceType::PitchBendChangeValue: {
-          context.processMidiFeedback(this,
+          sendFeedback(context,
               MidiMessage::pitchBendChange(channel.get(), makeDiscrete(normalizedTargetValue)));
           break;
         }
         case SourceType::ChannelPressureAmount: {
-          context.processMidiFeedback(this,
+          sendFeedback(context,
               MidiMessage::channelPressure(channel.get(), makeDiscrete(normalizedTargetValue)));
           break;
         }
         case SourceType::PolyphonicKeyPressureAmount: {
-          context.processMidiFeedback(this,
+          sendFeedback(context,
               MidiMessage::polyphonicKeyPressure(channel.get(),
                   midiMessageNumber.get(),
                   makeDiscrete(normalizedTargetValue)));
@@ -380,10 +507,10 @@ namespace helgoboss {
           if (is14Bit.get()) {
             const auto midi14BitMsg =
                 Midi14BitCcMessage(channel.get(), midiMessageNumber.get(), makeDiscrete(normalizedTargetValue));
-            context.processMidiFeedbackTwo(this, midi14BitMsg.buildMidiMessages());
+            sendFeedbackTwo(context, midi14BitMsg.buildMidiMessages());
           } else {
-            context.processMidiFeedback(
-                this,
+            sendFeedback(
+                context,
                 MidiMessage::controlChange(channel.get(), midiMessageNumber.get(), determine7BitCcFeedbackValue(normalizedTargetValue))
             );
           }
@@ -396,6 +523,31 @@ namespace helgoboss {
     //endregion
 
   private:
+    // Unlike getProcessor(), these don't warm up, so UI code doesn't activate the sources it displays
+    double getMinDiscreteValue() const {
+      return processor_ ? processor_->getMinDiscreteValue() : createProcessor().getMinDiscreteValue();
+    }
+
+    double getMaxDiscreteValue() const {
+      return processor_ ? processor_->getMaxDiscreteValue() : createProcessor().getMaxDiscreteValue();
+    }
+
+    template<typename SourceContext>
+    void sendFeedback(SourceContext& context, const MidiMessage& message) {
+      context.processMidiFeedback(this, message);
+      if (statistics_ != nullptr) {
+        statistics_->countFeedbackMessages(1);
+      }
+    }
+
+    template<typename SourceContext>
+    void sendFeedbackTwo(SourceContext& context, const std::array<MidiMessage, 2>& messages) {
+      context.processMidiFeedbackTwo(this, messages);
+      if (statistics_ != nullptr) {
+        statistics_->countFeedbackMessages(2);
+      }
+    }
+
     int determine7BitCcFeedbackValue(double normalizedTargetValue) const {
       switch (customCharacter.get()) {
         case SourceCharacter::Encoder1:
@@ -416,62 +568,91 @@ namespace helgoboss {
       // center is 0.
       return static_cast<int>(std::ceil(util::mapNormalizedValueToValueInRange(
           normalizedValue,
-          processor_.getMinDiscreteValue(),
-          processor_.getMaxDiscreteValue()
+          getMinDiscreteValue(),
+          getMaxDiscreteValue()
       )));
     }
-    std::string getMainLabel() const {
+    // Same number choice as createProcessor()
+    internal::SourceIdentity getIdentity() const {
+      return {
+          type.get(),
+          channel.get(),
+          supportsMidiMessageNumber() ? midiMessageNumber.get() : parameterNumberMessageNumber.get(),
+          is14Bit.get(),
+          isRegistered.get(),
+          customCharacter.get(),
+          midiClockTransportMessageType.get()
+      };
+    }
+    void writeMainLabel(util::BufferWriter& writer) const {
       switch (type.get()) {
         case SourceType::ControlChangeValue:
-          return "CC value";
+          writer.append("CC value");
+          break;
         case SourceType::NoteVelocity:
-          return "Note velocity";
+          writer.append("Note velocity");
+          break;
         case SourceType::NoteKeyNumber:
-          return "Note number";
+          writer.append("Note number");
+          break;
         case SourceType::PitchBendChangeValue:
-          return "Pitch wheel";
+          writer.append("Pitch wheel");
+          break;
         case SourceType::ChannelPressureAmount:
-          return "Channel after touch";
+          writer.append("Channel after touch");
+          break;
         case SourceType::ProgramChangeNumber:
-          return "Program change";
+          writer.append("Program change");
+          break;
         case SourceType::ParameterNumberMessageValue:
-          return isRegistered.get() ? "RPN" : "NRPN";
+          writer.append(isRegistered.get() ? "RPN" : "NRPN");
+          break;
         case SourceType::PolyphonicKeyPressureAmount:
-          return "Poly after touch";
+          writer.append("Poly after touch");
+          break;
         case SourceType::ClockTempo:
-          return "MIDI clock\nTempo";
+          writer.append("MIDI clock\nTempo");
+          break;
         case SourceType::ClockTransport:
-          return std::string("MIDI clock\n")
-              + util::getMidiClockTransportMessageTypeLabel(midiClockTransportMessageType.get());
+          writer.append("MIDI clock\n")
+              .append(internal::getMidiClockTransportMessageTypeLabel(midiClockTransportMessageType.get()));
+          break;
         default:
-          return util::getSourceTypeListEntryLabel(type.get());
+          // Not reached for the current source types, so allocating doesn't matter
+          writer.append(util::getSourceTypeListEntryLabel(type.get()));
+          break;
       }
     }
 
-    SourceProcessor createProcessor() const {
-      return SourceProcessor(
-          type.get(),
-          channel.get(),
-          is14Bit.get(),
-          isRegistered.get(),
-          supportsMidiMessageNumber() ? midiMessageNumber.get() : parameterNumberMessageNumber.get(),
-          customCharacter.get(),
-          midiClockTransportMessageType.get()
-      );
-    }
-
     void initialize() {
       keepProcessorInSync();
     }
 
     void keepProcessorInSync() {
       changed().subscribe([this](bool) {
-        processor_ = createProcessor();
+        if (!processorSync_.isSuspended()) {
+          syncProcessor();
+        }
       });
     }
 
+    void syncProcessor() {
+      if (isWarmedUp()) {
+        processor_ = createProcessor();
+      }
+    }
+
   };
 
   void to_json(nlohmann::json& j, const Source& o);
   void from_json(const nlohmann::json& j, Source& o);
+}
+
+namespace std {
+  template<>
+  struct hash<helgoboss::Source> {
+    std::size_t operator()(const helgoboss::Source& source) const {
+      return source.hash(false, false);
+    }
+  };
 }
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <boost/optional.hpp>
+#include "SourceCharacter.h"
+
+namespace helgoboss {
+  struct SourceCharacterGuess {
+    SourceCharacter character;
+    // From 0 (no evidence at all) to 1 (conclusive)
+    double confidence;
+  };
+
+  /**
+   * Guesses the character of a CC source while its values come in, one at a time.
+   *
+   * At any point, guess() returns the same character as util::guessSourceCharacter() would return for all values
+   * fed so far. In addition, feed() reports as soon as the evidence is conclusive, so learning doesn't need to wait
+   * for a fixed number of messages or a timeout in the common cases:
+   *
+   * - Encoder: Repeated values or direction changes have been seen ENCODER_EVIDENCE_THRESHOLD times.
+   * - Range: The values have moved into the same direction in small steps RANGE_EVIDENCE_THRESHOLD times in a row.
+   * - Switch: A value far away from zero has been followed by zero (pressed and released).
+   */
+  class SourceCharacterClassifier {
+  public:
+    static constexpr int ENCODER_EVIDENCE_THRESHOLD = 3;
+    static constexpr int RANGE_EVIDENCE_THRESHOLD = 4;
+    // Steps larger than this are not considered as evidence for a knob or fader
+    static constexpr int MAX_RANGE_STEP = 16;
+  private:
+    enum class Direction {
+      Decrement,
+      None,
+      Increment
+    };
+    int valueCount_ = 0;
+    int firstValue_ = 0;
+    int previousValue_ = 0;
+    Direction previousDirection_ = Direction::None;
+    bool continuityIsBroken_ = false;
+    int encoderEvidenceCount_ = 0;
+    int rangeEvidenceCount_ = 0;
+  public:
+    /**
+     * Feeds the next CC value. Returns a guess as soon as the evidence is conclusive.
+     */
+    boost::optional<SourceCharacterGuess> feed(int controlValue);
+
+    /**
+     * Returns the best guess based on the values fed so far. Good for deciding after a timeout.
+     */
+    SourceCharacterGuess guess() const;
+
+    int getValueCount() const;
+
+    void reset();
+  private:
+    bool isConclusive() const;
+    SourceCharacter guessEncoderType() const;
+    static Direction determineDirection(int firstValue, int secondValue);
+  };
+}
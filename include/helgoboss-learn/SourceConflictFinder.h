@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "Source.h"
+
+namespace helgoboss {
+  // Two sources which react to at least one common message. firstIndex < secondIndex.
+  struct SourceOverlap {
+    std::size_t firstIndex;
+    std::size_t secondIndex;
+
+    friend bool operator==(const SourceOverlap& lhs, const SourceOverlap& rhs) {
+      return lhs.firstIndex == rhs.firstIndex && lhs.secondIndex == rhs.secondIndex;
+    }
+  };
+
+  /**
+   * Finds duplicate and overlapping sources in a set of mappings without comparing each source with each other. The
+   * sources are indexed once on construction, so the cost of a query depends on the number of sources involved in
+   * conflicts rather than on the total number of sources.
+   *
+   * Sources are referred to by their index in the vector given on construction. They must not be changed as long as
+   * the finder is used.
+   */
+  class SourceConflictFinder {
+  private:
+    struct OverlapKey {
+      int kind;
+      // -1 means any
+      int channel;
+      // -1 means any
+      int number;
+    };
+
+    const std::vector<const Source*> sources_;
+    std::vector<OverlapKey> overlapKeys_;
+    // Different views on the overlap keys, all mapping to source indexes
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> indexesByKey_;
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> indexesByKindAndChannel_;
+    std::unordered_map<std::uint64_t, std::vector<std::size_t>> indexesByKindAndNumber_;
+    std::unordered_map<int, std::vector<std::size_t>> indexesByKind_;
+  public:
+    explicit SourceConflictFinder(std::vector<const Source*> sources);
+
+    /**
+     * Returns groups of sources which are equal according to Source::equals() with the given flags. Each group has at
+     * least two sources and is sorted. Groups are ordered by their first index.
+     */
+    std::vector<std::vector<std::size_t>> findDuplicates(bool ignoreCustomCharacter, bool ignoreChannel) const;
+
+    /**
+     * Returns all pairs of sources which react to at least one common message, taking "any channel" and "any number"
+     * into account. Duplicates are overlaps as well. Ordered by first and then second index.
+     */
+    std::vector<SourceOverlap> findOverlaps() const;
+
+    /**
+     * Returns the indexes of all sources which react to at least one message the given source reacts to, in ascending
+     * order. Good for checking a new source before adding it.
+     */
+    std::vector<std::size_t> findOverlapsWith(const Source& source) const;
+
+  private:
+    static OverlapKey getOverlapKey(const Source& source);
+    template<typename Consumer>
+    void forEachOverlappingIndex(const OverlapKey& key, Consumer consumer) const;
+  };
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <type_traits>
+#include <helgoboss-midi/MidiMessage.h>
+#include <helgoboss-midi/Midi14BitCcMessage.h>
+#include <helgoboss-midi/MidiParameterNumberMessage.h>
+#include "SourceType.h"
+#include "SourceCharacter.h"
+#include "MidiClockTransportMessageType.h"
+
+namespace helgoboss {
+  /**
+   * Plain description of a source, e.g. a learn candidate.
+   *
+   * In contrast to Source it doesn't have reactive properties, subscriptions or a processor, so it's trivially
+   * copyable and cheap enough to be created for each incoming MIDI message. Use Source::updateFromDescriptor() to
+   * materialize it as soon as it's actually needed.
+   */
+  struct SourceDescriptor {
+    SourceType type = SourceType::ControlChangeValue;
+    int channel = 0;
+    bool is14Bit = false;
+    bool isRegistered = false;
+    int midiMessageNumber = 0;
+    int parameterNumberMessageNumber = 0;
+    SourceCharacter customCharacter = SourceCharacter::Range;
+    MidiClockTransportMessageType midiClockTransportMessageType = MidiClockTransportMessageType::Start;
+
+    friend bool operator==(const SourceDescriptor& lhs, const SourceDescriptor& rhs) {
+      return lhs.type == rhs.type
+          && lhs.channel == rhs.channel
+          && lhs.is14Bit == rhs.is14Bit
+          && lhs.isRegistered == rhs.isRegistered
+          && lhs.midiMessageNumber == rhs.midiMessageNumber
+          && lhs.parameterNumberMessageNumber == rhs.parameterNumberMessageNumber
+          && lhs.customCharacter == rhs.customCharacter
+          && lhs.midiClockTransportMessageType == rhs.midiClockTransportMessageType;
+    }
+    friend bool operator!=(const SourceDescriptor& lhs, const SourceDescriptor& rhs) {
+      return !(rhs == lhs);
+    }
+  };
+
+  static_assert(std::is_trivially_copyable<SourceDescriptor>::value, "SourceDescriptor must stay trivially copyable");
+
+  namespace util {
+    // The following functions describe the same source as a default Source which has been updated with the
+    // corresponding Source::updateFrom...() method
+    SourceDescriptor describeSourceOfMidiMessage(const MidiMessage& msg);
+    SourceDescriptor describeSourceOfMidiParameterNumberMessage(const MidiParameterNumberMessage& msg);
+    SourceDescriptor describeSourceOfMidi14BitCcMessage(const Midi14BitCcMessage& msg);
+  }
+}
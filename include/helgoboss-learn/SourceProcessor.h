@@ -6,8 +6,125 @@
 #include "SourceValue.h"
 #include "MidiClockTransportMessageType.h"
 #include "math-util.h"
+#include "fixed-point-util.h"
+#include "ProcessorStatistics.h"
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <boost/optional.hpp>
 
 namespace helgoboss {
+  namespace internal {
+    constexpr std::array<double, 128> createSevenBitNormalizedValues() {
+      std::array<double, 128> values{};
+      for (int i = 0; i < 128; i++) {
+        values[i] = util::mapValueInRangeToNormalizedValue(i, 0, 127);
+      }
+      return values;
+    }
+
+    // Normalized values of all possible 7-bit MIDI data bytes
+    inline constexpr std::array<double, 128> SEVEN_BIT_NORMALIZED_VALUES = createSevenBitNormalizedValues();
+
+    static_assert(SEVEN_BIT_NORMALIZED_VALUES[0] == 0.0 && SEVEN_BIT_NORMALIZED_VALUES[127] == 1.0);
+
+    // Same as boost::hash_combine
+    template<typename T>
+    std::size_t combineHash(std::size_t seed, const T& value) {
+      return seed ^ (std::hash<T>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+    }
+
+    /**
+     * The properties which make up the identity of a source. Source and SourceProcessor compare and hash this, so both
+     * have the same semantics. The number is the MIDI message number or the parameter number, depending on the type.
+     */
+    struct SourceIdentity {
+      SourceType type;
+      int channel;
+      int number;
+      bool is14Bit;
+      bool isRegistered;
+      SourceCharacter customCharacter;
+      MidiClockTransportMessageType midiClockTransportMessageType;
+    };
+
+    // Only compares what's relevant for the type
+    inline bool sourceIdentitiesAreEqual(const SourceIdentity& lhs, const SourceIdentity& rhs,
+        bool ignoreCustomCharacter, bool ignoreChannel) {
+      if (lhs.type != rhs.type) {
+        return false;
+      }
+      const bool channelIsEqual = ignoreChannel || lhs.channel == rhs.channel;
+      switch (lhs.type) {
+        case SourceType::ControlChangeValue:
+          return channelIsEqual && lhs.number == rhs.number && lhs.is14Bit == rhs.is14Bit
+              && (lhs.is14Bit || ignoreCustomCharacter || lhs.customCharacter == rhs.customCharacter);
+        case SourceType::NoteVelocity:
+        case SourceType::PolyphonicKeyPressureAmount:
+          return channelIsEqual && lhs.number == rhs.number;
+        case SourceType::NoteKeyNumber:
+        case SourceType::PitchBendChangeValue:
+        case SourceType::ChannelPressureAmount:
+        case SourceType::ProgramChangeNumber:
+          return channelIsEqual;
+        case SourceType::ParameterNumberMessageValue:
+          return channelIsEqual && lhs.number == rhs.number && lhs.is14Bit == rhs.is14Bit
+              && lhs.isRegistered == rhs.isRegistered;
+        case SourceType::ClockTempo:
+          return true;
+        case SourceType::ClockTransport:
+          return lhs.midiClockTransportMessageType == rhs.midiClockTransportMessageType;
+        default:
+          return false;
+      }
+    }
+
+    // Consistent with sourceIdentitiesAreEqual() given the same flags
+    inline std::size_t hashSourceIdentity(const SourceIdentity& identity, bool ignoreCustomCharacter,
+        bool ignoreChannel) {
+      auto h = std::hash<int>()(static_cast<int>(identity.type));
+      const int channel = ignoreChannel ? 0 : identity.channel;
+      switch (identity.type) {
+        case SourceType::ControlChangeValue:
+          h = combineHash(h, channel);
+          h = combineHash(h, identity.number);
+          h = combineHash(h, identity.is14Bit);
+          if (!identity.is14Bit && !ignoreCustomCharacter) {
+            h = combineHash(h, static_cast<int>(identity.customCharacter));
+          }
+          break;
+        case SourceType::NoteVelocity:
+        case SourceType::PolyphonicKeyPressureAmount:
+          h = combineHash(h, channel);
+          h = combineHash(h, identity.number);
+          break;
+        case SourceType::NoteKeyNumber:
+        case SourceType::PitchBendChangeValue:
+        case SourceType::ChannelPressureAmount:
+        case SourceType::ProgramChangeNumber:
+          h = combineHash(h, channel);
+          break;
+        case SourceType::ParameterNumberMessageValue:
+          h = combineHash(h, channel);
+          h = combineHash(h, identity.number);
+          h = combineHash(h, identity.is14Bit);
+          h = combineHash(h, identity.isRegistered);
+          break;
+        case SourceType::ClockTransport:
+          h = combineHash(h, static_cast<int>(identity.midiClockTransportMessageType));
+          break;
+        default:
+          break;
+      }
+      return h;
+    }
+
+    constexpr double normalizeSevenBitValue(int value) {
+      return value >= 0 && value < 128 ? SEVEN_BIT_NORMALIZED_VALUES[value]
+          : util::mapValueInRangeToNormalizedValue(value, 0, 127);
+    }
+  }
+
   class SourceProcessor {
   private:
     SourceType type_ = SourceType::ControlChangeValue;
@@ -17,6 +134,8 @@ namespace helgoboss {
     int number_ = 0;
     SourceCharacter customCharacter_ = SourceCharacter::Range;
     MidiClockTransportMessageType midiClockTransportMessageType_ = MidiClockTransportMessageType::Start;
+    // Not owned
+    ProcessorStatistics* statistics_ = nullptr;
   public:
     SourceProcessor() = default;
     SourceProcessor(
@@ -53,12 +172,12 @@ namespace helgoboss {
             return 0.0;
           } else {
             // Note on
-            return msg.getVelocity() / 127.0;
+            return internal::normalizeSevenBitValue(msg.getVelocity());
           }
         }
         case SourceType::NoteKeyNumber: {
           const auto& msg = value.getAsMidiMessage();
-          return msg.getKeyNumber() / 127.0;
+          return internal::normalizeSevenBitValue(msg.getKeyNumber());
         }
         case SourceType::PitchBendChangeValue: {
           const auto& msg = value.getAsMidiMessage();
@@ -66,18 +185,15 @@ namespace helgoboss {
         }
         case SourceType::ChannelPressureAmount: {
           const auto& msg = value.getAsMidiMessage();
-          return util::mapValueInRangeToNormalizedValue(
-              msg.getPressureAmount(), getMinDiscreteValue(), getMaxDiscreteValue());
+          return internal::normalizeSevenBitValue(msg.getPressureAmount());
         }
         case SourceType::PolyphonicKeyPressureAmount: {
           const auto& msg = value.getAsMidiMessage();
-          return util::mapValueInRangeToNormalizedValue(
-              msg.getPressureAmount(), getMinDiscreteValue(), getMaxDiscreteValue());
+          return internal::normalizeSevenBitValue(msg.getPressureAmount());
         }
         case SourceType::ProgramChangeNumber: {
           const auto& msg = value.getAsMidiMessage();
-          return util::mapValueInRangeToNormalizedValue(
-              msg.getProgramNumber(), getMinDiscreteValue(), getMaxDiscreteValue());
+          return internal::normalizeSevenBitValue(msg.getProgramNumber());
         }
         case SourceType::ClockTransport: {
           return 1.0;
@@ -96,7 +212,63 @@ namespace helgoboss {
       }
     }
 
-    bool processes(const SourceValue& value) const {
+    /**
+     * Like getNormalizedValue() but in fixed-point format and computed with integer arithmetic only. Returns none for
+     * sources which don't emit 7-bit or 14-bit absolute values (encoders, MIDI clock).
+     *
+     * In contrast to getNormalizedValue(), the center position of pitch bend is mapped to exactly 0.5. Other pitch bend
+     * values therefore deviate from getNormalizedValue() by up to 2 fixed-point units.
+     */
+    boost::optional<util::FixedPointValue> getFixedPointValue(const SourceValue& value) const {
+      switch (type_) {
+        case SourceType::ControlChangeValue: {
+          if (is14Bit_) {
+            const auto& msg = value.getAsMidi14BitCcMessage();
+            return util::mapDiscreteValueToFixedPoint(msg.getValue(), 16383);
+          }
+          if (emitsStepCounts()) {
+            return boost::none;
+          }
+          const auto& msg = value.getAsMidiMessage();
+          return util::mapDiscreteValueToFixedPoint(msg.getControlValue(), 127);
+        }
+        case SourceType::NoteVelocity: {
+          const auto& msg = value.getAsMidiMessage();
+          if (msg.getType() == MidiMessageType::NoteOff) {
+            return 0;
+          }
+          return util::mapDiscreteValueToFixedPoint(msg.getVelocity(), 127);
+        }
+        case SourceType::NoteKeyNumber: {
+          const auto& msg = value.getAsMidiMessage();
+          return util::mapDiscreteValueToFixedPoint(msg.getKeyNumber(), 127);
+        }
+        case SourceType::PitchBendChangeValue: {
+          const auto& msg = value.getAsMidiMessage();
+          return util::mapDiscreteValueToFixedPoint(msg.getPitchBendValue(), 16383, true);
+        }
+        case SourceType::ChannelPressureAmount:
+        case SourceType::PolyphonicKeyPressureAmount: {
+          const auto& msg = value.getAsMidiMessage();
+          return util::mapDiscreteValueToFixedPoint(msg.getPressureAmount(), 127);
+        }
+        case SourceType::ProgramChangeNumber: {
+          const auto& msg = value.getAsMidiMessage();
+          return util::mapDiscreteValueToFixedPoint(msg.getProgramNumber(), 127);
+        }
+        case SourceType::ParameterNumberMessageValue: {
+          const auto& msg = value.getAsMidiParameterNumberMessage();
+          return util::mapDiscreteValueToFixedPoint(msg.getValue(), getNumPossibleValues() - 1);
+        }
+        default:
+          return boost::none;
+      }
+    }
+
+    /**
+     * Returns whether this source reacts to the given value. Unlike processes(), this doesn't count anything.
+     */
+    bool matches(const SourceValue& value) const {
       switch (type_) {
         case SourceType::NoteVelocity: {
           if (value.getType() != SourceValueType::MidiMessage) {
@@ -179,6 +351,29 @@ namespace helgoboss {
       }
     }
 
+    /**
+     * Like matches() but also counts a match in the attached statistics (see setStatistics()). That's a side effect, so
+     * call it exactly once per incoming event and mapping.
+     */
+    bool processes(const SourceValue& value) const {
+      const bool isMatch = matches(value);
+      if (isMatch && statistics_ != nullptr) {
+        statistics_->countMatchedEvent();
+      }
+      return isMatch;
+    }
+
+    /**
+     * Makes processes() count matched events in the given statistics. Pass nullptr to stop counting.
+     */
+    void setStatistics(ProcessorStatistics* statistics) {
+      statistics_ = statistics;
+    }
+
+    ProcessorStatistics* getStatistics() const {
+      return statistics_;
+    }
+
     // Only has to be implemented for sources whose events are composed of multiple MIDI messages
     bool consumes(const MidiMessage& msg) const {
       switch (type_) {
@@ -226,7 +421,7 @@ namespace helgoboss {
     double getMinDiscreteValue() const {
       switch (type_) {
         case SourceType::ClockTempo:
-          return 1.0;
+          return Tempo::MIN_BPM;
         default:
           return isCentered() ? -getNumPossibleValues() / 2 : 0;
       }
@@ -234,12 +429,33 @@ namespace helgoboss {
     double getMaxDiscreteValue() const {
       switch (type_) {
         case SourceType::ClockTempo:
-          return 960.0;
+          return Tempo::MAX_BPM;
         default:
           return isCentered() ? getNumPossibleValues() / 2 - 1 : getNumPossibleValues() - 1;
       }
     }
 
+    /**
+     * Same semantics as Source::equals(), so only compares what's relevant for the type.
+     */
+    bool equals(const SourceProcessor& rhs, bool ignoreCustomCharacter, bool ignoreChannel) const {
+      return internal::sourceIdentitiesAreEqual(getIdentity(), rhs.getIdentity(), ignoreCustomCharacter, ignoreChannel);
+    }
+
+    /**
+     * Consistent with equals() given the same flags, so equal processors have equal hashes.
+     */
+    std::size_t hash(bool ignoreCustomCharacter, bool ignoreChannel) const {
+      return internal::hashSourceIdentity(getIdentity(), ignoreCustomCharacter, ignoreChannel);
+    }
+
+    friend bool operator==(const SourceProcessor& lhs, const SourceProcessor& rhs) {
+      return lhs.equals(rhs, false, false);
+    }
+    friend bool operator!=(const SourceProcessor& lhs, const SourceProcessor& rhs) {
+      return !(rhs == lhs);
+    }
+
   private:
     bool channelMatches(const MidiMessage& msg) const {
       return channelMatches(msg.getChannel());
@@ -297,10 +513,13 @@ namespace helgoboss {
         }
         default: {
           // Absolute
-          return controlValue / 127.0;
+          return internal::normalizeSevenBitValue(controlValue);
         }
       }
     }
+    internal::SourceIdentity getIdentity() const {
+      return {type_, channel_, number_, is14Bit_, isRegistered_, customCharacter_, midiClockTransportMessageType_};
+    }
     bool isCentered() const {
       switch (type_) {
         case SourceType::PitchBendChangeValue:
@@ -344,4 +563,13 @@ namespace helgoboss {
       }
     }
   };
+}
+
+namespace std {
+  template<>
+  struct hash<helgoboss::SourceProcessor> {
+    std::size_t operator()(const helgoboss::SourceProcessor& processor) const {
+      return processor.hash(false, false);
+    }
+  };
 }
\ No newline at end of file
@@ -1,18 +1,38 @@
 #pragma once
 
+#include <algorithm>
+#include <cstddef>
 #include <string>
+#include "math-util.h"
 
 namespace helgoboss {
   class Tempo {
+  public:
+    static constexpr double MIN_BPM = 1.0;
+    static constexpr double MAX_BPM = 960.0;
   private:
     double bpm_;
   public:
-    static Tempo ofNormalizedValue(double normalizedValue);
-    explicit Tempo(double bpm);
-    double normalizedValue() const;
-    double bpm() const;
+    static constexpr Tempo ofNormalizedValue(double normalizedValue) {
+      return Tempo(util::mapNormalizedValueToValueInRange(normalizedValue, MIN_BPM, MAX_BPM));
+    }
+
+    constexpr explicit Tempo(double bpm) : bpm_(std::max(MIN_BPM, std::min(MAX_BPM, bpm))) {
+    }
+
+    constexpr double normalizedValue() const {
+      return util::mapValueInRangeToNormalizedValue(bpm_, MIN_BPM, MAX_BPM);
+    }
+
+    constexpr double bpm() const {
+      return bpm_;
+    }
+
     std::string toString() const;
     std::string toStringWithoutUnit() const;
+    // Allocation-free variants which write into the given buffer and return the number of written characters
+    std::size_t toString(char* buffer, std::size_t bufferSize) const;
+    std::size_t toStringWithoutUnit(char* buffer, std::size_t bufferSize) const;
   };
 }
 
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace helgoboss {
+  /**
+   * Fixed set of threads which run one job at a time, together with the calling thread. Used by the engines which
+   * process mappings in parallel.
+   */
+  class WorkerPool {
+  public:
+    // Gets the index of the worker which runs it (0 is the calling thread)
+    using Job = std::function<void(std::size_t workerIndex)>;
+  private:
+    std::vector<std::thread> threads_;
+    std::vector<std::exception_ptr> errors_;
+    const Job* currentJob_ = nullptr;
+    std::mutex mutex_;
+    std::condition_variable jobStarted_;
+    std::condition_variable jobFinished_;
+    std::uint64_t jobNumber_ = 0;
+    std::size_t busyThreadCount_ = 0;
+    bool stopped_ = false;
+  public:
+    /**
+     * Starts workerCount - 1 threads. If starting one of them fails, the ones already started are stopped again before
+     * the exception is passed on.
+     */
+    explicit WorkerPool(std::size_t workerCount);
+    WorkerPool(const WorkerPool& other) = delete;
+    WorkerPool& operator=(const WorkerPool& other) = delete;
+    ~WorkerPool();
+
+    std::size_t getWorkerCount() const;
+
+    /**
+     * Runs the given job on all workers and blocks until all of them are done. Rethrows the exception of the worker
+     * with the lowest index if any threw. Must not be called concurrently.
+     */
+    void run(const Job& job);
+
+  private:
+    void stopThreads();
+    void runThread(std::size_t workerIndex);
+    void runJob(const Job& job, std::size_t workerIndex);
+  };
+}
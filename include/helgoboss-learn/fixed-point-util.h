@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+
+namespace helgoboss::util {
+  // Normalized value in Q16 format, that is, 65536 represents 1.0. Used for processing incoming 7-bit and 14-bit MIDI
+  // values with integer arithmetic only. Feedback doesn't use it.
+  using FixedPointValue = std::int32_t;
+
+  constexpr FixedPointValue FIXED_POINT_ONE = 1 << 16;
+  constexpr FixedPointValue FIXED_POINT_HALF = FIXED_POINT_ONE / 2;
+}
+
+namespace helgoboss::internal {
+  // Rounds half away from zero, just like std::round(). Denominator must be positive.
+  constexpr std::int64_t divideRounded(std::int64_t numerator, std::int64_t denominator) {
+    return numerator >= 0
+        ? (numerator + denominator / 2) / denominator
+        : -((-numerator + denominator / 2) / denominator);
+  }
+
+  constexpr util::FixedPointValue clampFixedPointValue(util::FixedPointValue value) {
+    return value < 0 ? 0 : (value > util::FIXED_POINT_ONE ? util::FIXED_POINT_ONE : value);
+  }
+}
+
+namespace helgoboss::util {
+  /**
+   * Returns the fixed-point value which is closest to the given normalized value.
+   */
+  constexpr FixedPointValue toFixedPoint(double normalizedValue) {
+    const double scaledValue = normalizedValue * FIXED_POINT_ONE;
+    return static_cast<FixedPointValue>(scaledValue >= 0 ? scaledValue + 0.5 : scaledValue - 0.5);
+  }
+
+  constexpr double fromFixedPoint(FixedPointValue value) {
+    return static_cast<double>(value) / FIXED_POINT_ONE;
+  }
+
+  /**
+   * Maps the given discrete value within [0, maxValue] to a fixed-point value within [0, 1].
+   *
+   * If isCentered is true, the center value (maxValue + 1) / 2 is mapped to exactly 0.5, which is what one would expect
+   * from a pitch bend wheel in neutral position. The double-based mapping in SourceProcessor can't guarantee that
+   * because it maps 8192 to 8192 / 16383. Values below and above the center are scaled separately.
+   *
+   * Mapping the result back with mapFixedPointToDiscreteValue() yields the original value for maxValue up to 65536.
+   */
+  constexpr FixedPointValue mapDiscreteValueToFixedPoint(int value, int maxValue, bool isCentered = false) {
+    const std::int64_t clampedValue = value < 0 ? 0 : (value > maxValue ? maxValue : value);
+    if (!isCentered) {
+      return static_cast<FixedPointValue>(internal::divideRounded(clampedValue * FIXED_POINT_ONE, maxValue));
+    }
+    const std::int64_t center = (maxValue + 1) / 2;
+    if (clampedValue <= center) {
+      return static_cast<FixedPointValue>(internal::divideRounded(clampedValue * FIXED_POINT_HALF, center));
+    }
+    return FIXED_POINT_HALF + static_cast<FixedPointValue>(
+        internal::divideRounded((clampedValue - center) * FIXED_POINT_HALF, maxValue - center)
+    );
+  }
+
+  /**
+   * Inverse of mapDiscreteValueToFixedPoint(). Rounds to the closest discrete value.
+   */
+  constexpr int mapFixedPointToDiscreteValue(FixedPointValue value, int maxValue, bool isCentered = false) {
+    const std::int64_t clampedValue = internal::clampFixedPointValue(value);
+    if (!isCentered) {
+      return static_cast<int>(internal::divideRounded(clampedValue * maxValue, FIXED_POINT_ONE));
+    }
+    const std::int64_t center = (maxValue + 1) / 2;
+    if (clampedValue <= FIXED_POINT_HALF) {
+      return static_cast<int>(internal::divideRounded(clampedValue * center, FIXED_POINT_HALF));
+    }
+    return static_cast<int>(
+        center + internal::divideRounded((clampedValue - FIXED_POINT_HALF) * (maxValue - center), FIXED_POINT_HALF)
+    );
+  }
+
+  /**
+   * Fixed-point counterpart of mapValueInRangeToNormalizedValue() for non-negative values. Values outside of the range
+   * are clamped.
+   */
+  constexpr FixedPointValue mapFixedPointInRangeToNormalizedFixedPoint(
+      FixedPointValue value, FixedPointValue rangeMin, FixedPointValue rangeMax) {
+    const std::int64_t actualRangeMin = rangeMin < rangeMax ? rangeMin : rangeMax;
+    const std::int64_t actualRangeMax = rangeMin < rangeMax ? rangeMax : rangeMin;
+    if (actualRangeMax == actualRangeMin) {
+      return 0;
+    }
+    const std::int64_t clampedValue =
+        value < actualRangeMin ? actualRangeMin : (value > actualRangeMax ? actualRangeMax : value);
+    return static_cast<FixedPointValue>(
+        internal::divideRounded((clampedValue - actualRangeMin) * FIXED_POINT_ONE, actualRangeMax - actualRangeMin)
+    );
+  }
+
+  /**
+   * Fixed-point counterpart of mapNormalizedValueToValueInRange() for values within [0, 1].
+   */
+  constexpr FixedPointValue mapNormalizedFixedPointToFixedPointInRange(
+      FixedPointValue value, FixedPointValue rangeMin, FixedPointValue rangeMax) {
+    const std::int64_t actualRangeMin = rangeMin < rangeMax ? rangeMin : rangeMax;
+    const std::int64_t actualRangeMax = rangeMin < rangeMax ? rangeMax : rangeMin;
+    const std::int64_t clampedValue = internal::clampFixedPointValue(value);
+    return static_cast<FixedPointValue>(
+        actualRangeMin + internal::divideRounded(clampedValue * (actualRangeMax - actualRangeMin), FIXED_POINT_ONE)
+    );
+  }
+}
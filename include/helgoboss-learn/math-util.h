@@ -2,6 +2,38 @@
 
 #include <string>
 #include <functional>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define HELGOBOSS_LEARN_HAS_IS_CONSTANT_EVALUATED
+#endif
+#elif defined(__GNUC__) && __GNUC__ >= 9
+// GCC 9 has the builtin but not __has_builtin
+#define HELGOBOSS_LEARN_HAS_IS_CONSTANT_EVALUATED
+#elif defined(_MSC_VER) && _MSC_VER >= 1925
+#define HELGOBOSS_LEARN_HAS_IS_CONSTANT_EVALUATED
+#endif
+
+namespace helgoboss::internal {
+  // Like std::signbit() but usable in constant expressions. At compile time, -0.0 counts as positive because there's
+  // no way to inspect the sign bit in a C++17 constant expression. Compilers which can't tell whether they evaluate at
+  // compile time treat -0.0 like that at runtime as well.
+  constexpr bool signbit(double value) {
+#ifdef HELGOBOSS_LEARN_HAS_IS_CONSTANT_EVALUATED
+    if (!__builtin_is_constant_evaluated()) {
+      return std::signbit(value);
+    }
+#endif
+    return value < 0;
+  }
+
+  // Like std::abs() but usable in constant expressions
+  constexpr double abs(double value) {
+    return signbit(value) ? -value : value;
+  }
+}
 
 namespace helgoboss::util {
   /**
@@ -16,7 +48,20 @@ namespace helgoboss::util {
    * - value within [-1, 0) to [-rangeMax, -rangeMin)
    * - value < -1 to -rangeMax
    */
-  double mapNormalizedValueToValueInRange(double value, double rangeMin, double rangeMax);
+  constexpr double mapNormalizedValueToValueInRange(double value, double rangeMin, double rangeMax) {
+    const double actualRangeMin = std::min(rangeMin, rangeMax);
+    const double actualRangeMax = std::max(rangeMin, rangeMax);
+    // Graceful error handling: In case that normalized value is not actually normalized (not from -1 to +1), return
+    // corresponding range maximum
+    if (value < -1) {
+      return -actualRangeMax;
+    } else if (value > 1) {
+      return actualRangeMax;
+    }
+    // Happy path
+    const double targetSpan = actualRangeMax - actualRangeMin;
+    return (internal::signbit(value) ? -1 : 1) * (actualRangeMin + internal::abs(value) * targetSpan);
+  }
 
   /**
    * Normalizes the given value with regard to the given range. This is the reverse function of
@@ -36,12 +81,41 @@ namespace helgoboss::util {
    * - positive value < rangeMin to 0
    * - positive value > rangeMax to 1
    */
-  double mapValueInRangeToNormalizedValue(double value, double rangeMin, double rangeMax);
+  constexpr double mapValueInRangeToNormalizedValue(double value, double rangeMin, double rangeMax) {
+    const double actualRangeMin = std::min(rangeMin, rangeMax);
+    const double actualRangeMax = std::max(rangeMin, rangeMax);
+    const double sourceSpan = actualRangeMax - actualRangeMin;
+    if (sourceSpan == 0.0) {
+      return 0.0;
+    }
+    if (actualRangeMin < 0) {
+      const double crampedValue = std::min(std::max(actualRangeMin, value), actualRangeMax);
+      const double positiveValue = crampedValue + internal::abs(actualRangeMin);
+      return positiveValue / sourceSpan;
+    } else {
+      const double crampedAbsValue = std::min(std::max(actualRangeMin, internal::abs(value)), actualRangeMax);
+      return (internal::signbit(value) ? -1 : 1) * ((crampedAbsValue - actualRangeMin) / sourceSpan);
+    }
+  }
 
   /**
    * Maps value in [sourceRangeMin, sourceRangeMax] to [targetRangeMin, targetRangeMax] or
    * [-sourceRangeMax, -sourceRangeMin] to [-targetRangeMax, -targetRangeMin].
    */
-  double mapValueInRangeToValueInRange(double value, double sourceRangeMin, double sourceRangeMax,
-      double targetRangeMin, double targetRangeMax);
-}
\ No newline at end of file
+  constexpr double mapValueInRangeToValueInRange(double value, double sourceRangeMin, double sourceRangeMax,
+      double targetRangeMin, double targetRangeMax) {
+    const double actualSourceRangeMin = std::min(sourceRangeMin, sourceRangeMax);
+    const double actualSourceRangeMax = std::max(sourceRangeMin, sourceRangeMax);
+    const auto positiveValue = internal::abs(value);
+    if (positiveValue < actualSourceRangeMin || positiveValue > actualSourceRangeMax) {
+      return 0.0;
+    }
+    const double actualTargetRangeMin = std::max(targetRangeMin, targetRangeMax);
+    const double actualTargetRangeMax = std::max(targetRangeMin, targetRangeMax);
+    return mapNormalizedValueToValueInRange(
+        mapValueInRangeToNormalizedValue(value, actualSourceRangeMin, actualSourceRangeMax),
+        actualTargetRangeMin,
+        actualTargetRangeMax
+    );
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <istream>
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "Source.h"
+#include "Mode.h"
+
+namespace helgoboss {
+  // Source and mode of one mapping. Both are owned by someone else.
+  struct MappingRef {
+    Source* source;
+    Mode* mode;
+  };
+
+  struct ConstMappingRef {
+    const Source* source;
+    const Mode* mode;
+  };
+
+  namespace util {
+    /**
+     * Serializes the given mappings as JSON array of objects with the keys "source" and "mode".
+     *
+     * The result is byte-identical to dumping (without indentation) a JSON array whose objects have been filled using
+     * Source::serializeToJson() and Mode::serializeToJson(). However, no JSON DOM is built in between.
+     */
+    std::string serializeMappings(const std::vector<ConstMappingRef>& mappings, bool useStringsForEnums = false);
+
+    /**
+     * Updates the given mappings from a JSON array as produced by serializeMappings(). The array must have exactly
+     * as many elements as there are mappings.
+     *
+     * Each source and mode gets its processor updated just once, not on each property change.
+     */
+    void deserializeMappings(const nlohmann::json& mappingsJson, const std::vector<MappingRef>& mappings);
+
+    /**
+     * Reads a JSON array as produced by serializeMappings() from the given stream and loads one mapping after the
+     * other, while the stream is being parsed. Returns the number of loaded mappings.
+     *
+     * As soon as a mapping has been read completely, provideMapping is asked for the source and mode to be updated.
+     * After updating them, mappingLoaded is called, e.g. in order to activate the mapping. The whole array is never
+     * kept in memory, just the mapping which is currently being read.
+     *
+     * Throws nlohmann::json exceptions if the text is malformed and std::runtime_error if it's not an array of mapping
+     * objects.
+     */
+    std::size_t loadMappings(
+        std::istream& input,
+        const std::function<MappingRef(std::size_t index)>& provideMapping,
+        const std::function<void(std::size_t index, MappingRef mapping)>& mappingLoaded
+    );
+
+    /**
+     * Builds the processors of the given (usually lazily activated) mappings on a background thread. Otherwise their
+     * first use would build them, allocating and compiling EEL on the processing thread. The mappings must not be
+     * touched until the returned future is ready.
+     */
+    std::future<void> warmUpInBackground(std::vector<MappingRef> mappings);
+  }
+}
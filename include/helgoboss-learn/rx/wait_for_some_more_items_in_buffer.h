@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <boost/optional.hpp>
+#include "rxcpp/rx.hpp"
+#include "../FixedCapacityBuffer.h"
+
+namespace helgoboss::util {
+  /**
+   * Like waitForSomeMoreItems but collects the items in a fixed-capacity inline buffer and reuses its state for all
+   * bursts. After subscription it doesn't allocate anymore, apart from what the scheduler needs for enqueuing the one
+   * timeout per burst.
+   *
+   * Timeouts of bursts which have been submitted early (because the requested item count has been reached) are not
+   * unscheduled but ignored when they fire. That's fine for event and run loops but a bad fit for the current-thread
+   * scheduler, which would block until they are due.
+   *
+   * The requested item count is limited to the buffer capacity.
+   *
+   * If isConclusive is given, it's asked after each buffered item whether the buffer can be submitted right away
+   * because waiting for more items wouldn't change anything anymore.
+   */
+  template<typename Item, std::size_t Capacity, typename Coordination>
+  std::function<rxcpp::subscriber<Item>(rxcpp::subscriber<FixedCapacityBuffer<Item, Capacity>>)>
+  waitForSomeMoreItemsInBuffer(
+      std::size_t requestedItemCount,
+      rxcpp::schedulers::scheduler::clock_type::duration maxWaitingTime,
+      Coordination coordination,
+      std::function<bool(const FixedCapacityBuffer<Item, Capacity>&)> isConclusive = nullptr
+  ) {
+    // Restrict template parameter Coordination
+    static_assert(rxcpp::is_coordination<Coordination>::value,
+        "Coordination parameter must satisfy the requirements for a Coordination");
+    static_assert(Capacity > 0, "Capacity must be greater than zero");
+
+    using Buffer = FixedCapacityBuffer<Item, Capacity>;
+
+    // Define class that holds the behavior for this operator
+    class Operator {
+    public:
+      // Define class that holds the state for this operator
+      struct OperatorState {
+      public:
+        Buffer bufferedItems;
+        rxcpp::schedulers::scheduler::clock_type::time_point bufferSubmissionTime;
+        // Created once and rescheduled for each burst
+        boost::optional<rxcpp::schedulers::schedulable> bufferSubmission;
+        rxcpp::schedulers::worker worker;
+        typename Coordination::coordinator_type coordinator;
+        rxcpp::composite_subscription cs;
+        std::size_t requestedItemCount;
+        rxcpp::subscriber<Buffer> destination;
+        rxcpp::schedulers::scheduler::clock_type::duration maxWaitingTime;
+        std::function<bool(const Buffer&)> isConclusive;
+      public:
+        OperatorState(
+            rxcpp::composite_subscription cs,
+            typename Coordination::coordinator_type coordinator,
+            rxcpp::subscriber<Buffer> destination,
+            std::size_t requestedItemCount,
+            rxcpp::schedulers::scheduler::clock_type::duration maxWaitingTime,
+            std::function<bool(const Buffer&)> isConclusive) :
+            worker(coordinator.get_worker()),
+            coordinator(std::move(coordinator)),
+            cs(std::move(cs)),
+            requestedItemCount(std::min(requestedItemCount, Capacity)),
+            destination(std::move(destination)),
+            maxWaitingTime(maxWaitingTime),
+            isConclusive(std::move(isConclusive)) {
+        }
+
+        void dispose() {
+          // Also cancels pending buffer submissions because their lifetime is cs
+          cs.unsubscribe();
+          destination.unsubscribe();
+          worker.unsubscribe();
+        }
+      };
+
+    private:
+      std::shared_ptr<OperatorState> state_;
+    public:
+      Operator(std::shared_ptr<OperatorState> state) : state_(state) {
+        // Save state into local variable so we don't depend on "this" in the disposer lambda.
+        // "this" can be already gone at the time of disposal.
+        auto localState = state_;
+        // Only keep a weak reference in the schedulable because the state owns the schedulable
+        std::weak_ptr<OperatorState> weakState = localState;
+        localState->bufferSubmission = make_schedulable(
+            localState->worker,
+            localState->cs,
+            [weakState](const rxcpp::schedulers::schedulable&) {
+              if (auto lockedState = weakState.lock()) {
+                submitBufferIfDue(*lockedState);
+              }
+            }
+        );
+        // Stop scheduling as soon as unsubscribed
+        auto disposer = [localState]() {
+          localState->dispose();
+        };
+        localState->destination.add(disposer);
+        localState->cs.add(disposer);
+      }
+
+      void onNext(Item item) {
+        auto& state = *state_;
+        // Buffer item
+        state.bufferedItems.push_back(item);
+        const auto bufferSize = state.bufferedItems.size();
+        if (bufferSize == 1) {
+          // This was the first item in a row
+          scheduleBufferSubmission(state);
+        }
+        const bool requestedItemCountReached =
+            (bufferSize > 1 && bufferSize == state.requestedItemCount) || state.bufferedItems.full();
+        if (requestedItemCountReached || (state.isConclusive && state.isConclusive(state.bufferedItems))) {
+          // The scheduled submission will notice that it's obsolete
+          submitBuffer(state);
+        }
+      }
+
+    private:
+      static void submitBuffer(OperatorState& state) {
+        state.destination.on_next(state.bufferedItems);
+        state.bufferedItems.clear();
+      }
+
+      static void submitBufferIfDue(OperatorState& state) {
+        // The buffer might have been submitted already or belong to a later burst
+        if (!state.bufferedItems.empty() && state.worker.now() >= state.bufferSubmissionTime) {
+          submitBuffer(state);
+        }
+      }
+
+      static void scheduleBufferSubmission(OperatorState& state) {
+        state.bufferSubmissionTime = state.worker.now() + state.maxWaitingTime;
+        state.worker.schedule(state.bufferSubmissionTime, *state.bufferSubmission);
+      }
+    };
+
+    // Return function that is capable of creating the operator
+    return [requestedItemCount, maxWaitingTime, coordination, isConclusive](rxcpp::subscriber<Buffer> destination) {
+      // Create operator state
+      auto cs = rxcpp::composite_subscription();
+      auto state = std::make_shared<typename Operator::OperatorState>(
+          cs, coordination.create_coordinator(), destination, requestedItemCount, maxWaitingTime, isConclusive);
+      auto op = std::make_shared<Operator>(state);
+
+      // Return operator
+      return rxcpp::make_subscriber<Item>(cs, [op](Item item) { op->onNext(item); })
+          .as_dynamic(); // VS2013 deduction issue requires dynamic (type-forgetting)
+    };
+  }
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <vector>
 #include <memory>
 #include <rxcpp/rx.hpp>
@@ -8,14 +9,41 @@
 #include <helgoboss-midi/MidiParameterNumberMessage.h>
 #include "SourceCharacter.h"
 #include "Source.h"
+#include "SourceDescriptor.h"
+#include "SourceCharacterClassifier.h"
+#include "HighResolutionCcDetector.h"
 #include "rx/limit_to_items_like_first_one.h"
 #include "rx/wait_for_some_more_items.h"
+#include "rx/wait_for_some_more_items_in_buffer.h"
 
 namespace helgoboss::util {
   SourceCharacter guessSourceCharacter(const std::vector<MidiMessage>& relatedCcMessages);
 
+  /**
+   * Same result as the vector variant but classifies incrementally via SourceCharacterClassifier.
+   */
+  template<std::size_t Capacity>
+  SourceCharacter guessSourceCharacter(const FixedCapacityBuffer<MidiMessage, Capacity>& relatedCcMessages) {
+    SourceCharacterClassifier classifier;
+    for (const auto& msg : relatedCcMessages) {
+      classifier.feed(msg.getControlValue());
+    }
+    return classifier.guess().character;
+  }
+
+  /**
+   * Turns incoming MIDI messages into learn candidates.
+   *
+   * Emits lightweight source descriptors instead of Source objects so that nothing expensive is built for
+   * candidates which are going to be thrown away anyway. Use Source::updateFromDescriptor() for the candidate which
+   * has actually been accepted.
+   *
+   * 14-bit CC messages and (N)RPN messages are recognized in the raw CC messages already, so the host doesn't need to
+   * assemble them for learning. CC messages which turn out to be part of them don't lead to 7-bit CC candidates.
+   * Passing host-assembled messages in addition is harmless, they just yield the same candidates once more.
+   */
   template<typename Coordination>
-  rxcpp::observable<std::shared_ptr<Source>> parseSources(
+  rxcpp::observable<SourceDescriptor> parseSourceDescriptors(
       rxcpp::observable<MidiMessage> midiMessages,
       rxcpp::observable<Midi14BitCcMessage> midi14BitCcMessages,
       rxcpp::observable<MidiParameterNumberMessage> midiParameterNumberMessages,
@@ -30,49 +58,99 @@ namespace helgoboss::util {
         .filter([](MidiMessage msg) {
           return msg.getType() != MidiMessageType::ControlChange;
         });
-    const rxcpp::observable<MidiMessage> lockedCcMidiMessages = ccMidiMessages.template lift<MidiMessage>(
-        limitToItemsLikeFirstOne<MidiMessage>([](MidiMessage itemOne, MidiMessage itemTwo) {
-          return itemOne.getChannel() == itemTwo.getChannel() &&
-              itemOne.getControllerNumber() == itemTwo.getControllerNumber();
-        })
-    );
-    const auto actualCcMidiMessages = firstCcMessageSetsTheAgenda ? lockedCcMidiMessages.as_dynamic()
-                                                                  : ccMidiMessages.as_dynamic();
-    const auto ccValueSources = actualCcMidiMessages
-        .template lift<std::vector<MidiMessage >>(
-            waitForSomeMoreItems<MidiMessage>(
-                10, // wait for 10 items
-                std::chrono::milliseconds(250), // for a maximum of n ms
-                coordination // best on audio thread
-            )
-        )
-        .map([](std::vector<MidiMessage> msgs) {
-          auto source = std::make_shared<Source>();
-          source->updateFromMidiMessage(msgs.at(0));
-          source->customCharacter.set(guessSourceCharacter(msgs));
-          return source;
-        });
-    const auto nonCcValueSources = nonCcMidiMessages
-        .map([](MidiMessage msg) {
-          auto source = std::make_shared<Source>();
-          source->updateFromMidiMessage(msg);
-          return source;
-        });
-    const auto parameterMessageValueSources = midiParameterNumberMessages
-        .map([](MidiParameterNumberMessage msg) {
-          auto source = std::make_shared<Source>();
-          source->updateFromMidiParameterNumberMessage(msg);
-          return source;
-        });
-    const auto midi14BitCcMessageSources = midi14BitCcMessages
-        .map([](Midi14BitCcMessage msg) {
-          auto source = std::make_shared<Source>();
-          source->updateFromMidi14BitCcMessage(msg);
-          return source;
-        });
-    return ccValueSources
-        .merge(nonCcValueSources)
-        .merge(parameterMessageValueSources)
-        .merge(midi14BitCcMessageSources);
+    return rxcpp::observable<>::defer([=]() {
+      // Each subscription gets its own detector
+      const auto detector = std::make_shared<HighResolutionCcDetector>();
+      const rxcpp::observable<MidiMessage> lockedCcMidiMessages = ccMidiMessages.template lift<MidiMessage>(
+          limitToItemsLikeFirstOne<MidiMessage>([](MidiMessage itemOne, MidiMessage itemTwo) {
+            return itemOne.getChannel() == itemTwo.getChannel() &&
+                itemOne.getControllerNumber() == itemTwo.getControllerNumber();
+          })
+      );
+      const auto actualCcMidiMessages = firstCcMessageSetsTheAgenda ? lockedCcMidiMessages.as_dynamic()
+                                                                    : ccMidiMessages.as_dynamic();
+      const auto highResolutionCcValueSources = ccMidiMessages
+          .map([detector](MidiMessage msg) {
+            const auto now = std::chrono::steady_clock::now().time_since_epoch();
+            return detector->feed(msg, std::chrono::duration<double>(now).count());
+          })
+          .filter([](boost::optional<SourceDescriptor> descriptor) {
+            return descriptor.has_value();
+          })
+          .map([](boost::optional<SourceDescriptor> descriptor) {
+            return *descriptor;
+          });
+      using CcMessageBuffer = FixedCapacityBuffer<MidiMessage, 10>;
+      // Classifies incrementally so we can stop waiting as soon as the character is clear. Each subscription gets its
+      // own copy.
+      auto classifier = SourceCharacterClassifier();
+      const auto ccValueSources = actualCcMidiMessages
+          .template lift<CcMessageBuffer>(
+              waitForSomeMoreItemsInBuffer<MidiMessage, 10>(
+                  10, // wait for 10 items
+                  std::chrono::milliseconds(250), // for a maximum of n ms
+                  coordination, // best on audio thread
+                  [classifier](const CcMessageBuffer& msgs) mutable {
+                    if (msgs.size() == 1) {
+                      classifier.reset();
+                    }
+                    return classifier.feed(msgs.back().getControlValue()).has_value();
+                  }
+              )
+          )
+          .map([](const CcMessageBuffer& msgs) {
+            auto descriptor = describeSourceOfMidiMessage(msgs.front());
+            descriptor.customCharacter = guessSourceCharacter(msgs);
+            return descriptor;
+          })
+          .filter([detector](SourceDescriptor descriptor) {
+            return !detector->isPartOfHighResolutionMessage(descriptor.channel, descriptor.midiMessageNumber);
+          });
+      const auto nonCcValueSources = nonCcMidiMessages
+          .map([](MidiMessage msg) {
+            return describeSourceOfMidiMessage(msg);
+          });
+      const auto parameterMessageValueSources = midiParameterNumberMessages
+          .map([](MidiParameterNumberMessage msg) {
+            return describeSourceOfMidiParameterNumberMessage(msg);
+          });
+      const auto midi14BitCcMessageSources = midi14BitCcMessages
+          .map([](Midi14BitCcMessage msg) {
+            return describeSourceOfMidi14BitCcMessage(msg);
+          });
+      // High-resolution sources come first so the detector is up-to-date when 7-bit CC candidates are checked
+      return highResolutionCcValueSources
+          .merge(ccValueSources)
+          .merge(nonCcValueSources)
+          .merge(parameterMessageValueSources)
+          .merge(midi14BitCcMessageSources)
+          .as_dynamic();
+    });
+  }
+
+  /**
+   * Like parseSourceDescriptors() but materializes each candidate as Source.
+   *
+   * Prefer parseSourceDescriptors() if you are going to discard most of the candidates.
+   */
+  template<typename Coordination>
+  rxcpp::observable<std::shared_ptr<Source>> parseSources(
+      rxcpp::observable<MidiMessage> midiMessages,
+      rxcpp::observable<Midi14BitCcMessage> midi14BitCcMessages,
+      rxcpp::observable<MidiParameterNumberMessage> midiParameterNumberMessages,
+      Coordination coordination,
+      bool firstCcMessageSetsTheAgenda = true
+  ) {
+    return parseSourceDescriptors(
+        midiMessages,
+        midi14BitCcMessages,
+        midiParameterNumberMessages,
+        coordination,
+        firstCcMessageSetsTheAgenda
+    ).map([](SourceDescriptor descriptor) {
+      auto source = std::make_shared<Source>();
+      source->updateFromDescriptor(descriptor);
+      return source;
+    });
   }
 }
\ No newline at end of file
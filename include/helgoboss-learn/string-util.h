@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <string_view>
 #include <memory>
 #include <functional>
 
@@ -9,4 +11,27 @@ namespace helgoboss::util {
    * Executes the given fillBuffer function and converts the filled buffer to a string.
    */
   std::string toString(int maxSize, const std::function<void(char*, int)>& fillBuffer);
-}
\ No newline at end of file
+
+  /**
+   * Writes text into a caller-provided character buffer without allocating memory and without taking the locale into
+   * account. Text which doesn't fit is cut off. The buffer content is always null-terminated (unless its size is 0).
+   */
+  class BufferWriter {
+  private:
+    char* buffer_;
+    std::size_t capacity_;
+    std::size_t size_ = 0;
+    bool isTruncated_ = false;
+  public:
+    BufferWriter(char* buffer, std::size_t bufferSize);
+
+    BufferWriter& append(std::string_view text);
+    BufferWriter& append(int value);
+    // Like printf with "%.<precision>f"
+    BufferWriter& appendFixed(double value, int precision);
+
+    // Number of written characters, excluding the terminating null character
+    std::size_t getSize() const;
+    bool isTruncated() const;
+  };
+}
@@ -0,0 +1,212 @@
+#include <helgoboss-learn/BinaryPreset.h>
+#include <cstring>
+#include <stdexcept>
+#include <unordered_map>
+#include <gsl/gsl>
+
+using helgoboss::internal::BinaryMappingRecord;
+using helgoboss::internal::BinaryPresetHeader;
+using helgoboss::internal::BinaryStringTableEntry;
+
+namespace {
+  const char MAGIC[8] = {'H', 'L', 'P', 'R', 'E', 'S', 'E', 'T'};
+  constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+  class StringTableBuilder {
+  private:
+    std::vector<BinaryStringTableEntry> entries_;
+    std::string contents_;
+    std::unordered_map<std::string, std::uint32_t> indexes_;
+  public:
+    StringTableBuilder() {
+      add("");
+    }
+
+    std::uint32_t add(const std::string& text) {
+      const auto it = indexes_.find(text);
+      if (it != indexes_.end()) {
+        return it->second;
+      }
+      const auto index = static_cast<std::uint32_t>(entries_.size());
+      entries_.push_back({static_cast<std::uint32_t>(contents_.size()), static_cast<std::uint32_t>(text.size())});
+      contents_ += text;
+      indexes_.emplace(text, index);
+      return index;
+    }
+
+    void appendTo(std::string& out) const {
+      const auto count = static_cast<std::uint32_t>(entries_.size());
+      const auto contentsOffset = static_cast<std::uint32_t>(sizeof(count) + count * sizeof(BinaryStringTableEntry));
+      appendBytes(out, count);
+      for (auto entry : entries_) {
+        entry.offset += contentsOffset;
+        appendBytes(out, entry);
+      }
+      out += contents_;
+    }
+
+    template<typename T>
+    static void appendBytes(std::string& out, const T& value) {
+      out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+  };
+
+  template<typename T>
+  T readBytes(const char* data, std::size_t size, std::size_t offset) {
+    if (offset > size || size - offset < sizeof(T)) {
+      throw std::runtime_error("Binary preset is truncated");
+    }
+    T value;
+    std::memcpy(&value, data + offset, sizeof(T));
+    return value;
+  }
+}
+
+namespace helgoboss {
+  BinaryPresetView::BinaryPresetView(const void* data, std::size_t size) :
+      data_(static_cast<const char*>(data)),
+      size_(size),
+      header_(readBytes<BinaryPresetHeader>(data_, size_, 0)) {
+    if (std::memcmp(header_.magic, MAGIC, sizeof(MAGIC)) != 0) {
+      throw std::runtime_error("Not a binary preset");
+    }
+    if (header_.version != VERSION) {
+      throw std::runtime_error("Unsupported binary preset version");
+    }
+    if (header_.byteOrderMark != BYTE_ORDER_MARK) {
+      throw std::runtime_error("Binary preset has been written on a machine with different byte order");
+    }
+    if (header_.mappingRecordSize != sizeof(BinaryMappingRecord)) {
+      throw std::runtime_error("Binary preset has unexpected mapping record size");
+    }
+    const auto recordsEnd = sizeof(BinaryPresetHeader) + std::uint64_t(header_.mappingCount) * sizeof(BinaryMappingRecord);
+    if (recordsEnd > header_.stringTableOffset || header_.stringTableOffset > size_ ||
+        header_.stringTableSize > size_ - header_.stringTableOffset) {
+      throw std::runtime_error("Binary preset is truncated");
+    }
+  }
+
+  std::size_t BinaryPresetView::getMappingCount() const {
+    return header_.mappingCount;
+  }
+
+  void BinaryPresetView::loadMapping(std::size_t index, MappingRef mapping) const {
+    const auto record = getMappingRecord(index);
+    auto& source = *mapping.source;
+    source.modifyInBatch([&source, &record] {
+      // Important to set type first
+      source.type.set(static_cast<SourceType>(record.sourceType));
+      source.channel.set(record.channel);
+      source.midiMessageNumber.set(record.midiMessageNumber);
+      source.parameterNumberMessageNumber.set(record.parameterNumberMessageNumber);
+      source.customCharacter.set(static_cast<SourceCharacter>(record.customCharacter));
+      source.midiClockTransportMessageType.set(
+          static_cast<MidiClockTransportMessageType>(record.midiClockTransportMessageType));
+      source.is14Bit.set(record.is14Bit != 0);
+      source.isRegistered.set(record.isRegistered != 0);
+    });
+    auto& mode = *mapping.mode;
+    const auto eelControlTransformation = getString(record.eelControlTransformation);
+    const auto eelFeedbackTransformation = getString(record.eelFeedbackTransformation);
+    mode.modifyInBatch([&] {
+      mode.type.set(static_cast<ModeType>(record.modeType));
+      mode.minSourceValue.set(record.minSourceValue);
+      mode.maxSourceValue.set(record.maxSourceValue);
+      mode.minTargetValue.set(record.minTargetValue);
+      mode.maxTargetValue.set(record.maxTargetValue);
+      mode.minTargetJump.set(record.minTargetJump);
+      mode.maxTargetJump.set(record.maxTargetJump);
+      mode.minStepSize.set(record.minStepSize);
+      mode.maxStepSize.set(record.maxStepSize);
+      mode.reverseIsEnabled.set(record.reverseIsEnabled != 0);
+      mode.ignoreOutOfRangeSourceValuesIsEnabled.set(record.ignoreOutOfRangeSourceValuesIsEnabled != 0);
+      mode.roundTargetValue.set(record.roundTargetValue != 0);
+      mode.scaleModeEnabled.set(record.scaleModeEnabled != 0);
+      mode.rotateIsEnabled.set(record.rotateIsEnabled != 0);
+      mode.eelControlTransformation.set(eelControlTransformation);
+      mode.eelFeedbackTransformation.set(eelFeedbackTransformation);
+    });
+  }
+
+  void BinaryPresetView::loadMappings(const std::vector<MappingRef>& mappings) const {
+    Expects(mappings.size() == getMappingCount());
+    for (std::size_t i = 0; i < mappings.size(); i++) {
+      loadMapping(i, mappings[i]);
+    }
+  }
+
+  BinaryMappingRecord BinaryPresetView::getMappingRecord(std::size_t index) const {
+    Expects(index < getMappingCount());
+    return readBytes<BinaryMappingRecord>(data_, size_,
+        sizeof(BinaryPresetHeader) + index * sizeof(BinaryMappingRecord));
+  }
+
+  std::string BinaryPresetView::getString(std::uint32_t index) const {
+    const auto tableData = data_ + header_.stringTableOffset;
+    const auto tableSize = static_cast<std::size_t>(header_.stringTableSize);
+    const auto count = readBytes<std::uint32_t>(tableData, tableSize, 0);
+    if (index >= count) {
+      throw std::runtime_error("Binary preset refers to nonexistent string");
+    }
+    const auto entry = readBytes<BinaryStringTableEntry>(tableData, tableSize,
+        sizeof(count) + std::size_t(index) * sizeof(BinaryStringTableEntry));
+    if (entry.offset > tableSize || entry.length > tableSize - entry.offset) {
+      throw std::runtime_error("Binary preset is truncated");
+    }
+    return std::string(tableData + entry.offset, entry.length);
+  }
+
+  namespace util {
+    std::string serializeMappingsToBinary(const std::vector<ConstMappingRef>& mappings) {
+      StringTableBuilder stringTable;
+      std::string records;
+      records.reserve(mappings.size() * sizeof(BinaryMappingRecord));
+      for (const auto& mapping : mappings) {
+        const auto& source = *mapping.source;
+        const auto& mode = *mapping.mode;
+        BinaryMappingRecord record{};
+        record.sourceType = static_cast<std::int32_t>(source.type.get());
+        record.channel = source.channel.get();
+        record.midiMessageNumber = source.midiMessageNumber.get();
+        record.parameterNumberMessageNumber = source.parameterNumberMessageNumber.get();
+        record.customCharacter = static_cast<std::int32_t>(source.customCharacter.get());
+        record.midiClockTransportMessageType = static_cast<std::int32_t>(source.midiClockTransportMessageType.get());
+        record.is14Bit = source.is14Bit.get();
+        record.isRegistered = source.isRegistered.get();
+        record.modeType = static_cast<std::int32_t>(mode.type.get());
+        record.minTargetValue = mode.minTargetValue.get();
+        record.maxTargetValue = mode.maxTargetValue.get();
+        record.minSourceValue = mode.minSourceValue.get();
+        record.maxSourceValue = mode.maxSourceValue.get();
+        record.minTargetJump = mode.minTargetJump.get();
+        record.maxTargetJump = mode.maxTargetJump.get();
+        record.minStepSize = mode.minStepSize.get();
+        record.maxStepSize = mode.maxStepSize.get();
+        record.reverseIsEnabled = mode.reverseIsEnabled.get();
+        record.ignoreOutOfRangeSourceValuesIsEnabled = mode.ignoreOutOfRangeSourceValuesIsEnabled.get();
+        record.roundTargetValue = mode.roundTargetValue.get();
+        record.scaleModeEnabled = mode.scaleModeEnabled.get();
+        record.rotateIsEnabled = mode.rotateIsEnabled.get();
+        record.eelControlTransformation = stringTable.add(mode.eelControlTransformation.get());
+        record.eelFeedbackTransformation = stringTable.add(mode.eelFeedbackTransformation.get());
+        StringTableBuilder::appendBytes(records, record);
+      }
+      std::string strings;
+      stringTable.appendTo(strings);
+      BinaryPresetHeader header{};
+      std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+      header.version = BinaryPresetView::VERSION;
+      header.byteOrderMark = BYTE_ORDER_MARK;
+      header.mappingCount = static_cast<std::uint32_t>(mappings.size());
+      header.mappingRecordSize = sizeof(BinaryMappingRecord);
+      header.stringTableOffset = sizeof(BinaryPresetHeader) + records.size();
+      header.stringTableSize = strings.size();
+      std::string out;
+      out.reserve(sizeof(BinaryPresetHeader) + records.size() + strings.size());
+      StringTableBuilder::appendBytes(out, header);
+      out += records;
+      out += strings;
+      return out;
+    }
+  }
+}
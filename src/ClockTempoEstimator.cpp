@@ -0,0 +1,81 @@
+#include <helgoboss-learn/ClockTempoEstimator.h>
+#include <helgoboss-learn/Tempo.h>
+#include <cmath>
+
+namespace helgoboss {
+  namespace {
+    constexpr double MAX_SECONDS_PER_TICK = 60.0 / (Tempo::MIN_BPM * ClockTempoEstimator::TICKS_PER_QUARTER_NOTE);
+  }
+
+  ClockTempoEstimator::ClockTempoEstimator(double bpmThreshold) : bpmThreshold_(bpmThreshold) {
+  }
+
+  boost::optional<SourceValue> ClockTempoEstimator::feedTick(double timestamp) {
+    if (tickCount_ > 0) {
+      const double previousTimestamp = timestamps_[(nextIndex_ + WINDOW_SIZE - 1) % WINDOW_SIZE];
+      const double interval = timestamp - previousTimestamp;
+      // Equal timestamps are fine, hosts often stamp all ticks of one audio block with the block start
+      if (interval < 0 || interval > MAX_SECONDS_PER_TICK) {
+        // Clock has been stopped or restarted. Keep the emitted tempo, so we don't emit it again if nothing changed.
+        tickCount_ = 0;
+        nextIndex_ = 0;
+      }
+    }
+    timestamps_[nextIndex_] = timestamp;
+    nextIndex_ = (nextIndex_ + 1) % WINDOW_SIZE;
+    if (tickCount_ < WINDOW_SIZE) {
+      tickCount_ += 1;
+    }
+    if (tickCount_ < MIN_TICK_COUNT) {
+      return boost::none;
+    }
+    const double secondsPerTick = computeSecondsPerTick();
+    if (secondsPerTick <= 0) {
+      // All timestamps are equal so far
+      return boost::none;
+    }
+    const double bpm = Tempo(60.0 / (secondsPerTick * TICKS_PER_QUARTER_NOTE)).bpm();
+    estimatedBpm_ = bpm;
+    if (emittedBpm_ && std::abs(bpm - *emittedBpm_) <= bpmThreshold_) {
+      return boost::none;
+    }
+    emittedBpm_ = bpm;
+    return SourceValue(TempoMessage{bpm});
+  }
+
+  boost::optional<SourceValue> ClockTempoEstimator::feed(const MidiMessage& msg, double timestamp) {
+    if (msg.getType() != MidiMessageType::TimingClock) {
+      return boost::none;
+    }
+    return feedTick(timestamp);
+  }
+
+  boost::optional<double> ClockTempoEstimator::getEstimatedBpm() const {
+    return estimatedBpm_;
+  }
+
+  void ClockTempoEstimator::reset() {
+    nextIndex_ = 0;
+    tickCount_ = 0;
+    estimatedBpm_ = boost::none;
+    emittedBpm_ = boost::none;
+  }
+
+  double ClockTempoEstimator::computeSecondsPerTick() const {
+    // Least-squares slope of timestamp over tick number. Timestamps are taken relative to the oldest one, so precision
+    // doesn't suffer if the clock has been running for a long time.
+    const std::size_t oldestIndex = (nextIndex_ + WINDOW_SIZE - tickCount_) % WINDOW_SIZE;
+    const double oldestTimestamp = timestamps_[oldestIndex];
+    double sumY = 0;
+    double sumXY = 0;
+    for (std::size_t x = 0; x < tickCount_; x++) {
+      const double y = timestamps_[(oldestIndex + x) % WINDOW_SIZE] - oldestTimestamp;
+      sumY += y;
+      sumXY += x * y;
+    }
+    const double n = tickCount_;
+    const double sumX = n * (n - 1) / 2;
+    const double sumXX = (n - 1) * n * (2 * n - 1) / 6;
+    return (n * sumXY - sumX * sumY) / (n * sumXX - sumX * sumX);
+  }
+}
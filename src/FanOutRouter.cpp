@@ -0,0 +1,66 @@
+#include <helgoboss-learn/FanOutRouter.h>
+
+using helgoboss::internal::FanOutGroup;
+
+namespace helgoboss {
+  std::size_t FanOutRouter::addMapping(SourceProcessor source, ModeProcessor mode, Target& target) {
+    const auto mappingIndex = mappings_.size();
+    mappings_.push_back({std::move(mode), &target, source.getStatistics()});
+    source.setStatistics(nullptr);
+    const auto it = groupIndexBySource_.find(source);
+    if (it == groupIndexBySource_.end()) {
+      groupIndexBySource_.emplace(source, groups_.size());
+      groups_.push_back({std::move(source), {mappingIndex}});
+    } else {
+      groups_[it->second].mappingIndexes.push_back(mappingIndex);
+    }
+    return mappingIndex;
+  }
+
+  std::size_t FanOutRouter::getMappingCount() const {
+    return mappings_.size();
+  }
+
+  std::size_t FanOutRouter::getGroupCount() const {
+    return groups_.size();
+  }
+
+  std::size_t FanOutRouter::process(const SourceValue& value) {
+    std::size_t matchedGroupCount = 0;
+    for (auto& group : groups_) {
+      if (group.source.matches(value)) {
+        processGroup(group, value);
+        matchedGroupCount++;
+      }
+    }
+    return matchedGroupCount;
+  }
+
+  void FanOutRouter::processGroup(FanOutGroup& group, const SourceValue& value) {
+    const auto& source = group.source;
+    // Both representations are computed at most once, and only if at least one mode needs them
+    bool fixedPointValueIsComputed = false;
+    boost::optional<util::FixedPointValue> fixedPointValue;
+    boost::optional<double> normalizedValue;
+    for (const auto mappingIndex : group.mappingIndexes) {
+      auto& mapping = mappings_[mappingIndex];
+      if (mapping.sourceStatistics != nullptr) {
+        mapping.sourceStatistics->countMatchedEvent();
+      }
+      if (mapping.mode.supportsFixedPointProcessing()) {
+        if (!fixedPointValueIsComputed) {
+          fixedPointValue = source.getFixedPointValue(value);
+          fixedPointValueIsComputed = true;
+        }
+        if (fixedPointValue) {
+          mapping.mode.processFixedPointSourceValue(*fixedPointValue, source, *mapping.target);
+          continue;
+        }
+      }
+      if (!normalizedValue) {
+        normalizedValue = source.getNormalizedValue(value);
+      }
+      mapping.mode.processSourceValue(*normalizedValue, source, *mapping.target);
+    }
+  }
+}
@@ -0,0 +1,97 @@
+#include <helgoboss-learn/FeedbackEngine.h>
+#include <algorithm>
+
+using helgoboss::internal::BufferedFeedback;
+using helgoboss::internal::FeedbackWorker;
+
+namespace {
+  class BufferingSourceContext {
+  private:
+    std::vector<BufferedFeedback>& messages_;
+  public:
+    explicit BufferingSourceContext(std::vector<BufferedFeedback>& messages) : messages_(messages) {
+    }
+
+    void processMidiFeedback(const void* source, const helgoboss::MidiMessage& message) {
+      messages_.push_back({source, {message, message}, 1});
+    }
+
+    void processMidiFeedbackTwo(const void* source, const std::array<helgoboss::MidiMessage, 2>& messages) {
+      messages_.push_back({source, messages, 2});
+    }
+  };
+}
+
+namespace helgoboss {
+  FeedbackEngine::FeedbackEngine(std::size_t workerCount) :
+      workers_(std::max(workerCount, std::size_t(1))), workerPool_(workerCount) {
+  }
+
+  std::size_t FeedbackEngine::addMapping(Source& source, Mode& mode, const Target& target) {
+    source.warmUp();
+    mode.warmUp();
+    mappings_.push_back({&source, &mode, &target});
+    return mappings_.size() - 1;
+  }
+
+  std::size_t FeedbackEngine::getMappingCount() const {
+    return mappings_.size();
+  }
+
+  void FeedbackEngine::feedback(SourceContext& context) {
+    const auto chunkCount = (mappings_.size() + CHUNK_SIZE - 1) / CHUNK_SIZE;
+    chunks_.resize(chunkCount);
+    for (std::size_t i = 0; i < workers_.size(); i++) {
+      auto& worker = workers_[i];
+      worker.messages.clear();
+      // The worker pool synchronizes, so relaxed is enough
+      worker.nextChunkIndex.store(i * chunkCount / workers_.size(), std::memory_order_relaxed);
+      worker.endChunkIndex = (i + 1) * chunkCount / workers_.size();
+    }
+    workerPool_.run([this](std::size_t workerIndex) {
+      runWorker(workerIndex);
+    });
+    // Merge in mapping order
+    for (const auto& chunk : chunks_) {
+      const auto& messages = workers_[chunk.workerIndex].messages;
+      for (auto i = chunk.begin; i < chunk.end; i++) {
+        const auto& m = messages[i];
+        if (m.messageCount == 1) {
+          context.processMidiFeedback(m.source, m.messages[0]);
+        } else {
+          context.processMidiFeedbackTwo(m.source, m.messages);
+        }
+      }
+    }
+  }
+
+  void FeedbackEngine::runWorker(std::size_t workerIndex) {
+    // First the own chunks, then the ones of the others
+    for (std::size_t i = 0; i < workers_.size(); i++) {
+      processChunks(workers_[(workerIndex + i) % workers_.size()], workerIndex);
+    }
+  }
+
+  void FeedbackEngine::processChunks(FeedbackWorker& owner, std::size_t workerIndex) {
+    while (true) {
+      // Might go beyond the end, that's okay
+      const auto chunkIndex = owner.nextChunkIndex.fetch_add(1, std::memory_order_relaxed);
+      if (chunkIndex >= owner.endChunkIndex) {
+        return;
+      }
+      processChunk(chunkIndex, workerIndex);
+    }
+  }
+
+  void FeedbackEngine::processChunk(std::size_t chunkIndex, std::size_t workerIndex) {
+    auto& messages = workers_[workerIndex].messages;
+    BufferingSourceContext context(messages);
+    const auto begin = messages.size();
+    const auto mappingsEnd = std::min((chunkIndex + 1) * CHUNK_SIZE, mappings_.size());
+    for (auto i = chunkIndex * CHUNK_SIZE; i < mappingsEnd; i++) {
+      const auto& mapping = mappings_[i];
+      mapping.mode->feedback(*mapping.source, *mapping.target, context);
+    }
+    chunks_[chunkIndex] = {workerIndex, begin, messages.size()};
+  }
+}
@@ -0,0 +1,51 @@
+#include <helgoboss-learn/FeedbackScheduler.h>
+#include <gsl/gsl>
+
+namespace helgoboss {
+  FeedbackScheduler::~FeedbackScheduler() {
+    for (const auto& subscription : subscriptions_) {
+      subscription.unsubscribe();
+    }
+  }
+
+  std::size_t FeedbackScheduler::addMapping(Source& source, Mode& mode, const Target& target) {
+    source.warmUp();
+    mode.warmUp();
+    const auto mappingIndex = mappings_.size();
+    const auto observableTarget = dynamic_cast<const ObservableTarget*>(&target);
+    mappings_.push_back({&source, &mode, &target, false});
+    if (observableTarget == nullptr) {
+      polledMappingIndexes_.push_back(mappingIndex);
+    } else {
+      subscriptions_.push_back(observableTarget->changed().subscribe([this, mappingIndex](bool) {
+        markDirty(mappingIndex);
+      }));
+    }
+    // Changed settings might result in different feedback as well
+    subscriptions_.push_back(source.changed().merge(mode.changed()).subscribe([this, mappingIndex](bool) {
+      markDirty(mappingIndex);
+    }));
+    markDirty(mappingIndex);
+    return mappingIndex;
+  }
+
+  void FeedbackScheduler::markDirty(std::size_t mappingIndex) {
+    Expects(mappingIndex < mappings_.size());
+    auto& mapping = mappings_[mappingIndex];
+    if (mapping.isDirty) {
+      return;
+    }
+    mapping.isDirty = true;
+    dirtyMappingIndexes_.push_back(mappingIndex);
+  }
+
+  void FeedbackScheduler::markAllDirty() {
+    for (std::size_t i = 0; i < mappings_.size(); i++) {
+      markDirty(i);
+    }
+  }
+
+  std::size_t FeedbackScheduler::getDirtyMappingCount() const {
+    return dirtyMappingIndexes_.size();
+  }
+}
@@ -0,0 +1,136 @@
+#include <helgoboss-learn/HighResolutionCcDetector.h>
+
+namespace helgoboss {
+  boost::optional<SourceDescriptor> HighResolutionCcDetector::feed(const MidiMessage& ccMessage, double timestamp) {
+    const auto channel = ccMessage.getChannel();
+    auto& state = channelStates_.at(channel);
+    const auto expiredDataEntry = state.dataEntryMsbIsPending
+        && timestamp - state.dataEntryMsbTimestamp > MAX_PART_INTERVAL
+        ? takePendingDataEntryMsb(channel, state) : boost::none;
+    const auto result = processMessage(channel, ccMessage.getControllerNumber(), ccMessage.getControlValue(),
+        timestamp, state);
+    // If both are there, the expired one is lost. Not a problem because the controller is going to send it again.
+    return result ? result : expiredDataEntry;
+  }
+
+  boost::optional<SourceDescriptor> HighResolutionCcDetector::processMessage(int channel, int controllerNumber,
+      int value, double timestamp, ChannelState& state) {
+    switch (controllerNumber) {
+      case 98:
+      case 99:
+      case 100:
+      case 101: {
+        // Parameter number selection
+        markAsPartOfHighResolutionMessage(channel, controllerNumber);
+        state.pendingMsbControllerNumber = -1;
+        const bool isRegistered = controllerNumber >= 100;
+        const bool isMsb = controllerNumber == 99 || controllerNumber == 101;
+        const int currentValue = isMsb ? state.parameterNumberMsb : state.parameterNumberLsb;
+        if (isRegistered == state.isRegistered && value == currentValue) {
+          // Same parameter number selected again, some controllers do that before each data entry
+          return boost::none;
+        }
+        const auto unfinishedDataEntry = takePendingDataEntryMsb(channel, state);
+        if (isRegistered != state.isRegistered) {
+          state.parameterNumberMsb = -1;
+          state.parameterNumberLsb = -1;
+          state.isRegistered = isRegistered;
+        }
+        if (isMsb) {
+          state.parameterNumberMsb = value;
+        } else {
+          state.parameterNumberLsb = value;
+        }
+        return unfinishedDataEntry;
+      }
+      case 6:
+      case 38: {
+        // Data entry
+        if (!parameterNumberIsSelected(state)) {
+          // Not part of a parameter number message, so just a 7-bit CC message
+          state.pendingMsbControllerNumber = -1;
+          return boost::none;
+        }
+        markAsPartOfHighResolutionMessage(channel, 6);
+        markAsPartOfHighResolutionMessage(channel, 38);
+        state.pendingMsbControllerNumber = -1;
+        if (controllerNumber == 6) {
+          const auto previousDataEntryWithoutLsb = takePendingDataEntryMsb(channel, state);
+          state.dataEntryMsbIsPending = true;
+          state.dataEntryMsbTimestamp = timestamp;
+          return previousDataEntryWithoutLsb;
+        } else {
+          const bool dataEntryIsComplete = state.dataEntryMsbIsPending;
+          state.dataEntryMsbIsPending = false;
+          return dataEntryIsComplete ? describeParameterNumberSource(channel, state, true) : boost::none;
+        }
+      }
+      default:
+        break;
+    }
+    if (controllerNumber < 32) {
+      state.pendingMsbControllerNumber = controllerNumber;
+      state.pendingMsbTimestamp = timestamp;
+      return boost::none;
+    }
+    const bool isLsb = controllerNumber < 64;
+    const bool completesPair = isLsb && state.pendingMsbControllerNumber == controllerNumber - 32
+        && timestamp - state.pendingMsbTimestamp <= MAX_PART_INTERVAL;
+    state.pendingMsbControllerNumber = -1;
+    // Some controllers send only the LSB if the MSB didn't change
+    if (completesPair || (isLsb && isPartOfHighResolutionMessage(channel, controllerNumber))) {
+      markAsPartOfHighResolutionMessage(channel, controllerNumber - 32);
+      markAsPartOfHighResolutionMessage(channel, controllerNumber);
+      SourceDescriptor descriptor;
+      descriptor.type = SourceType::ControlChangeValue;
+      descriptor.channel = channel;
+      descriptor.midiMessageNumber = controllerNumber - 32;
+      descriptor.is14Bit = true;
+      return descriptor;
+    }
+    return boost::none;
+  }
+
+  bool HighResolutionCcDetector::isPartOfHighResolutionMessage(int channel, int controllerNumber) const {
+    const auto& word = highResolutionControllerNumbers_.at(channel * 2 + controllerNumber / 64);
+    return (word.load(std::memory_order_acquire) & (std::uint64_t(1) << (controllerNumber % 64))) != 0;
+  }
+
+  void HighResolutionCcDetector::reset() {
+    channelStates_ = {};
+    for (auto& word : highResolutionControllerNumbers_) {
+      word.store(0, std::memory_order_release);
+    }
+  }
+
+  void HighResolutionCcDetector::markAsPartOfHighResolutionMessage(int channel, int controllerNumber) {
+    auto& word = highResolutionControllerNumbers_.at(channel * 2 + controllerNumber / 64);
+    word.fetch_or(std::uint64_t(1) << (controllerNumber % 64), std::memory_order_acq_rel);
+  }
+
+  bool HighResolutionCcDetector::parameterNumberIsSelected(const ChannelState& state) {
+    return state.parameterNumberMsb != -1 && state.parameterNumberLsb != -1 &&
+        // RPN null
+        !(state.isRegistered && state.parameterNumberMsb == 127 && state.parameterNumberLsb == 127);
+  }
+
+  boost::optional<SourceDescriptor> HighResolutionCcDetector::takePendingDataEntryMsb(int channel,
+      ChannelState& state) {
+    if (!state.dataEntryMsbIsPending) {
+      return boost::none;
+    }
+    state.dataEntryMsbIsPending = false;
+    return describeParameterNumberSource(channel, state, false);
+  }
+
+  boost::optional<SourceDescriptor> HighResolutionCcDetector::describeParameterNumberSource(int channel,
+      const ChannelState& state, bool is14Bit) {
+    SourceDescriptor descriptor;
+    descriptor.type = SourceType::ParameterNumberMessageValue;
+    descriptor.channel = channel;
+    descriptor.parameterNumberMessageNumber = (state.parameterNumberMsb << 7) | state.parameterNumberLsb;
+    descriptor.isRegistered = state.isRegistered;
+    descriptor.is14Bit = is14Bit;
+    return descriptor;
+  }
+}
@@ -0,0 +1,74 @@
+#include <helgoboss-learn/LatencyHistogram.h>
+#include <algorithm>
+#include <cmath>
+
+namespace helgoboss {
+  std::uint64_t LatencyHistogram::getCount() const {
+    return count_.load(std::memory_order_relaxed);
+  }
+
+  std::uint64_t LatencyHistogram::getMin() const {
+    return getCount() == 0 ? 0 : min_.load(std::memory_order_relaxed);
+  }
+
+  std::uint64_t LatencyHistogram::getMax() const {
+    return max_.load(std::memory_order_relaxed);
+  }
+
+  double LatencyHistogram::getMean() const {
+    const auto count = getCount();
+    return count == 0 ? 0 : static_cast<double>(sum_.load(std::memory_order_relaxed)) / count;
+  }
+
+  std::uint64_t LatencyHistogram::getValueAtPercentile(double percentile) const {
+    const auto count = getCount();
+    if (count == 0) {
+      return 0;
+    }
+    const double clampedPercentile = std::min(std::max(percentile, 0.0), 100.0);
+    const auto requiredCount = std::max(
+        static_cast<std::uint64_t>(std::ceil(clampedPercentile / 100 * count)), static_cast<std::uint64_t>(1));
+    std::uint64_t cumulativeCount = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT; i++) {
+      cumulativeCount += buckets_[i].load(std::memory_order_relaxed);
+      if (cumulativeCount >= requiredCount) {
+        return std::min(getHighestValueInBucket(i), getMax());
+      }
+    }
+    // Only reachable if record() ran concurrently
+    return getMax();
+  }
+
+  nlohmann::json LatencyHistogram::exportToJson() const {
+    return {
+        {"count", getCount()},
+        {"min", getMin()},
+        {"max", getMax()},
+        {"mean", getMean()},
+        {"p50", getValueAtPercentile(50)},
+        {"p90", getValueAtPercentile(90)},
+        {"p99", getValueAtPercentile(99)},
+        {"p999", getValueAtPercentile(99.9)}
+    };
+  }
+
+  void LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+  }
+
+  std::uint64_t LatencyHistogram::getHighestValueInBucket(std::size_t index) {
+    if (index < SUB_BUCKET_COUNT) {
+      return index;
+    }
+    const auto shift = static_cast<int>(index / SUB_BUCKET_COUNT) - 1;
+    const auto subBucket = index % SUB_BUCKET_COUNT;
+    const std::uint64_t lowestValue = (SUB_BUCKET_COUNT + subBucket) << shift;
+    return lowestValue + ((std::uint64_t(1) << shift) - 1);
+  }
+}
@@ -0,0 +1,54 @@
+#include <helgoboss-learn/LatencyTracer.h>
+#include <chrono>
+
+namespace helgoboss {
+  namespace {
+    std::uint64_t getSteadyClockNanos() {
+      return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+  }
+
+  LatencyTracer::LatencyTracer() : LatencyTracer(getSteadyClockNanos) {
+  }
+
+  LatencyTracer::LatencyTracer(LatencyClock clock) : clock_(std::move(clock)) {
+  }
+
+  nlohmann::json LatencyTracer::exportToJson() const {
+    auto j = nlohmann::json::object();
+    for (std::size_t i = 0; i < NUM_LATENCY_STAGES; i++) {
+      j[util::getLatencyStageName(static_cast<LatencyStage>(i))] = histograms_[i].exportToJson();
+    }
+    return j;
+  }
+
+  void LatencyTracer::reset() {
+    for (auto& histogram : histograms_) {
+      histogram.reset();
+    }
+  }
+
+  namespace util {
+    const char* getLatencyStageName(LatencyStage stage) {
+      switch (stage) {
+        case LatencyStage::Match:
+          return "match";
+        case LatencyStage::Normalize:
+          return "normalize";
+        case LatencyStage::ModeTransform:
+          return "modeTransform";
+        case LatencyStage::Eel:
+          return "eel";
+        case LatencyStage::Hit:
+          return "hit";
+        case LatencyStage::EndToEnd:
+          return "endToEnd";
+        case LatencyStage::Feedback:
+          return "feedback";
+        default:
+          return "";
+      }
+    }
+  }
+}
@@ -0,0 +1,95 @@
+#include <helgoboss-learn/MappedFile.h>
+#include <system_error>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace helgoboss {
+#ifdef _WIN32
+  MappedFile::MappedFile(const std::string& path) {
+    const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+      throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "Couldn't open " + path);
+    }
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) {
+      const auto error = GetLastError();
+      CloseHandle(file);
+      throw std::system_error(static_cast<int>(error), std::system_category(), "Couldn't get size of " + path);
+    }
+    size_ = static_cast<std::size_t>(fileSize.QuadPart);
+    if (size_ == 0) {
+      // Empty files can't be mapped
+      CloseHandle(file);
+      return;
+    }
+    const HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    // The mapping keeps the file open
+    CloseHandle(file);
+    if (mapping == nullptr) {
+      throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "Couldn't map " + path);
+    }
+    data_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    // The view keeps the mapping alive
+    CloseHandle(mapping);
+    if (data_ == nullptr) {
+      throw std::system_error(static_cast<int>(GetLastError()), std::system_category(), "Couldn't map " + path);
+    }
+  }
+
+  MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+      UnmapViewOfFile(data_);
+    }
+  }
+#else
+  MappedFile::MappedFile(const std::string& path) {
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd == -1) {
+      throw std::system_error(errno, std::generic_category(), "Couldn't open " + path);
+    }
+    struct stat fileStatus{};
+    if (fstat(fd, &fileStatus) == -1) {
+      const auto error = errno;
+      close(fd);
+      throw std::system_error(error, std::generic_category(), "Couldn't get size of " + path);
+    }
+    size_ = static_cast<std::size_t>(fileStatus.st_size);
+    if (size_ == 0) {
+      // Empty files can't be mapped
+      close(fd);
+      return;
+    }
+    void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    const auto error = errno;
+    // The mapping keeps the file open
+    close(fd);
+    if (data == MAP_FAILED) {
+      throw std::system_error(error, std::generic_category(), "Couldn't map " + path);
+    }
+    data_ = data;
+  }
+
+  MappedFile::~MappedFile() {
+    if (data_ != nullptr) {
+      munmap(const_cast<void*>(data_), size_);
+    }
+  }
+#endif
+
+  const void* MappedFile::getData() const {
+    return data_;
+  }
+
+  std::size_t MappedFile::getSize() const {
+    return size_;
+  }
+}
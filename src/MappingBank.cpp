@@ -0,0 +1,207 @@
+#include <helgoboss-learn/MappingBank.h>
+#include <algorithm>
+#include <gsl/gsl>
+
+namespace {
+  // Kinds of short MIDI messages, as bits so that one mapping can accept several of them
+  enum EventKind : std::uint8_t {
+    NoEvent = 0,
+    NoteOnEvent = 1 << 0,
+    NoteOffEvent = 1 << 1,
+    ControlChangeEvent = 1 << 2,
+    PitchBendChangeEvent = 1 << 3,
+    ChannelPressureEvent = 1 << 4,
+    ProgramChangeEvent = 1 << 5,
+    PolyphonicKeyPressureEvent = 1 << 6
+  };
+
+  std::uint8_t getEventKind(const helgoboss::MidiMessage& msg) {
+    using helgoboss::MidiMessageType;
+    switch (msg.getType()) {
+      case MidiMessageType::NoteOn:
+        return NoteOnEvent;
+      case MidiMessageType::NoteOff:
+        return NoteOffEvent;
+      case MidiMessageType::ControlChange:
+        return ControlChangeEvent;
+      case MidiMessageType::PitchBendChange:
+        return PitchBendChangeEvent;
+      case MidiMessageType::ChannelPressure:
+        return ChannelPressureEvent;
+      case MidiMessageType::ProgramChange:
+        return ProgramChangeEvent;
+      case MidiMessageType::PolyphonicKeyPressure:
+        return PolyphonicKeyPressureEvent;
+      default:
+        return NoEvent;
+    }
+  }
+
+  // Mirrors SourceProcessor::processes() for sources which react to short MIDI messages only. Returns NoEvent for all
+  // other sources.
+  std::uint8_t getAcceptedEventKinds(const helgoboss::Source& source) {
+    using helgoboss::SourceType;
+    switch (source.type.get()) {
+      case SourceType::ControlChangeValue:
+        return source.is14Bit.get() ? NoEvent : ControlChangeEvent;
+      case SourceType::NoteVelocity:
+        return NoteOnEvent | NoteOffEvent;
+      case SourceType::NoteKeyNumber:
+        return NoteOnEvent;
+      case SourceType::PitchBendChangeValue:
+        return PitchBendChangeEvent;
+      case SourceType::ChannelPressureAmount:
+        return ChannelPressureEvent;
+      case SourceType::ProgramChangeNumber:
+        return ProgramChangeEvent;
+      case SourceType::PolyphonicKeyPressureAmount:
+        return PolyphonicKeyPressureEvent;
+      default:
+        return NoEvent;
+    }
+  }
+
+  bool considersNumber(helgoboss::SourceType type) {
+    using helgoboss::SourceType;
+    switch (type) {
+      case SourceType::ControlChangeValue:
+      case SourceType::NoteVelocity:
+      case SourceType::PolyphonicKeyPressureAmount:
+        return true;
+      default:
+        return false;
+    }
+  }
+}
+
+namespace helgoboss {
+  MappingBank::~MappingBank() {
+    for (const auto& subscription : subscriptions_) {
+      subscription.unsubscribe();
+    }
+  }
+
+  std::size_t MappingBank::addMapping(const Source& source, Mode& mode, Target& target) {
+    mode.warmUp();
+    const auto mappingIndex = sources_.size();
+    sources_.push_back(&source);
+    modes_.push_back(&mode);
+    targets_.push_back(&target);
+    acceptedEventKinds_.push_back(NoEvent);
+    channels_.push_back(-1);
+    numbers_.push_back(-1);
+    sourceProcessors_.push_back(source.createProcessor());
+    absoluteModeSettings_.emplace_back();
+    processedByBank_.push_back(0);
+    updateMapping(mappingIndex);
+    subscriptions_.push_back(source.changed().merge(mode.changed()).subscribe([this, mappingIndex](bool) {
+      updateMapping(mappingIndex);
+    }));
+    return mappingIndex;
+  }
+
+  std::size_t MappingBank::getMappingCount() const {
+    return sources_.size();
+  }
+
+  std::size_t MappingBank::process(const SourceValue& value) {
+    matchedMappingIndexes_.clear();
+    if (value.getType() == SourceValueType::MidiMessage) {
+      routeMidiMessage(value.getAsMidiMessage());
+    }
+    const auto routedMatchCount = matchedMappingIndexes_.size();
+    for (const auto i : unroutedMappingIndexes_) {
+      // Counted in processMatchedMapping()
+      if (sourceProcessors_[i].matches(value)) {
+        matchedMappingIndexes_.push_back(i);
+      }
+    }
+    if (routedMatchCount > 0 && matchedMappingIndexes_.size() > routedMatchCount) {
+      std::inplace_merge(matchedMappingIndexes_.begin(), matchedMappingIndexes_.begin() + routedMatchCount,
+          matchedMappingIndexes_.end());
+    }
+    for (const auto i : matchedMappingIndexes_) {
+      processMatchedMapping(i, value);
+    }
+    return matchedMappingIndexes_.size();
+  }
+
+  void MappingBank::updateMapping(std::size_t mappingIndex) {
+    Expects(mappingIndex < sources_.size());
+    const auto i = mappingIndex;
+    const auto& source = *sources_[i];
+    auto& mode = *modes_[i];
+    acceptedEventKinds_[i] = getAcceptedEventKinds(source);
+    channels_[i] = static_cast<std::int8_t>(source.channel.get());
+    numbers_[i] = considersNumber(source.type.get()) ? static_cast<std::int8_t>(source.midiMessageNumber.get()) : -1;
+    // The source's own processor might not be up-to-date yet if the change is part of a batch
+    sourceProcessors_[i] = source.createProcessor();
+    const bool isRouted = acceptedEventKinds_[i] != NoEvent;
+    const auto it = std::lower_bound(unroutedMappingIndexes_.begin(), unroutedMappingIndexes_.end(), i);
+    const bool isListed = it != unroutedMappingIndexes_.end() && *it == i;
+    if (isRouted && isListed) {
+      unroutedMappingIndexes_.erase(it);
+    } else if (!isRouted && !isListed) {
+      unroutedMappingIndexes_.insert(it, i);
+    }
+    absoluteModeSettings_[i] = {
+        mode.minSourceValue.get(),
+        mode.maxSourceValue.get(),
+        mode.minTargetValue.get(),
+        mode.maxTargetValue.get(),
+        mode.minTargetJump.get(),
+        mode.maxTargetJump.get(),
+        mode.reverseIsEnabled.get(),
+        mode.ignoreOutOfRangeSourceValuesIsEnabled.get(),
+        mode.roundTargetValue.get(),
+        mode.scaleModeEnabled.get()
+    };
+    // Decided on the properties because the mode's processor might not be up-to-date yet if the change is part of a
+    // batch. An EEL transformation which doesn't compile is treated like none by the processor as well.
+    processedByBank_[i] =
+        mode.type.get() == ModeType::Absolute && boost::trim_copy(mode.eelControlTransformation.get()).empty();
+  }
+
+  void MappingBank::routeMidiMessage(const MidiMessage& msg) {
+    const auto eventKind = getEventKind(msg);
+    if (eventKind == NoEvent) {
+      return;
+    }
+    const auto channel = static_cast<std::int8_t>(msg.getChannel());
+    const auto number = static_cast<std::int8_t>(msg.getDataByte1());
+    const auto* acceptedEventKinds = acceptedEventKinds_.data();
+    const auto* channels = channels_.data();
+    const auto* numbers = numbers_.data();
+    const auto count = acceptedEventKinds_.size();
+    for (std::size_t i = 0; i < count; i++) {
+      if ((acceptedEventKinds[i] & eventKind) != 0 && (channels[i] == -1 || channels[i] == channel)
+          && (numbers[i] == -1 || numbers[i] == number)) {
+        matchedMappingIndexes_.push_back(i);
+      }
+    }
+  }
+
+  void MappingBank::processMatchedMapping(std::size_t mappingIndex, const SourceValue& value) {
+    if (auto* sourceStatistics = sources_[mappingIndex]->getStatistics()) {
+      sourceStatistics->countMatchedEvent();
+    }
+    const auto& sourceProcessor = sourceProcessors_[mappingIndex];
+    auto& target = *targets_[mappingIndex];
+    auto& mode = *modes_[mappingIndex];
+    const double normalizedSourceValue = sourceProcessor.getNormalizedValue(value);
+    if (processedByBank_[mappingIndex] != 0) {
+      internal::processSourceValueInAbsoluteMode(
+          absoluteModeSettings_[mappingIndex],
+          normalizedSourceValue,
+          [](double normalizedValue) {
+            return normalizedValue;
+          },
+          target,
+          mode.getStatistics(),
+          mode.getLatencyTracer()
+      );
+    } else {
+      mode.getProcessor().processSourceValue(normalizedSourceValue, sourceProcessor, target);
+    }
+  }
+}
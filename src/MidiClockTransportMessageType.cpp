@@ -2,6 +2,21 @@
 #include <gsl/gsl>
 
 namespace helgoboss {
+  namespace internal {
+    const char* getMidiClockTransportMessageTypeLabel(MidiClockTransportMessageType type) {
+      switch (type) {
+        case MidiClockTransportMessageType::Start:
+          return "Start";
+        case MidiClockTransportMessageType::Continue:
+          return "Continue";
+        case MidiClockTransportMessageType::Stop:
+          return "Stop";
+        default:
+          Expects(false);
+      }
+    }
+  }
+
   namespace util {
     boost::optional<MidiMessageType> mapMidiClockTransportMessageTypeToMidiMessageType(MidiClockTransportMessageType type) {
       switch (type) {
@@ -16,16 +31,7 @@ namespace helgoboss {
       }
     }
     std::string getMidiClockTransportMessageTypeLabel(MidiClockTransportMessageType type) {
-      switch (type) {
-        case MidiClockTransportMessageType::Start:
-          return "Start";
-        case MidiClockTransportMessageType::Continue:
-          return "Continue";
-        case MidiClockTransportMessageType::Stop:
-          return "Stop";
-        default:
-          Expects(false);
-      }
+      return internal::getMidiClockTransportMessageTypeLabel(type);
     }
     std::string serializeMidiClockTransportMessageType(MidiClockTransportMessageType midiClockTransportMessageType) {
       switch (midiClockTransportMessageType) {
@@ -1,5 +1,7 @@
 #include <helgoboss-learn/Mode.h>
 
+// EEL also calls these when executing code, so they must not block. Compilation is serialized by
+// internal::getEelCompilationMutex() instead.
 void NSEEL_HOSTSTUB_EnterMutex() {}
 void NSEEL_HOSTSTUB_LeaveMutex() {}
 
@@ -0,0 +1,61 @@
+#include <helgoboss-learn/ModeConfigPool.h>
+
+namespace {
+  // Equal settings must have equal hashes, but std::hash distinguishes 0.0 from -0.0
+  double normalizeZero(double value) {
+    return value == 0.0 ? 0.0 : value;
+  }
+}
+
+namespace helgoboss {
+  namespace internal {
+    std::size_t ModeConfigHash::operator()(const std::shared_ptr<const ModeConfig>& config) const {
+      std::size_t h = 0;
+      h = combineHash(h, static_cast<int>(config->type));
+      h = combineHash(h, normalizeZero(config->minTargetValue));
+      h = combineHash(h, normalizeZero(config->maxTargetValue));
+      h = combineHash(h, normalizeZero(config->minSourceValue));
+      h = combineHash(h, normalizeZero(config->maxSourceValue));
+      h = combineHash(h, config->reverseIsEnabled);
+      h = combineHash(h, config->ignoreOutOfRangeSourceValuesIsEnabled);
+      h = combineHash(h, normalizeZero(config->minTargetJump));
+      h = combineHash(h, normalizeZero(config->maxTargetJump));
+      h = combineHash(h, config->roundTargetValue);
+      h = combineHash(h, config->scaleModeEnabled);
+      h = combineHash(h, normalizeZero(config->minStepSize));
+      h = combineHash(h, normalizeZero(config->maxStepSize));
+      h = combineHash(h, config->rotateIsEnabled);
+      h = combineHash(h, config->eelControlTransformation);
+      return h;
+    }
+  }
+
+  ModeProcessor ModeConfigPool::intern(ModeProcessor processor) {
+    if (processor.config_->hasEelControlTransformation()) {
+      // The EEL variables are written on each execution, so such configurations are never shared
+      return processor;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    processor.config_ = *configs_.insert(processor.config_).first;
+    return processor;
+  }
+
+  std::size_t ModeConfigPool::getConfigCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return configs_.size();
+  }
+
+  std::size_t ModeConfigPool::removeUnusedConfigs() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::size_t removedCount = 0;
+    for (auto it = configs_.begin(); it != configs_.end();) {
+      if (it->use_count() == 1) {
+        it = configs_.erase(it);
+        removedCount++;
+      } else {
+        ++it;
+      }
+    }
+    return removedCount;
+  }
+}
@@ -9,4 +9,9 @@ namespace helgoboss::internal {
       return std::round(value / stepSize) * stepSize;
     }
   }
+
+  std::mutex& getEelCompilationMutex() {
+    static std::mutex mutex;
+    return mutex;
+  }
 }
\ No newline at end of file
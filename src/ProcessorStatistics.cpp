@@ -0,0 +1,43 @@
+#include <helgoboss-learn/ProcessorStatistics.h>
+
+namespace helgoboss {
+  std::string ProcessorStatisticsSnapshot::toString() const {
+    return "matched=" + std::to_string(matchedEventCount)
+        + " outOfRange=" + std::to_string(outOfRangeEventCount)
+        + " hits=" + std::to_string(targetHitCount)
+        + " suppressedJumps=" + std::to_string(suppressedJumpCount)
+        + " feedback=" + std::to_string(feedbackMessageCount)
+        + " controlEel=" + std::to_string(controlTransformationCount)
+        + "/" + std::to_string(controlTransformationNanos) + "ns"
+        + " feedbackEel=" + std::to_string(feedbackTransformationCount)
+        + "/" + std::to_string(feedbackTransformationNanos) + "ns";
+  }
+
+  ProcessorStatisticsSnapshot operator-(const ProcessorStatisticsSnapshot& lhs, const ProcessorStatisticsSnapshot& rhs) {
+    ProcessorStatisticsSnapshot result;
+    result.matchedEventCount = lhs.matchedEventCount - rhs.matchedEventCount;
+    result.outOfRangeEventCount = lhs.outOfRangeEventCount - rhs.outOfRangeEventCount;
+    result.targetHitCount = lhs.targetHitCount - rhs.targetHitCount;
+    result.suppressedJumpCount = lhs.suppressedJumpCount - rhs.suppressedJumpCount;
+    result.feedbackMessageCount = lhs.feedbackMessageCount - rhs.feedbackMessageCount;
+    result.controlTransformationCount = lhs.controlTransformationCount - rhs.controlTransformationCount;
+    result.controlTransformationNanos = lhs.controlTransformationNanos - rhs.controlTransformationNanos;
+    result.feedbackTransformationCount = lhs.feedbackTransformationCount - rhs.feedbackTransformationCount;
+    result.feedbackTransformationNanos = lhs.feedbackTransformationNanos - rhs.feedbackTransformationNanos;
+    return result;
+  }
+
+  ProcessorStatisticsSnapshot ProcessorStatistics::getSnapshot() const {
+    ProcessorStatisticsSnapshot snapshot;
+    snapshot.matchedEventCount = matchedEventCount_.load(std::memory_order_relaxed);
+    snapshot.outOfRangeEventCount = outOfRangeEventCount_.load(std::memory_order_relaxed);
+    snapshot.targetHitCount = targetHitCount_.load(std::memory_order_relaxed);
+    snapshot.suppressedJumpCount = suppressedJumpCount_.load(std::memory_order_relaxed);
+    snapshot.feedbackMessageCount = feedbackMessageCount_.load(std::memory_order_relaxed);
+    snapshot.controlTransformationCount = controlTransformationCount_.load(std::memory_order_relaxed);
+    snapshot.controlTransformationNanos = controlTransformationNanos_.load(std::memory_order_relaxed);
+    snapshot.feedbackTransformationCount = feedbackTransformationCount_.load(std::memory_order_relaxed);
+    snapshot.feedbackTransformationNanos = feedbackTransformationNanos_.load(std::memory_order_relaxed);
+    return snapshot;
+  }
+}
@@ -0,0 +1,218 @@
+#include <helgoboss-learn/SessionCapture.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <gsl/gsl>
+
+using helgoboss::internal::SessionCaptureHeader;
+
+namespace {
+  const char MAGIC[8] = {'H', 'L', 'S', 'E', 'S', 'S', 'I', 'O'};
+  constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+  constexpr std::uint8_t PARAMETER_NUMBER_REGISTERED_FLAG = 1;
+  constexpr std::uint8_t PARAMETER_NUMBER_14_BIT_FLAG = 2;
+
+  void appendByte(std::string& out, int byte) {
+    out.push_back(static_cast<char>(static_cast<std::uint8_t>(byte)));
+  }
+
+  void appendVarint(std::string& out, std::uint64_t value) {
+    while (value >= 0x80) {
+      appendByte(out, static_cast<int>((value & 0x7f) | 0x80));
+      value >>= 7;
+    }
+    appendByte(out, static_cast<int>(value));
+  }
+
+  template<typename T>
+  void appendBytes(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  class EventReader {
+  private:
+    const char* data_;
+    std::size_t size_;
+    std::size_t offset_ = 0;
+  public:
+    EventReader(const char* data, std::size_t size) : data_(data), size_(size) {
+    }
+
+    int readByte() {
+      ensureAvailable(1);
+      return static_cast<std::uint8_t>(data_[offset_++]);
+    }
+
+    std::uint64_t readVarint() {
+      std::uint64_t value = 0;
+      for (int shift = 0; shift < 64; shift += 7) {
+        const auto byte = static_cast<std::uint64_t>(readByte());
+        value |= (byte & 0x7f) << shift;
+        if ((byte & 0x80) == 0) {
+          return value;
+        }
+      }
+      throw std::runtime_error("Session capture contains invalid varint");
+    }
+
+    template<typename T>
+    T readBytes() {
+      ensureAvailable(sizeof(T));
+      T value;
+      std::memcpy(&value, data_ + offset_, sizeof(T));
+      offset_ += sizeof(T);
+      return value;
+    }
+
+  private:
+    void ensureAvailable(std::size_t count) const {
+      if (size_ - offset_ < count) {
+        throw std::runtime_error("Session capture is truncated");
+      }
+    }
+  };
+
+  helgoboss::SourceValue readSourceValue(EventReader& reader) {
+    using helgoboss::SourceValue;
+    using helgoboss::SourceValueType;
+    switch (static_cast<SourceValueType>(reader.readByte())) {
+      case SourceValueType::MidiMessage: {
+        const auto statusByte = reader.readByte();
+        const auto dataByte1 = reader.readByte();
+        const auto dataByte2 = reader.readByte();
+        return SourceValue(helgoboss::MidiMessage(statusByte, dataByte1, dataByte2));
+      }
+      case SourceValueType::MidiParameterNumberMessage: {
+        const auto channel = reader.readByte();
+        const auto flags = reader.readByte();
+        const auto number = static_cast<int>(reader.readVarint());
+        const auto value = static_cast<int>(reader.readVarint());
+        return SourceValue(helgoboss::MidiParameterNumberMessage(channel, number, value,
+            (flags & PARAMETER_NUMBER_REGISTERED_FLAG) != 0, (flags & PARAMETER_NUMBER_14_BIT_FLAG) != 0));
+      }
+      case SourceValueType::Midi14BitCcMessage: {
+        const auto channel = reader.readByte();
+        const auto msbControllerNumber = reader.readByte();
+        const auto value = static_cast<int>(reader.readVarint());
+        return SourceValue(helgoboss::Midi14BitCcMessage(channel, msbControllerNumber, value));
+      }
+      case SourceValueType::TempoMessage:
+        return SourceValue(helgoboss::TempoMessage{reader.readBytes<double>()});
+      default:
+        throw std::runtime_error("Session capture contains unknown source value type");
+    }
+  }
+}
+
+namespace helgoboss {
+  SessionRecorder::SessionRecorder(const std::vector<ConstMappingRef>& mappings, std::size_t expectedEventCount) :
+      preset_(util::serializeMappingsToBinary(mappings)) {
+    // Enough for channel messages with short time deltas
+    events_.reserve(expectedEventCount * 6);
+  }
+
+  void SessionRecorder::record(std::uint64_t timestamp, const SourceValue& value) {
+    Expects(timestamp >= lastTimestamp_);
+    appendVarint(events_, timestamp - lastTimestamp_);
+    lastTimestamp_ = timestamp;
+    appendByte(events_, static_cast<int>(value.getType()));
+    switch (value.getType()) {
+      case SourceValueType::MidiMessage: {
+        const auto& msg = value.getAsMidiMessage();
+        appendByte(events_, msg.getStatusByte());
+        appendByte(events_, msg.getDataByte1());
+        appendByte(events_, msg.getDataByte2());
+        break;
+      }
+      case SourceValueType::MidiParameterNumberMessage: {
+        const auto& msg = value.getAsMidiParameterNumberMessage();
+        appendByte(events_, msg.getChannel());
+        appendByte(events_, (msg.isRegistered() ? PARAMETER_NUMBER_REGISTERED_FLAG : 0)
+            | (msg.is14bit() ? PARAMETER_NUMBER_14_BIT_FLAG : 0));
+        appendVarint(events_, static_cast<std::uint64_t>(msg.getNumber()));
+        appendVarint(events_, static_cast<std::uint64_t>(msg.getValue()));
+        break;
+      }
+      case SourceValueType::Midi14BitCcMessage: {
+        const auto& msg = value.getAsMidi14BitCcMessage();
+        appendByte(events_, msg.getChannel());
+        appendByte(events_, msg.getMsbControllerNumber());
+        appendVarint(events_, static_cast<std::uint64_t>(msg.getValue()));
+        break;
+      }
+      case SourceValueType::TempoMessage:
+        appendBytes(events_, value.getAsTempoMessage().bpm);
+        break;
+    }
+    eventCount_ += 1;
+  }
+
+  std::uint64_t SessionRecorder::getEventCount() const {
+    return eventCount_;
+  }
+
+  std::string SessionRecorder::toBytes() const {
+    SessionCaptureHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = SessionCaptureView::VERSION;
+    header.byteOrderMark = BYTE_ORDER_MARK;
+    header.presetSize = preset_.size();
+    header.eventCount = eventCount_;
+    std::string out;
+    out.reserve(sizeof(header) + preset_.size() + events_.size());
+    appendBytes(out, header);
+    out += preset_;
+    out += events_;
+    return out;
+  }
+
+  void SessionRecorder::writeToFile(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    const auto bytes = toBytes();
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!file) {
+      throw std::runtime_error("Couldn't write session capture to " + path);
+    }
+  }
+
+  SessionCaptureView::SessionCaptureView(const void* data, std::size_t size) :
+      data_(static_cast<const char*>(data)),
+      size_(size),
+      header_(EventReader(data_, size_).readBytes<SessionCaptureHeader>()) {
+    if (std::memcmp(header_.magic, MAGIC, sizeof(MAGIC)) != 0) {
+      throw std::runtime_error("Not a session capture");
+    }
+    if (header_.version != VERSION) {
+      throw std::runtime_error("Unsupported session capture version");
+    }
+    if (header_.byteOrderMark != BYTE_ORDER_MARK) {
+      throw std::runtime_error("Session capture has been written on a machine with different byte order");
+    }
+    if (header_.presetSize > size_ - sizeof(SessionCaptureHeader)) {
+      throw std::runtime_error("Session capture is truncated");
+    }
+  }
+
+  BinaryPresetView SessionCaptureView::getPreset() const {
+    return BinaryPresetView(data_ + sizeof(SessionCaptureHeader), static_cast<std::size_t>(header_.presetSize));
+  }
+
+  std::uint64_t SessionCaptureView::getEventCount() const {
+    return header_.eventCount;
+  }
+
+  std::vector<CapturedEvent> SessionCaptureView::readEvents() const {
+    const auto eventsOffset = sizeof(SessionCaptureHeader) + static_cast<std::size_t>(header_.presetSize);
+    EventReader reader(data_ + eventsOffset, size_ - eventsOffset);
+    std::vector<CapturedEvent> events;
+    // Each event takes at least 2 bytes, so a corrupt event count can't make us reserve a huge amount of memory
+    events.reserve(static_cast<std::size_t>(std::min<std::uint64_t>(header_.eventCount, (size_ - eventsOffset) / 2)));
+    std::uint64_t timestamp = 0;
+    for (std::uint64_t i = 0; i < header_.eventCount; i++) {
+      timestamp += reader.readVarint();
+      events.push_back({timestamp, readSourceValue(reader)});
+    }
+    return events;
+  }
+}
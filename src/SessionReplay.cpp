@@ -0,0 +1,163 @@
+#include <helgoboss-learn/SessionReplay.h>
+#include <helgoboss-learn/LatencyTracer.h>
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/Source.h>
+#include <helgoboss-learn/SourceContext.h>
+#include <helgoboss-learn/Target.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace {
+  constexpr std::uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+  constexpr std::uint64_t FNV_PRIME = 1099511628211ULL;
+  // Applied when a relative mode hits the target with step counts
+  constexpr double STEP_SIZE = 0.01;
+
+  class Checksum {
+  private:
+    std::uint64_t hash_ = FNV_OFFSET_BASIS;
+  public:
+    template<typename T>
+    void add(const T& value) {
+      unsigned char bytes[sizeof(T)];
+      std::memcpy(bytes, &value, sizeof(T));
+      for (const auto byte : bytes) {
+        hash_ = (hash_ ^ byte) * FNV_PRIME;
+      }
+    }
+
+    std::uint64_t get() const {
+      return hash_;
+    }
+  };
+
+  class ReplayTarget : public helgoboss::Target {
+  private:
+    std::uint32_t mappingIndex_;
+    Checksum& checksum_;
+    std::uint64_t& hitCount_;
+    double value_ = 0;
+  public:
+    ReplayTarget(std::uint32_t mappingIndex, Checksum& checksum, std::uint64_t& hitCount) :
+        mappingIndex_(mappingIndex), checksum_(checksum), hitCount_(hitCount) {
+    }
+
+    helgoboss::TargetCharacter getCharacter() const override {
+      return helgoboss::TargetCharacter::Continuous;
+    }
+    double getStepSize() const override {
+      return -1;
+    }
+    bool wantsToBeHitWithStepCounts() const override {
+      return false;
+    }
+    void hit(double normalizedValue, bool isStepCount) override {
+      value_ = std::min(std::max(isStepCount ? value_ + normalizedValue * STEP_SIZE : normalizedValue, 0.0), 1.0);
+      checksum_.add(mappingIndex_);
+      checksum_.add(value_);
+      hitCount_ += 1;
+    }
+    double getCurrentValue() const override {
+      return value_;
+    }
+    int getMaxStepCount() const override {
+      return -1;
+    }
+    bool canBeDiscrete() const override {
+      return false;
+    }
+  };
+
+  class ReplaySourceContext : public helgoboss::SourceContext {
+  private:
+    Checksum& checksum_;
+    std::uint64_t& messageCount_;
+  public:
+    ReplaySourceContext(Checksum& checksum, std::uint64_t& messageCount) :
+        checksum_(checksum), messageCount_(messageCount) {
+    }
+
+    void processMidiFeedback(const void* source, const helgoboss::MidiMessage& message) override {
+      checksum_.add(static_cast<std::uint8_t>(message.getStatusByte()));
+      checksum_.add(static_cast<std::uint8_t>(message.getDataByte1()));
+      checksum_.add(static_cast<std::uint8_t>(message.getDataByte2()));
+      messageCount_ += 1;
+    }
+    void processMidiFeedbackTwo(const void* source, const std::array<helgoboss::MidiMessage, 2>& messages) override {
+      processMidiFeedback(source, messages[0]);
+      processMidiFeedback(source, messages[1]);
+    }
+  };
+}
+
+namespace helgoboss {
+  double SessionReplayResult::getEventsPerSecond() const {
+    return elapsedSeconds > 0 ? eventCount / elapsedSeconds : 0;
+  }
+
+  nlohmann::json SessionReplayResult::toJson() const {
+    return {
+        {"eventCount", eventCount},
+        {"mappingCount", mappingCount},
+        {"targetHitCount", targetHitCount},
+        {"feedbackMessageCount", feedbackMessageCount},
+        {"elapsedSeconds", elapsedSeconds},
+        {"eventsPerSecond", getEventsPerSecond()},
+        // As strings because not all JSON readers can handle 64-bit integers
+        {"controlChecksum", std::to_string(controlChecksum)},
+        {"feedbackChecksum", std::to_string(feedbackChecksum)},
+        {"latencies", latencies}
+    };
+  }
+
+  namespace util {
+    SessionReplayResult replaySession(const SessionCaptureView& capture, bool withFeedback) {
+      const auto preset = capture.getPreset();
+      const auto mappingCount = preset.getMappingCount();
+      // Sources and modes must not be moved after construction, so they are created in place
+      std::vector<Source> sources(mappingCount);
+      std::vector<Mode> modes(mappingCount);
+      std::vector<MappingRef> mappingRefs;
+      mappingRefs.reserve(mappingCount);
+      for (std::size_t i = 0; i < mappingCount; i++) {
+        mappingRefs.push_back({&sources[i], &modes[i]});
+      }
+      preset.loadMappings(mappingRefs);
+      const auto events = capture.readEvents();
+      SessionReplayResult result;
+      result.eventCount = events.size();
+      result.mappingCount = mappingCount;
+      Checksum controlChecksum;
+      Checksum feedbackChecksum;
+      std::vector<ReplayTarget> targets;
+      targets.reserve(mappingCount);
+      for (std::size_t i = 0; i < mappingCount; i++) {
+        targets.emplace_back(static_cast<std::uint32_t>(i), controlChecksum, result.targetHitCount);
+      }
+      ReplaySourceContext context(feedbackChecksum, result.feedbackMessageCount);
+      LatencyTracer tracer;
+      for (auto& mode : modes) {
+        mode.setLatencyTracer(&tracer);
+      }
+      const auto start = std::chrono::steady_clock::now();
+      for (const auto& event : events) {
+        const auto arrivalTimestamp = tracer.now();
+        for (std::size_t i = 0; i < mappingCount; i++) {
+          auto& target = targets[i];
+          const auto hitCountBefore = result.targetHitCount;
+          modes[i].getProcessor().processTraced(event.value, arrivalTimestamp, sources[i].getProcessor(), target);
+          if (withFeedback && result.targetHitCount != hitCountBefore) {
+            TracingSourceContext<ReplaySourceContext> tracingContext(context, tracer, tracer.now());
+            modes[i].feedback(sources[i], target, tracingContext);
+          }
+        }
+      }
+      result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      result.controlChecksum = controlChecksum.get();
+      result.feedbackChecksum = feedbackChecksum.get();
+      result.latencies = tracer.exportToJson();
+      return result;
+    }
+  }
+}
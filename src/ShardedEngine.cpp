@@ -0,0 +1,181 @@
+#include <helgoboss-learn/ShardedEngine.h>
+#include <algorithm>
+#include <iterator>
+#include <gsl/gsl>
+
+using helgoboss::internal::Shard;
+using helgoboss::internal::ShardHit;
+using helgoboss::internal::ShardMapping;
+
+namespace {
+  // Stands in for the real target while a shard is being processed: Answers with the shard's view of the target value
+  // and records hits instead of executing them. Not virtual because the mode processor takes targets as template
+  // parameter.
+  class ShardTarget {
+  private:
+    const helgoboss::Target& target_;
+    Shard& shard_;
+    std::size_t eventIndex_;
+    const ShardMapping& mapping_;
+  public:
+    ShardTarget(const helgoboss::Target& target, Shard& shard, std::size_t eventIndex, const ShardMapping& mapping) :
+        target_(target), shard_(shard), eventIndex_(eventIndex), mapping_(mapping) {
+    }
+
+    helgoboss::TargetCharacter getCharacter() const {
+      return target_.getCharacter();
+    }
+    double getStepSize() const {
+      return target_.getStepSize();
+    }
+    bool wantsToBeHitWithStepCounts() const {
+      return target_.wantsToBeHitWithStepCounts();
+    }
+    void hit(double normalizedValue, bool isStepCount) {
+      shard_.hits.push_back({eventIndex_, mapping_.mappingIndex, mapping_.targetIndex, normalizedValue, isStepCount});
+      // The effect of step counts is up to the target, so the shard's view stays as it is
+      if (!isStepCount) {
+        shard_.targetValues[mapping_.targetIndex] = normalizedValue;
+      }
+    }
+    double getCurrentValue() const {
+      return shard_.targetValues[mapping_.targetIndex];
+    }
+    int getMaxStepCount() const {
+      return target_.getMaxStepCount();
+    }
+    bool canBeDiscrete() const {
+      return target_.canBeDiscrete();
+    }
+  };
+
+  // Union-find over input ports
+  class PortGroups {
+  private:
+    std::unordered_map<int, int> parents_;
+  public:
+    int find(int port) {
+      const auto it = parents_.emplace(port, port).first;
+      if (it->second == port) {
+        return port;
+      }
+      const int root = find(it->second);
+      parents_[port] = root;
+      return root;
+    }
+
+    void unite(int port, int otherPort) {
+      const int root = find(port);
+      const int otherRoot = find(otherPort);
+      if (root != otherRoot) {
+        parents_[otherRoot] = root;
+      }
+    }
+  };
+}
+
+namespace helgoboss {
+  ShardedEngine::ShardedEngine(std::size_t workerCount) : workerPool_(workerCount) {
+    shards_.resize(workerPool_.getWorkerCount());
+  }
+
+  std::size_t ShardedEngine::addMapping(int inputPort, SourceProcessor source, ModeProcessor mode, Target& target) {
+    const auto targetIndex = targetIndexes_.emplace(&target, targets_.size()).first->second;
+    if (targetIndex == targets_.size()) {
+      targets_.push_back(&target);
+    }
+    const auto mappingIndex = mappingCount_++;
+    // A new mapping can connect ports which are in different shards already, so shards are assigned on next process()
+    newMappings_.push_back({inputPort, std::move(source), std::move(mode), targetIndex, mappingIndex});
+    return mappingIndex;
+  }
+
+  std::size_t ShardedEngine::getShardCount() const {
+    return shards_.size();
+  }
+
+  void ShardedEngine::process(const std::vector<PortEvent>& events) {
+    if (!newMappings_.empty()) {
+      assignMappingsToShards();
+    }
+    // Route events to the shard queues
+    for (auto& shard : shards_) {
+      shard.eventIndexes.clear();
+      shard.hits.clear();
+      shard.targetValues.resize(targets_.size());
+    }
+    for (std::size_t i = 0; i < events.size(); i++) {
+      const auto it = shardIndexByPort_.find(events[i].inputPort);
+      if (it != shardIndexByPort_.end()) {
+        shards_[it->second].eventIndexes.push_back(i);
+      }
+    }
+    workerPool_.run([this, &events](std::size_t workerIndex) {
+      processShard(shards_[workerIndex], events);
+    });
+    applyHits();
+  }
+
+  void ShardedEngine::assignMappingsToShards() {
+    std::vector<ShardMapping> mappings = std::move(newMappings_);
+    newMappings_.clear();
+    for (auto& shard : shards_) {
+      std::move(shard.mappings.begin(), shard.mappings.end(), std::back_inserter(mappings));
+      shard.mappings.clear();
+      shard.mappingsByPort.clear();
+    }
+    std::sort(mappings.begin(), mappings.end(), [](const ShardMapping& lhs, const ShardMapping& rhs) {
+      return lhs.mappingIndex < rhs.mappingIndex;
+    });
+    PortGroups portGroups;
+    std::unordered_map<std::size_t, int> firstPortByTarget;
+    for (const auto& mapping : mappings) {
+      const int firstPort = firstPortByTarget.emplace(mapping.targetIndex, mapping.inputPort).first->second;
+      portGroups.unite(firstPort, mapping.inputPort);
+    }
+    shardIndexByPort_.clear();
+    std::unordered_map<int, std::size_t> shardIndexByGroup;
+    for (auto& mapping : mappings) {
+      const int group = portGroups.find(mapping.inputPort);
+      const auto shardIndex = shardIndexByGroup.emplace(group, shardIndexByGroup.size() % shards_.size())
+          .first->second;
+      shardIndexByPort_.emplace(mapping.inputPort, shardIndex);
+      auto& shard = shards_[shardIndex];
+      shard.mappingsByPort[mapping.inputPort].push_back(shard.mappings.size());
+      shard.mappings.push_back(std::move(mapping));
+    }
+  }
+
+  void ShardedEngine::processShard(Shard& shard, const std::vector<PortEvent>& events) {
+    for (const auto& mapping : shard.mappings) {
+      shard.targetValues[mapping.targetIndex] = targets_[mapping.targetIndex]->getCurrentValue();
+    }
+    for (const auto eventIndex : shard.eventIndexes) {
+      const auto& event = events[eventIndex];
+      const auto it = shard.mappingsByPort.find(event.inputPort);
+      Expects(it != shard.mappingsByPort.end());
+      for (const auto mappingIndex : it->second) {
+        auto& mapping = shard.mappings[mappingIndex];
+        if (!mapping.source.processes(event.value)) {
+          continue;
+        }
+        ShardTarget target(*targets_[mapping.targetIndex], shard, eventIndex, mapping);
+        mapping.mode.processSourceValuePreferringFixedPoint(event.value, mapping.source, target);
+      }
+    }
+  }
+
+  void ShardedEngine::applyHits() {
+    mergedHits_.clear();
+    for (const auto& shard : shards_) {
+      mergedHits_.insert(mergedHits_.end(), shard.hits.begin(), shard.hits.end());
+    }
+    // Each mapping hits at most once per event, so this order is total
+    std::sort(mergedHits_.begin(), mergedHits_.end(), [](const ShardHit& lhs, const ShardHit& rhs) {
+      return lhs.eventIndex != rhs.eventIndex ? lhs.eventIndex < rhs.eventIndex : lhs.mappingIndex < rhs.mappingIndex;
+    });
+    for (const auto& hit : mergedHits_) {
+      targets_[hit.targetIndex]->hit(hit.value, hit.isStepCount);
+    }
+  }
+}
@@ -0,0 +1,89 @@
+#include <helgoboss-learn/SourceCharacterClassifier.h>
+#include <algorithm>
+#include <cstdlib>
+
+namespace helgoboss {
+  boost::optional<SourceCharacterGuess> SourceCharacterClassifier::feed(int controlValue) {
+    valueCount_ += 1;
+    if (valueCount_ == 1) {
+      firstValue_ = controlValue;
+    } else {
+      const auto currentDirection = determineDirection(previousValue_, controlValue);
+      const bool directionChanged = valueCount_ > 2 && currentDirection != previousDirection_;
+      if (currentDirection == Direction::None || directionChanged) {
+        // Same value twice or direction changed. Not continuous so it's probably an encoder.
+        continuityIsBroken_ = true;
+        encoderEvidenceCount_ += 1;
+        rangeEvidenceCount_ = 0;
+      } else if (std::abs(controlValue - previousValue_) <= MAX_RANGE_STEP) {
+        rangeEvidenceCount_ += 1;
+      } else {
+        rangeEvidenceCount_ = 0;
+      }
+      previousDirection_ = currentDirection;
+    }
+    previousValue_ = controlValue;
+    if (isConclusive()) {
+      return guess();
+    }
+    return boost::none;
+  }
+
+  SourceCharacterGuess SourceCharacterClassifier::guess() const {
+    if (valueCount_ <= 1) {
+      // Only one message received. Looks like a switch has been pressed and not released.
+      return {SourceCharacter::Switch, valueCount_ == 0 ? 0.0 : 0.5};
+    }
+    if (valueCount_ == 2 && previousValue_ == 0) {
+      // Two messages received and second message has value 0. Looks like a switch has been pressed and released.
+      return {SourceCharacter::Switch, firstValue_ > MAX_RANGE_STEP ? 1.0 : 0.75};
+    }
+    // Switch character is ruled out already
+    if (continuityIsBroken_) {
+      const double evidence = static_cast<double>(encoderEvidenceCount_) / ENCODER_EVIDENCE_THRESHOLD;
+      return {guessEncoderType(), 0.5 + 0.5 * std::min(1.0, evidence)};
+    }
+    // Was continuous until now so it's probably a knob/fader
+    const double evidence = static_cast<double>(rangeEvidenceCount_) / RANGE_EVIDENCE_THRESHOLD;
+    return {SourceCharacter::Range, 0.5 + 0.5 * std::min(1.0, evidence)};
+  }
+
+  int SourceCharacterClassifier::getValueCount() const {
+    return valueCount_;
+  }
+
+  void SourceCharacterClassifier::reset() {
+    *this = SourceCharacterClassifier();
+  }
+
+  bool SourceCharacterClassifier::isConclusive() const {
+    if (valueCount_ == 2 && previousValue_ == 0 && firstValue_ > MAX_RANGE_STEP) {
+      return true;
+    }
+    if (continuityIsBroken_) {
+      return encoderEvidenceCount_ >= ENCODER_EVIDENCE_THRESHOLD;
+    }
+    return rangeEvidenceCount_ >= RANGE_EVIDENCE_THRESHOLD;
+  }
+
+  SourceCharacter SourceCharacterClassifier::guessEncoderType() const {
+    const auto v = firstValue_;
+    if ((v >= 1 && v <= 7) || (v >= 121 && v <= 127)) {
+      return SourceCharacter::Encoder1;
+    } else if (v >= 57 && v <= 71) {
+      return SourceCharacter::Encoder2;
+    } else {
+      return SourceCharacter::Encoder3;
+    }
+  }
+
+  SourceCharacterClassifier::Direction SourceCharacterClassifier::determineDirection(int firstValue, int secondValue) {
+    if (firstValue == secondValue) {
+      return Direction::None;
+    } else if (firstValue < secondValue) {
+      return Direction::Increment;
+    } else {
+      return Direction::Decrement;
+    }
+  }
+}
@@ -0,0 +1,164 @@
+#include <helgoboss-learn/SourceConflictFinder.h>
+#include <algorithm>
+
+namespace {
+  // Sources of different kinds never react to the same message
+  enum OverlapKind {
+    NoKind = -1,
+    SevenBitControlChange,
+    FourteenBitControlChange,
+    // Note velocity and note key number both react to note-on
+    Note,
+    PitchBendChange,
+    ChannelPressure,
+    ProgramChange,
+    PolyphonicKeyPressure,
+    ClockTempo,
+    // Followed by one kind per combination of 14-bit and registered
+    ParameterNumber,
+    // Followed by one kind per transport message type
+    ClockTransport = ParameterNumber + 4
+  };
+
+  std::uint64_t packKindAndChannel(int kind, int channel) {
+    return (static_cast<std::uint64_t>(kind) << 40) | (static_cast<std::uint64_t>(channel + 1) << 20);
+  }
+
+  std::uint64_t packKindAndNumber(int kind, int number) {
+    return (static_cast<std::uint64_t>(kind) << 40) | static_cast<std::uint64_t>(number + 1);
+  }
+
+  std::uint64_t packKey(int kind, int channel, int number) {
+    return packKindAndChannel(kind, channel) | packKindAndNumber(kind, number);
+  }
+}
+
+namespace helgoboss {
+  SourceConflictFinder::SourceConflictFinder(std::vector<const Source*> sources) : sources_(std::move(sources)) {
+    overlapKeys_.reserve(sources_.size());
+    for (std::size_t i = 0; i < sources_.size(); i++) {
+      const auto key = getOverlapKey(*sources_[i]);
+      overlapKeys_.push_back(key);
+      if (key.kind == NoKind) {
+        continue;
+      }
+      indexesByKey_[packKey(key.kind, key.channel, key.number)].push_back(i);
+      indexesByKindAndChannel_[packKindAndChannel(key.kind, key.channel)].push_back(i);
+      indexesByKindAndNumber_[packKindAndNumber(key.kind, key.number)].push_back(i);
+      indexesByKind_[key.kind].push_back(i);
+    }
+  }
+
+  std::vector<std::vector<std::size_t>> SourceConflictFinder::findDuplicates(bool ignoreCustomCharacter,
+      bool ignoreChannel) const {
+    const auto hash = [ignoreCustomCharacter, ignoreChannel](const Source* source) {
+      return source->hash(ignoreCustomCharacter, ignoreChannel);
+    };
+    const auto equal = [ignoreCustomCharacter, ignoreChannel](const Source* lhs, const Source* rhs) {
+      return lhs->equals(*rhs, ignoreCustomCharacter, ignoreChannel);
+    };
+    std::unordered_map<const Source*, std::vector<std::size_t>, decltype(hash), decltype(equal)>
+        indexesBySource(sources_.size(), hash, equal);
+    for (std::size_t i = 0; i < sources_.size(); i++) {
+      indexesBySource[sources_[i]].push_back(i);
+    }
+    std::vector<std::vector<std::size_t>> groups;
+    for (auto& entry : indexesBySource) {
+      if (entry.second.size() > 1) {
+        groups.push_back(std::move(entry.second));
+      }
+    }
+    std::sort(groups.begin(), groups.end(), [](const std::vector<std::size_t>& lhs, const std::vector<std::size_t>& rhs) {
+      return lhs.front() < rhs.front();
+    });
+    return groups;
+  }
+
+  std::vector<SourceOverlap> SourceConflictFinder::findOverlaps() const {
+    std::vector<SourceOverlap> overlaps;
+    std::vector<std::size_t> laterIndexes;
+    for (std::size_t i = 0; i < sources_.size(); i++) {
+      laterIndexes.clear();
+      forEachOverlappingIndex(overlapKeys_[i], [i, &laterIndexes](std::size_t j) {
+        if (j > i) {
+          laterIndexes.push_back(j);
+        }
+      });
+      std::sort(laterIndexes.begin(), laterIndexes.end());
+      for (const auto j : laterIndexes) {
+        overlaps.push_back({i, j});
+      }
+    }
+    return overlaps;
+  }
+
+  std::vector<std::size_t> SourceConflictFinder::findOverlapsWith(const Source& source) const {
+    std::vector<std::size_t> indexes;
+    forEachOverlappingIndex(getOverlapKey(source), [&indexes](std::size_t i) {
+      indexes.push_back(i);
+    });
+    std::sort(indexes.begin(), indexes.end());
+    return indexes;
+  }
+
+  SourceConflictFinder::OverlapKey SourceConflictFinder::getOverlapKey(const Source& source) {
+    const auto channel = source.channel.get();
+    const auto number = source.midiMessageNumber.get();
+    switch (source.type.get()) {
+      case SourceType::ControlChangeValue:
+        return {source.is14Bit.get() ? FourteenBitControlChange : SevenBitControlChange, channel, number};
+      case SourceType::NoteVelocity:
+        return {Note, channel, number};
+      case SourceType::NoteKeyNumber:
+        return {Note, channel, -1};
+      case SourceType::PitchBendChangeValue:
+        return {PitchBendChange, channel, -1};
+      case SourceType::ChannelPressureAmount:
+        return {ChannelPressure, channel, -1};
+      case SourceType::ProgramChangeNumber:
+        return {ProgramChange, channel, -1};
+      case SourceType::PolyphonicKeyPressureAmount:
+        return {PolyphonicKeyPressure, channel, number};
+      case SourceType::ParameterNumberMessageValue: {
+        const int kind = ParameterNumber + (source.is14Bit.get() ? 1 : 0) + (source.isRegistered.get() ? 2 : 0);
+        return {kind, channel, source.parameterNumberMessageNumber.get()};
+      }
+      case SourceType::ClockTempo:
+        return {ClockTempo, -1, -1};
+      case SourceType::ClockTransport:
+        return {ClockTransport + static_cast<int>(source.midiClockTransportMessageType.get()), -1, -1};
+      default:
+        return {NoKind, -1, -1};
+    }
+  }
+
+  template<typename Consumer>
+  void SourceConflictFinder::forEachOverlappingIndex(const OverlapKey& key, Consumer consumer) const {
+    if (key.kind == NoKind) {
+      return;
+    }
+    const auto consumeAll = [&consumer](const auto& map, const auto& mapKey) {
+      const auto it = map.find(mapKey);
+      if (it != map.end()) {
+        for (const auto i : it->second) {
+          consumer(i);
+        }
+      }
+    };
+    // The looked up sets are disjoint, so each overlapping source is consumed once
+    if (key.channel == -1 && key.number == -1) {
+      consumeAll(indexesByKind_, key.kind);
+    } else if (key.channel == -1) {
+      consumeAll(indexesByKindAndNumber_, packKindAndNumber(key.kind, key.number));
+      consumeAll(indexesByKindAndNumber_, packKindAndNumber(key.kind, -1));
+    } else if (key.number == -1) {
+      consumeAll(indexesByKindAndChannel_, packKindAndChannel(key.kind, key.channel));
+      consumeAll(indexesByKindAndChannel_, packKindAndChannel(key.kind, -1));
+    } else {
+      consumeAll(indexesByKey_, packKey(key.kind, key.channel, key.number));
+      consumeAll(indexesByKey_, packKey(key.kind, -1, key.number));
+      consumeAll(indexesByKey_, packKey(key.kind, key.channel, -1));
+      consumeAll(indexesByKey_, packKey(key.kind, -1, -1));
+    }
+  }
+}
@@ -0,0 +1,45 @@
+#include <helgoboss-learn/SourceDescriptor.h>
+
+namespace helgoboss::util {
+  SourceDescriptor describeSourceOfMidiMessage(const MidiMessage& msg) {
+    SourceDescriptor descriptor;
+    if (msg.getSuperType() != MidiMessageSuperType::Channel) {
+      return descriptor;
+    }
+    if (const auto sourceType = getSourceTypeFromMidiMessageType(msg.getType())) {
+      descriptor.type = *sourceType;
+      descriptor.channel = msg.getChannel();
+      switch (descriptor.type) {
+        // Same as Source::supportsMidiMessageNumber()
+        case SourceType::ControlChangeValue:
+        case SourceType::NoteVelocity:
+        case SourceType::PolyphonicKeyPressureAmount:
+          descriptor.midiMessageNumber = msg.getDataByte1();
+          break;
+        default:
+          break;
+      }
+      descriptor.is14Bit = false;
+    }
+    return descriptor;
+  }
+
+  SourceDescriptor describeSourceOfMidiParameterNumberMessage(const MidiParameterNumberMessage& msg) {
+    SourceDescriptor descriptor;
+    descriptor.type = SourceType::ParameterNumberMessageValue;
+    descriptor.channel = msg.getChannel();
+    descriptor.parameterNumberMessageNumber = msg.getNumber();
+    descriptor.isRegistered = msg.isRegistered();
+    descriptor.is14Bit = msg.is14bit();
+    return descriptor;
+  }
+
+  SourceDescriptor describeSourceOfMidi14BitCcMessage(const Midi14BitCcMessage& msg) {
+    SourceDescriptor descriptor;
+    descriptor.type = SourceType::ControlChangeValue;
+    descriptor.channel = msg.getChannel();
+    descriptor.midiMessageNumber = msg.getMsbControllerNumber();
+    descriptor.is14Bit = true;
+    return descriptor;
+  }
+}
@@ -1,33 +1,22 @@
 #include <helgoboss-learn/Tempo.h>
-#include <algorithm>
 #include <helgoboss-learn/string-util.h>
-#include <helgoboss-learn/math-util.h>
 
 namespace helgoboss {
-  Tempo Tempo::ofNormalizedValue(double normalizedValue) {
-    return Tempo(util::mapNormalizedValueToValueInRange(normalizedValue, 1, 960));
-  }
-
-  Tempo::Tempo(double bpm) {
-    bpm_ = std::max(1.0, std::min(960.0, bpm));
-  }
-
-  double Tempo::normalizedValue() const {
-    return util::mapValueInRangeToNormalizedValue(bpm_, 1, 960);
+  std::string Tempo::toString() const {
+    char buffer[16];
+    return std::string(buffer, toString(buffer, sizeof(buffer)));
   }
 
-  double Tempo::bpm() const {
-    return bpm_;
+  std::string Tempo::toStringWithoutUnit() const {
+    char buffer[16];
+    return std::string(buffer, toStringWithoutUnit(buffer, sizeof(buffer)));
   }
 
-  std::string Tempo::toString() const {
-    return toStringWithoutUnit() + " bpm";
+  std::size_t Tempo::toString(char* buffer, std::size_t bufferSize) const {
+    return util::BufferWriter(buffer, bufferSize).appendFixed(bpm_, 4).append(" bpm").getSize();
   }
 
-  std::string Tempo::toStringWithoutUnit() const {
-    // @closureIsSafe
-    return util::toString(10, [this](char* buffer, int maxSize) {
-      sprintf(buffer, "%.4f", bpm_);
-    });
+  std::size_t Tempo::toStringWithoutUnit(char* buffer, std::size_t bufferSize) const {
+    return util::BufferWriter(buffer, bufferSize).appendFixed(bpm_, 4).getSize();
   }
 }
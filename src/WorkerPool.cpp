@@ -0,0 +1,94 @@
+#include <helgoboss-learn/WorkerPool.h>
+#include <algorithm>
+
+namespace helgoboss {
+  WorkerPool::WorkerPool(std::size_t workerCount) : errors_(std::max(workerCount, std::size_t(1))) {
+    threads_.reserve(errors_.size() - 1);
+    try {
+      for (std::size_t i = 1; i < errors_.size(); i++) {
+        threads_.emplace_back([this, i] {
+          runThread(i);
+        });
+      }
+    } catch (...) {
+      // The destructor isn't called, but joinable threads must not be destroyed
+      stopThreads();
+      throw;
+    }
+  }
+
+  WorkerPool::~WorkerPool() {
+    stopThreads();
+  }
+
+  std::size_t WorkerPool::getWorkerCount() const {
+    return errors_.size();
+  }
+
+  void WorkerPool::run(const Job& job) {
+    std::fill(errors_.begin(), errors_.end(), nullptr);
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      currentJob_ = &job;
+      busyThreadCount_ = threads_.size();
+      jobNumber_ += 1;
+    }
+    jobStarted_.notify_all();
+    runJob(job, 0);
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      jobFinished_.wait(lock, [this] {
+        return busyThreadCount_ == 0;
+      });
+      currentJob_ = nullptr;
+    }
+    for (const auto& error : errors_) {
+      if (error) {
+        std::rethrow_exception(error);
+      }
+    }
+  }
+
+  void WorkerPool::stopThreads() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopped_ = true;
+    }
+    jobStarted_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  void WorkerPool::runThread(std::size_t workerIndex) {
+    std::uint64_t finishedJobNumber = 0;
+    while (true) {
+      const Job* job;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        jobStarted_.wait(lock, [this, finishedJobNumber] {
+          return stopped_ || jobNumber_ != finishedJobNumber;
+        });
+        if (stopped_) {
+          return;
+        }
+        finishedJobNumber = jobNumber_;
+        job = currentJob_;
+      }
+      runJob(*job, workerIndex);
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        busyThreadCount_ -= 1;
+      }
+      jobFinished_.notify_one();
+    }
+  }
+
+  void WorkerPool::runJob(const Job& job, std::size_t workerIndex) {
+    try {
+      job(workerIndex);
+    } catch (...) {
+      errors_[workerIndex] = std::current_exception();
+    }
+  }
+}
@@ -0,0 +1,394 @@
+#include <helgoboss-learn/preset-util.h>
+#include <array>
+#include <charconv>
+#include <stdexcept>
+#include <gsl/gsl>
+
+namespace {
+  // Writes JSON text exactly like nlohmann::json::dump() does. Keys must be written in lexicographic order because
+  // nlohmann::json objects are sorted by key.
+  class JsonWriter {
+  private:
+    std::string& out_;
+    bool needsSeparator_ = false;
+  public:
+    explicit JsonWriter(std::string& out) : out_(out) {
+    }
+
+    void beginArray() {
+      out_ += '[';
+      needsSeparator_ = false;
+    }
+
+    void endArray() {
+      out_ += ']';
+      needsSeparator_ = true;
+    }
+
+    void beginObject() {
+      out_ += '{';
+      needsSeparator_ = false;
+    }
+
+    void endObject() {
+      out_ += '}';
+      needsSeparator_ = true;
+    }
+
+    void separate() {
+      if (needsSeparator_) {
+        out_ += ',';
+      }
+    }
+
+    void key(const char* key) {
+      separate();
+      out_ += '"';
+      out_ += key;
+      out_ += "\":";
+      needsSeparator_ = false;
+    }
+
+    void value(int value) {
+      std::array<char, 16> buffer;
+      const auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), value);
+      out_.append(buffer.data(), result.ptr);
+      needsSeparator_ = true;
+    }
+
+    void value(bool value) {
+      out_ += value ? "true" : "false";
+      needsSeparator_ = true;
+    }
+
+    void value(double value) {
+      // std::to_chars() can choose other digits or a different notation, so nlohmann::json formats it
+      out_ += nlohmann::json(value).dump();
+      needsSeparator_ = true;
+    }
+
+    void value(const std::string& value) {
+      if (needsEscaping(value)) {
+        // Rare case. Let nlohmann::json deal with escape sequences and UTF-8 validation.
+        out_ += nlohmann::json(value).dump();
+      } else {
+        out_ += '"';
+        out_ += value;
+        out_ += '"';
+      }
+      needsSeparator_ = true;
+    }
+
+  private:
+    static bool needsEscaping(const std::string& value) {
+      for (const unsigned char c : value) {
+        if (c < 0x20 || c >= 0x80 || c == '"' || c == '\\') {
+          return true;
+        }
+      }
+      return false;
+    }
+  };
+
+  // Receives SAX events of a JSON array of mappings and builds a small DOM just for the mapping which is currently
+  // being read
+  class MappingSaxHandler {
+  public:
+    using json = nlohmann::json;
+  private:
+    std::function<void(const json& mappingJson)> mappingRead_;
+    bool isInsideArray_ = false;
+    json currentMappingJson_;
+    // Open objects and arrays of the current mapping, innermost last
+    std::vector<json*> openContainers_;
+    std::string currentKey_;
+    // Set if the JSON is well-formed but not an array of mapping objects
+    std::string error_;
+  public:
+    explicit MappingSaxHandler(std::function<void(const json& mappingJson)> mappingRead) :
+        mappingRead_(std::move(mappingRead)) {
+    }
+
+    bool null() {
+      return addValue(nullptr);
+    }
+
+    bool boolean(bool value) {
+      return addValue(value);
+    }
+
+    bool number_integer(json::number_integer_t value) {
+      return addValue(value);
+    }
+
+    bool number_unsigned(json::number_unsigned_t value) {
+      return addValue(value);
+    }
+
+    bool number_float(json::number_float_t value, const json::string_t&) {
+      return addValue(value);
+    }
+
+    bool string(json::string_t& value) {
+      return addValue(std::move(value));
+    }
+
+    // Only called by nlohmann::json versions which support binary values
+    template<typename Binary>
+    bool binary(Binary& value) {
+      return addValue(json::binary(std::move(value)));
+    }
+
+    bool start_object(std::size_t) {
+      if (openContainers_.empty()) {
+        if (!isInsideArray_) {
+          return fail("Expected an array of mappings");
+        }
+        currentMappingJson_ = json::object();
+        openContainers_.push_back(&currentMappingJson_);
+      } else {
+        openContainers_.push_back(addContainer(json::object()));
+      }
+      return true;
+    }
+
+    bool key(json::string_t& key) {
+      currentKey_ = std::move(key);
+      return true;
+    }
+
+    bool end_object() {
+      openContainers_.pop_back();
+      if (openContainers_.empty()) {
+        mappingRead_(currentMappingJson_);
+        // Release memory of the mapping
+        currentMappingJson_ = nullptr;
+      }
+      return true;
+    }
+
+    bool start_array(std::size_t) {
+      if (!isInsideArray_) {
+        isInsideArray_ = true;
+      } else {
+        if (openContainers_.empty()) {
+          return fail("Expected a mapping object");
+        }
+        openContainers_.push_back(addContainer(json::array()));
+      }
+      return true;
+    }
+
+    bool end_array() {
+      if (openContainers_.empty()) {
+        isInsideArray_ = false;
+      } else {
+        openContainers_.pop_back();
+      }
+      return true;
+    }
+
+    // The parser passes the concrete exception type, so it's thrown just like nlohmann::json::parse() would do
+    template<typename Exception>
+    bool parse_error(std::size_t, const std::string&, const Exception& ex) {
+      throw ex;
+    }
+
+    const std::string& getError() const {
+      return error_;
+    }
+  private:
+    // Makes the parser stop
+    bool fail(const char* error) {
+      error_ = error;
+      return false;
+    }
+
+    template<typename Value>
+    bool addValue(Value&& value) {
+      // Plain values are only expected within mappings
+      if (openContainers_.empty()) {
+        return fail("Expected a mapping object");
+      }
+      addContainer(json(std::forward<Value>(value)));
+      return true;
+    }
+
+    json* addContainer(json&& value) {
+      auto& container = *openContainers_.back();
+      if (container.is_array()) {
+        container.push_back(std::move(value));
+        return &container.back();
+      }
+      auto& slot = container[currentKey_];
+      slot = std::move(value);
+      return &slot;
+    }
+  };
+
+  void writeSource(JsonWriter& writer, const helgoboss::Source& source, bool useStringsForEnums) {
+    using namespace helgoboss;
+    // Keys in lexicographic order
+    writer.beginObject();
+    if (source.supportsChannel()) {
+      writer.key("channel");
+      writer.value(source.channel.get());
+    }
+    if (source.supportsCustomCharacter()) {
+      writer.key("character");
+      if (useStringsForEnums) {
+        writer.value(util::serializeSourceCharacter(source.customCharacter.get()));
+      } else {
+        writer.value(static_cast<int>(source.customCharacter.get()));
+      }
+    }
+    if (source.supports14Bit()) {
+      writer.key("is14Bit");
+      writer.value(source.is14Bit.get());
+    }
+    if (source.supportsIsRegistered()) {
+      writer.key("isRegistered");
+      writer.value(source.isRegistered.get());
+    }
+    if (source.supportsMidiClockTransportMessageType()) {
+      writer.key("message");
+      if (useStringsForEnums) {
+        writer.value(util::serializeMidiClockTransportMessageType(source.midiClockTransportMessageType.get()));
+      } else {
+        writer.value(static_cast<int>(source.midiClockTransportMessageType.get()));
+      }
+    }
+    if (source.supportsMidiMessageNumber()) {
+      writer.key("number");
+      writer.value(source.midiMessageNumber.get());
+    } else if (source.supportsParameterNumberMessageNumber()) {
+      writer.key("number");
+      writer.value(source.parameterNumberMessageNumber.get());
+    }
+    writer.key("type");
+    if (useStringsForEnums) {
+      writer.value(util::serializeSourceType(source.type.get()));
+    } else {
+      writer.value(static_cast<int>(source.type.get()));
+    }
+    writer.endObject();
+  }
+
+  void writeMode(JsonWriter& writer, const helgoboss::Mode& mode) {
+    // Keys in lexicographic order
+    writer.beginObject();
+    if (mode.supportsEelControlTransformation()) {
+      writer.key("eelControlTransformation");
+      writer.value(mode.eelControlTransformation.get());
+    }
+    if (mode.supportsEelFeedbackTransformation()) {
+      writer.key("eelFeedbackTransformation");
+      writer.value(mode.eelFeedbackTransformation.get());
+    }
+    if (mode.supportsIgnoreOutOfRangeSourceValuesIsEnabled()) {
+      writer.key("ignoreOutOfRangeSourceValuesIsEnabled");
+      writer.value(mode.ignoreOutOfRangeSourceValuesIsEnabled.get());
+    }
+    writer.key("maxSourceValue");
+    writer.value(mode.maxSourceValue.get());
+    if (mode.supportsStepSize()) {
+      writer.key("maxStepSize");
+      writer.value(mode.maxStepSize.get());
+    }
+    if (mode.supportsTargetJump()) {
+      writer.key("maxTargetJump");
+      writer.value(mode.maxTargetJump.get());
+    }
+    writer.key("maxTargetValue");
+    writer.value(mode.maxTargetValue.get());
+    writer.key("minSourceValue");
+    writer.value(mode.minSourceValue.get());
+    if (mode.supportsStepSize()) {
+      writer.key("minStepSize");
+      writer.value(mode.minStepSize.get());
+    }
+    if (mode.supportsTargetJump()) {
+      writer.key("minTargetJump");
+      writer.value(mode.minTargetJump.get());
+    }
+    writer.key("minTargetValue");
+    writer.value(mode.minTargetValue.get());
+    if (mode.supportsReverseIsEnabled()) {
+      writer.key("reverseIsEnabled");
+      writer.value(mode.reverseIsEnabled.get());
+    }
+    if (mode.supportsRotateIsEnabled()) {
+      writer.key("rotateIsEnabled");
+      writer.value(mode.rotateIsEnabled.get());
+    }
+    if (mode.supportsRoundTargetValue()) {
+      writer.key("roundTargetValue");
+      writer.value(mode.roundTargetValue.get());
+    }
+    if (mode.supportsScaleModeEnabled()) {
+      writer.key("scaleModeEnabled");
+      writer.value(mode.scaleModeEnabled.get());
+    }
+    writer.key("type");
+    writer.value(static_cast<int>(mode.type.get()));
+    writer.endObject();
+  }
+}
+
+namespace helgoboss::util {
+  std::string serializeMappings(const std::vector<ConstMappingRef>& mappings, bool useStringsForEnums) {
+    std::string out;
+    // Typical size of a mapping without EEL scripts
+    out.reserve(2 + mappings.size() * 400);
+    JsonWriter writer(out);
+    writer.beginArray();
+    for (const auto& mapping : mappings) {
+      writer.separate();
+      writer.beginObject();
+      writer.key("mode");
+      writeMode(writer, *mapping.mode);
+      writer.key("source");
+      writeSource(writer, *mapping.source, useStringsForEnums);
+      writer.endObject();
+    }
+    writer.endArray();
+    return out;
+  }
+
+  void deserializeMappings(const nlohmann::json& mappingsJson, const std::vector<MappingRef>& mappings) {
+    Expects(mappingsJson.is_array() && mappingsJson.size() == mappings.size());
+    for (std::size_t i = 0; i < mappings.size(); i++) {
+      const auto& mappingJson = mappingsJson[i];
+      mappings[i].source->updateFromJson(mappingJson.at("source"));
+      mappings[i].mode->updateFromJson(mappingJson.at("mode"));
+    }
+  }
+
+  std::size_t loadMappings(
+      std::istream& input,
+      const std::function<MappingRef(std::size_t index)>& provideMapping,
+      const std::function<void(std::size_t index, MappingRef mapping)>& mappingLoaded
+  ) {
+    std::size_t index = 0;
+    MappingSaxHandler handler([&](const nlohmann::json& mappingJson) {
+      const auto mapping = provideMapping(index);
+      mapping.source->updateFromJson(mappingJson.at("source"));
+      mapping.mode->updateFromJson(mappingJson.at("mode"));
+      mappingLoaded(index, mapping);
+      index += 1;
+    });
+    if (!nlohmann::json::sax_parse(input, &handler)) {
+      throw std::runtime_error(handler.getError());
+    }
+    return index;
+  }
+
+  std::future<void> warmUpInBackground(std::vector<MappingRef> mappings) {
+    return std::async(std::launch::async, [mappings = std::move(mappings)] {
+      for (const auto& mapping : mappings) {
+        mapping.source->warmUp();
+        mapping.mode->warmUp();
+      }
+    });
+  }
+}
@@ -1,4 +1,9 @@
 #include <helgoboss-learn/string-util.h>
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdio>
+#include <cstring>
 
 using std::string;
 using std::function;
@@ -12,4 +17,64 @@ namespace helgoboss::util {
     s.resize(s.find('\0'));
     return s;
   }
-}
\ No newline at end of file
+
+  BufferWriter::BufferWriter(char* buffer, std::size_t bufferSize) :
+      buffer_(buffer),
+      // Leave room for the null character
+      capacity_(bufferSize == 0 ? 0 : bufferSize - 1) {
+    if (bufferSize > 0) {
+      buffer_[0] = '\0';
+    }
+  }
+
+  BufferWriter& BufferWriter::append(std::string_view text) {
+    const auto count = std::min(text.size(), capacity_ - size_);
+    if (count < text.size()) {
+      isTruncated_ = true;
+    }
+    if (count > 0) {
+      std::memcpy(buffer_ + size_, text.data(), count);
+      size_ += count;
+      buffer_[size_] = '\0';
+    }
+    return *this;
+  }
+
+  BufferWriter& BufferWriter::append(int value) {
+    std::array<char, 16> digits;
+    const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), value);
+    return append(std::string_view(digits.data(), result.ptr - digits.data()));
+  }
+
+  BufferWriter& BufferWriter::appendFixed(double value, int precision) {
+    std::array<char, 64> digits;
+#ifdef __cpp_lib_to_chars
+    const auto result = std::to_chars(digits.data(), digits.data() + digits.size(), value, std::chars_format::fixed,
+        precision);
+    if (result.ec != std::errc()) {
+      // Way too large for any display
+      isTruncated_ = true;
+      return *this;
+    }
+    return append(std::string_view(digits.data(), result.ptr - digits.data()));
+#else
+    // Standard libraries without floating-point std::to_chars (e.g. libstdc++ before 11). Like the code before
+    // BufferWriter, this uses the decimal separator of the C locale which is set for the current thread.
+    const int length = std::snprintf(digits.data(), digits.size(), "%.*f", precision, value);
+    if (length < 0 || static_cast<std::size_t>(length) >= digits.size()) {
+      // Way too large for any display
+      isTruncated_ = true;
+      return *this;
+    }
+    return append(std::string_view(digits.data(), static_cast<std::size_t>(length)));
+#endif
+  }
+
+  std::size_t BufferWriter::getSize() const {
+    return size_;
+  }
+
+  bool BufferWriter::isTruncated() const {
+    return isTruncated_;
+  }
+}
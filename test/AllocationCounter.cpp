@@ -0,0 +1,32 @@
+#include "AllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+  thread_local std::size_t allocationCount = 0;
+}
+
+void* operator new(std::size_t size) {
+  allocationCount += 1;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace helgoboss {
+  AllocationCounter::AllocationCounter() : initialCount_(allocationCount) {
+  }
+
+  std::size_t AllocationCounter::getCount() const {
+    return allocationCount - initialCount_;
+  }
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+namespace helgoboss {
+  /**
+   * Counts the heap allocations which the current thread has done since construction of this counter.
+   *
+   * Works because the test executable replaces the global operator new.
+   */
+  class AllocationCounter {
+  private:
+    std::size_t initialCount_;
+  public:
+    AllocationCounter();
+    std::size_t getCount() const;
+  };
+}
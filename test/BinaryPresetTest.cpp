@@ -0,0 +1,77 @@
+#include <catch.hpp>
+#include <helgoboss-learn/BinaryPreset.h>
+#include <helgoboss-learn/MappedFile.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+#include "TestMappings.h"
+
+namespace helgoboss {
+  SCENARIO("Binary presets") {
+    GIVEN("Mappings of all kinds") {
+      const int mappingCount = 120;
+      std::vector<Source> sources(mappingCount);
+      std::vector<Mode> modes(mappingCount);
+      std::vector<ConstMappingRef> mappings;
+      for (int i = 0; i < mappingCount; i++) {
+        configureMapping(sources.at(i), modes.at(i), i);
+        mappings.push_back({&sources.at(i), &modes.at(i)});
+      }
+      std::vector<Source> loadedSources(mappingCount);
+      std::vector<Mode> loadedModes(mappingCount);
+      std::vector<MappingRef> loadedMappings;
+      for (int i = 0; i < mappingCount; i++) {
+        loadedMappings.push_back({&loadedSources.at(i), &loadedModes.at(i)});
+      }
+      const auto binary = util::serializeMappingsToBinary(mappings);
+      WHEN("serialized to binary format and loaded again") {
+        const BinaryPresetView view(binary.data(), binary.size());
+        view.loadMappings(loadedMappings);
+        THEN("the result should be equivalent to the JSON path") {
+          REQUIRE(view.getMappingCount() == mappingCount);
+          REQUIRE(serializeMappingsViaDom(loadedSources, loadedModes, false) ==
+              serializeMappingsViaDom(sources, modes, false));
+        }
+        THEN("even settings which are not relevant for JSON should be restored") {
+          for (int i = 0; i < mappingCount; i++) {
+            REQUIRE(loadedSources.at(i).toDescriptor() == sources.at(i).toDescriptor());
+            REQUIRE(loadedModes.at(i).eelControlTransformation == modes.at(i).eelControlTransformation);
+            REQUIRE(loadedModes.at(i).rotateIsEnabled == modes.at(i).rotateIsEnabled);
+          }
+        }
+        THEN("EEL scripts should be stored just once") {
+          REQUIRE(binary.size() < sizeof(internal::BinaryPresetHeader) +
+              mappingCount * sizeof(internal::BinaryMappingRecord) + 200);
+        }
+      }
+      WHEN("loaded from a memory-mapped file") {
+        const auto path = (std::filesystem::temp_directory_path() / "helgoboss-learn-test-preset.bin").string();
+        {
+          std::ofstream file(path, std::ios::binary);
+          file.write(binary.data(), binary.size());
+        }
+        {
+          const MappedFile mappedFile(path);
+          const BinaryPresetView view(mappedFile.getData(), mappedFile.getSize());
+          view.loadMappings(loadedMappings);
+        }
+        std::remove(path.c_str());
+        THEN("the result should be equivalent to the JSON path") {
+          REQUIRE(serializeMappingsViaDom(loadedSources, loadedModes, true) ==
+              serializeMappingsViaDom(sources, modes, true));
+        }
+      }
+      WHEN("loading invalid data") {
+        const std::string garbage = "This is not a preset at all, really not";
+        const auto truncated = binary.substr(0, binary.size() / 2);
+        THEN("it should refuse to load it") {
+          REQUIRE_THROWS_AS(BinaryPresetView(garbage.data(), garbage.size()), std::runtime_error);
+          REQUIRE_THROWS_AS(BinaryPresetView(truncated.data(), truncated.size()), std::runtime_error);
+          REQUIRE_THROWS_AS(BinaryPresetView(binary.data(), 10), std::runtime_error);
+          REQUIRE_THROWS_AS(MappedFile("/nonexistent/helgoboss-learn-preset.bin"), std::system_error);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,136 @@
+#include <catch.hpp>
+#include <helgoboss-learn/ClockTempoEstimator.h>
+#include <cmath>
+#include <random>
+#include <vector>
+#include "AllocationCounter.h"
+
+namespace helgoboss {
+  // Replays a clock stream of the given tempo with uniformly distributed timing jitter
+  class ClockStream {
+  private:
+    std::mt19937 random_{11};
+    std::uniform_real_distribution<double> jitter_;
+    double idealTimestamp_ = 0;
+  public:
+    explicit ClockStream(double maxJitterInSeconds) : jitter_(-maxJitterInSeconds, maxJitterInSeconds) {
+    }
+
+    std::vector<boost::optional<SourceValue>> replay(ClockTempoEstimator& estimator, double bpm, int tickCount) {
+      std::vector<boost::optional<SourceValue>> results;
+      results.reserve(tickCount);
+      for (int i = 0; i < tickCount; i++) {
+        idealTimestamp_ += 60.0 / (bpm * ClockTempoEstimator::TICKS_PER_QUARTER_NOTE);
+        results.push_back(estimator.feed(MidiMessage::timingClock(), idealTimestamp_ + jitter_(random_)));
+      }
+      return results;
+    }
+
+    void pause(double seconds) {
+      idealTimestamp_ += seconds;
+    }
+  };
+
+  int countEmissions(const std::vector<boost::optional<SourceValue>>& results) {
+    int count = 0;
+    for (const auto& result : results) {
+      count += result ? 1 : 0;
+    }
+    return count;
+  }
+
+  double getLastEmittedBpm(const std::vector<boost::optional<SourceValue>>& results) {
+    for (auto it = results.rbegin(); it != results.rend(); ++it) {
+      if (*it) {
+        return (*it)->getAsTempoMessage().bpm;
+      }
+    }
+    return -1;
+  }
+
+  SCENARIO("Estimate tempo from MIDI clock") {
+    GIVEN("An estimator") {
+      ClockTempoEstimator estimator(0.1);
+      WHEN("fed with a steady clock without jitter") {
+        ClockStream stream(0.0);
+        const auto results = stream.replay(estimator, 120, 200);
+        THEN("it should emit the exact tempo once") {
+          REQUIRE(!results.at(ClockTempoEstimator::MIN_TICK_COUNT - 2).has_value());
+          REQUIRE(results.at(ClockTempoEstimator::MIN_TICK_COUNT - 1).has_value());
+          REQUIRE(countEmissions(results) == 1);
+          REQUIRE(getLastEmittedBpm(results) == Approx(120).margin(0.001));
+        }
+      }
+      WHEN("fed with a clock with 1 ms jitter") {
+        ClockStream stream(0.001);
+        const auto results = stream.replay(estimator, 120, 2000);
+        THEN("it should estimate the tempo precisely and emit rarely") {
+          REQUIRE(*estimator.getEstimatedBpm() == Approx(120).margin(0.1));
+          REQUIRE(getLastEmittedBpm(results) == Approx(120).margin(0.2));
+          REQUIRE(countEmissions(results) < 10);
+        }
+      }
+      WHEN("the tempo changes") {
+        ClockStream stream(0.001);
+        stream.replay(estimator, 120, 500);
+        const auto results = stream.replay(estimator, 93.5, 500);
+        THEN("it should follow the new tempo") {
+          REQUIRE(getLastEmittedBpm(results) == Approx(93.5).margin(0.2));
+          REQUIRE(*estimator.getEstimatedBpm() == Approx(93.5).margin(0.1));
+        }
+      }
+      WHEN("the clock pauses and resumes with another tempo") {
+        ClockStream stream(0.0);
+        stream.replay(estimator, 120, 100);
+        stream.pause(10);
+        const auto results = stream.replay(estimator, 60, ClockTempoEstimator::MIN_TICK_COUNT);
+        THEN("the pause shouldn't distort the estimate") {
+          REQUIRE(countEmissions(results) == 1);
+          REQUIRE(getLastEmittedBpm(results) == Approx(60).margin(0.001));
+        }
+      }
+      WHEN("fed with timestamps which are quantized to audio blocks, so that some of them repeat") {
+        const double blockDuration = 2048 / 44100.0;
+        double idealTimestamp = 0;
+        std::vector<boost::optional<SourceValue>> results;
+        for (int i = 0; i < 500; i++) {
+          idealTimestamp += 60.0 / (120 * ClockTempoEstimator::TICKS_PER_QUARTER_NOTE);
+          results.push_back(estimator.feedTick(std::floor(idealTimestamp / blockDuration) * blockDuration));
+        }
+        THEN("it should keep estimating instead of starting over on each repetition") {
+          REQUIRE(results.at(ClockTempoEstimator::MIN_TICK_COUNT - 1).has_value());
+          REQUIRE(*estimator.getEstimatedBpm() == Approx(120).margin(1));
+        }
+      }
+      WHEN("fed with ticks which all have the same timestamp") {
+        for (int i = 0; i < 100; i++) {
+          estimator.feedTick(5.0);
+        }
+        THEN("it shouldn't estimate anything") {
+          REQUIRE(!estimator.getEstimatedBpm().has_value());
+        }
+      }
+      WHEN("fed with messages other than timing clock") {
+        const auto result = estimator.feed(MidiMessage::start(), 0.0);
+        THEN("it should ignore them") {
+          REQUIRE(!result.has_value());
+          REQUIRE(!estimator.getEstimatedBpm().has_value());
+        }
+      }
+      WHEN("fed with many ticks") {
+        ClockStream stream(0.0005);
+        stream.replay(estimator, 140, ClockTempoEstimator::WINDOW_SIZE);
+        AllocationCounter allocationCounter;
+        double timestamp = 10;
+        for (int i = 0; i < 1000; i++) {
+          timestamp += 60.0 / (130 * ClockTempoEstimator::TICKS_PER_QUARTER_NOTE);
+          estimator.feedTick(timestamp);
+        }
+        const auto allocationCount = allocationCounter.getCount();
+        THEN("it shouldn't allocate") {
+          REQUIRE(allocationCount == 0);
+        }
+      }
+    }
+  }
+}
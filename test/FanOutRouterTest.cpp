@@ -0,0 +1,102 @@
+#include <catch.hpp>
+#include <helgoboss-learn/FanOutRouter.h>
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/ProcessorStatistics.h>
+#include <helgoboss-learn/Source.h>
+#include "RecordingTarget.h"
+#include <memory>
+#include <vector>
+
+namespace helgoboss {
+  namespace {
+    constexpr int FADER_COUNT = 4;
+    constexpr int MAPPINGS_PER_FADER = 12;
+
+    // Each fader controls many targets, with modes of which some support the fixed-point path and some don't
+    void configureMapping(Source& source, Mode& mode, int i) {
+      source.channel.set(0);
+      source.midiMessageNumber.set(i % FADER_COUNT);
+      mode.reverseIsEnabled.set(i % 2 == 1);
+      mode.minTargetValue.set(i % 3 == 0 ? 0.2 : 0.0);
+      mode.maxTargetJump.set(i % 5 == 0 ? 0.1 : 1.0);
+      if (i % 4 == 0) {
+        mode.eelControlTransformation.set("y = x * 0.5");
+      }
+    }
+  }
+
+  SCENARIO("Fan-out router") {
+    GIVEN("Many mappings sharing few sources") {
+      FanOutRouter router;
+      std::vector<std::unique_ptr<RecordingTarget>> routerTargets;
+      std::vector<std::unique_ptr<RecordingTarget>> individualTargets;
+      std::vector<Source> sources(FADER_COUNT * MAPPINGS_PER_FADER);
+      std::vector<Mode> modes(FADER_COUNT * MAPPINGS_PER_FADER);
+      for (int i = 0; i < FADER_COUNT * MAPPINGS_PER_FADER; i++) {
+        configureMapping(sources[i], modes[i], i);
+        routerTargets.push_back(std::make_unique<RecordingTarget>());
+        individualTargets.push_back(std::make_unique<RecordingTarget>());
+        const auto mappingIndex = router.addMapping(sources[i].getProcessor(), modes[i].getProcessor(),
+            *routerTargets[i]);
+        REQUIRE(mappingIndex == static_cast<std::size_t>(i));
+      }
+      THEN("mappings with equal sources should end up in the same group") {
+        REQUIRE(router.getMappingCount() == FADER_COUNT * MAPPINGS_PER_FADER);
+        REQUIRE(router.getGroupCount() == FADER_COUNT);
+      }
+      WHEN("events are processed") {
+        std::vector<SourceValue> values;
+        for (int i = 0; i < 300; i++) {
+          values.emplace_back(MidiMessage::controlChange(0, i % (FADER_COUNT + 1), (i * 13) % 128));
+        }
+        std::size_t matchedGroupCount = 0;
+        for (const auto& value : values) {
+          matchedGroupCount += router.process(value);
+          for (std::size_t i = 0; i < sources.size(); i++) {
+            const auto& source = sources[i].getProcessor();
+            if (source.processes(value)) {
+              modes[i].getProcessor().processSourceValuePreferringFixedPoint(value, source, *individualTargets[i]);
+            }
+          }
+        }
+        THEN("the targets should be hit exactly as if each mapping processed the events on its own") {
+          REQUIRE(matchedGroupCount == 240);
+          for (std::size_t i = 0; i < sources.size(); i++) {
+            REQUIRE(!routerTargets[i]->hitValues.empty());
+            REQUIRE(routerTargets[i]->hitValues.size() == individualTargets[i]->hitValues.size());
+            for (std::size_t j = 0; j < routerTargets[i]->hitValues.size(); j++) {
+              REQUIRE(routerTargets[i]->hitValues[j] == individualTargets[i]->hitValues[j]);
+            }
+          }
+        }
+      }
+      WHEN("events are processed with statistics attached to the sources") {
+        FanOutRouter statisticsRouter;
+        std::vector<ProcessorStatistics> routerStatistics(sources.size());
+        std::vector<ProcessorStatistics> individualStatistics(sources.size());
+        for (std::size_t i = 0; i < sources.size(); i++) {
+          sources[i].setStatistics(&routerStatistics[i]);
+          statisticsRouter.addMapping(sources[i].getProcessor(), modes[i].getProcessor(), *routerTargets[i]);
+          sources[i].setStatistics(&individualStatistics[i]);
+        }
+        for (int i = 0; i < 100; i++) {
+          const auto value = SourceValue(MidiMessage::controlChange(0, i % (FADER_COUNT + 1), i % 128));
+          statisticsRouter.process(value);
+          for (const auto& source : sources) {
+            source.getProcessor().processes(value);
+          }
+        }
+        for (auto& source : sources) {
+          source.setStatistics(nullptr);
+        }
+        THEN("each mapping should count the matched events, not just the first one of each group") {
+          for (std::size_t i = 0; i < sources.size(); i++) {
+            REQUIRE(routerStatistics[i].getSnapshot().matchedEventCount == 20);
+            REQUIRE(routerStatistics[i].getSnapshot().matchedEventCount ==
+                individualStatistics[i].getSnapshot().matchedEventCount);
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,76 @@
+#include <catch.hpp>
+#include <helgoboss-learn/FeedbackEngine.h>
+#include "RecordingTarget.h"
+#include <tuple>
+#include <vector>
+
+namespace helgoboss {
+  namespace {
+    // Remembers all messages in order
+    class RecordingSourceContext : public SourceContext {
+    public:
+      std::vector<std::tuple<const void*, int, int, int>> messages;
+
+      void processMidiFeedback(const void* source, const MidiMessage& message) override {
+        messages.emplace_back(source, message.getStatusByte(), message.getDataByte1(), message.getDataByte2());
+      }
+      void processMidiFeedbackTwo(const void* source, const std::array<MidiMessage, 2>& messages) override {
+        processMidiFeedback(source, messages[0]);
+        processMidiFeedback(source, messages[1]);
+      }
+    };
+  }
+
+  SCENARIO("Feedback engine") {
+    GIVEN("Many mappings of different kinds") {
+      const int mappingCount = 1000;
+      std::vector<Source> sources(mappingCount);
+      std::vector<Mode> modes(mappingCount);
+      std::vector<RecordingTarget> targets;
+      for (int i = 0; i < mappingCount; i++) {
+        auto& source = sources[i];
+        source.channel.set(i % 16);
+        source.midiMessageNumber.set(i % 128);
+        source.type.set(i % 3 == 0 ? SourceType::PitchBendChangeValue : SourceType::ControlChangeValue);
+        source.is14Bit.set(i % 5 == 0);
+        auto& mode = modes[i];
+        mode.type.set(i % 4 == 0 ? ModeType::Toggle : ModeType::Absolute);
+        mode.reverseIsEnabled.set(i % 2 == 1);
+        // Some mappings don't send anything
+        targets.emplace_back(i % 7 == 0 ? -1.0 : (i % 100) / 100.0);
+      }
+      FeedbackEngine engine(4);
+      for (int i = 0; i < mappingCount; i++) {
+        REQUIRE(engine.addMapping(sources[i], modes[i], targets[i]) == i);
+      }
+      WHEN("feedback is computed") {
+        RecordingSourceContext serialContext;
+        for (int i = 0; i < mappingCount; i++) {
+          modes[i].feedback(sources[i], targets[i], serialContext);
+        }
+        RecordingSourceContext engineContext;
+        engine.feedback(engineContext);
+        THEN("the messages should be the same and in the same order as when computed serially") {
+          REQUIRE(!serialContext.messages.empty());
+          REQUIRE(engineContext.messages == serialContext.messages);
+        }
+        THEN("computing it again should yield the same messages") {
+          RecordingSourceContext secondContext;
+          engine.feedback(secondContext);
+          REQUIRE(secondContext.messages == engineContext.messages);
+        }
+      }
+    }
+
+    GIVEN("An engine without mappings") {
+      FeedbackEngine engine(3);
+      WHEN("feedback is computed") {
+        RecordingSourceContext context;
+        engine.feedback(context);
+        THEN("nothing should be sent") {
+          REQUIRE(context.messages.empty());
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,97 @@
+#include <catch.hpp>
+#include <helgoboss-learn/FeedbackScheduler.h>
+#include <helgoboss-learn/ReactiveProperty.h>
+#include "TestSourceContext.h"
+#include "TestTarget.h"
+#include <vector>
+
+namespace helgoboss {
+  namespace {
+    class TestObservableTarget : public ObservableTarget {
+    public:
+      ReactiveProperty<double> value{0.5};
+
+      TargetCharacter getCharacter() const override {
+        return TargetCharacter::Continuous;
+      }
+      double getStepSize() const override {
+        return -1;
+      }
+      bool wantsToBeHitWithStepCounts() const override {
+        return false;
+      }
+      void hit(double normalizedValue, bool isStepCount) override {
+        value.set(normalizedValue);
+      }
+      double getCurrentValue() const override {
+        return value.get();
+      }
+      int getMaxStepCount() const override {
+        return -1;
+      }
+      bool canBeDiscrete() const override {
+        return false;
+      }
+      rxcpp::observable<bool> changed() const override {
+        return value.changed();
+      }
+    };
+  }
+
+  SCENARIO("Feedback scheduler") {
+    GIVEN("Mappings with observable targets and one with a target which is not observable") {
+      const int observableMappingCount = 10;
+      std::vector<Source> sources(observableMappingCount + 1);
+      std::vector<Mode> modes(observableMappingCount + 1);
+      std::vector<TestObservableTarget> observableTargets(observableMappingCount);
+      TestTarget polledTarget;
+      for (auto& source : sources) {
+        source.channel.set(0);
+        source.midiMessageNumber.set(7);
+      }
+      FeedbackScheduler scheduler;
+      for (int i = 0; i < observableMappingCount; i++) {
+        scheduler.addMapping(sources[i], modes[i], observableTargets[i]);
+      }
+      scheduler.addMapping(sources.back(), modes.back(), polledTarget);
+      TestSourceContext context;
+      THEN("all mappings should be dirty initially") {
+        REQUIRE(scheduler.getDirtyMappingCount() == observableMappingCount + 1);
+        REQUIRE(scheduler.feedback(context) == observableMappingCount + 1);
+        REQUIRE(context.oneCount == observableMappingCount + 1);
+      }
+      WHEN("feedback has been computed once") {
+        scheduler.feedback(context);
+        context.oneCount = 0;
+        THEN("only the mapping with the target which is not observable should be computed again") {
+          REQUIRE(scheduler.getDirtyMappingCount() == 0);
+          REQUIRE(scheduler.feedback(context) == 1);
+          REQUIRE(context.oneCount == 1);
+        }
+        THEN("target changes should make the affected mappings dirty") {
+          observableTargets[3].hit(0.25, false);
+          observableTargets[3].hit(0.75, false);
+          observableTargets[8].hit(1.0, false);
+          REQUIRE(scheduler.getDirtyMappingCount() == 2);
+          REQUIRE(scheduler.feedback(context) == 3);
+          REQUIRE(scheduler.getDirtyMappingCount() == 0);
+        }
+        THEN("hitting a target with its current value should not make the mapping dirty") {
+          observableTargets[3].hit(0.5, false);
+          REQUIRE(scheduler.getDirtyMappingCount() == 0);
+        }
+        THEN("source and mode changes should make the affected mappings dirty") {
+          sources[1].channel.set(2);
+          modes[2].reverseIsEnabled.set(true);
+          modes.back().reverseIsEnabled.set(true);
+          REQUIRE(scheduler.getDirtyMappingCount() == 3);
+          REQUIRE(scheduler.feedback(context) == 3);
+        }
+        THEN("marking all dirty should recompute everything") {
+          scheduler.markAllDirty();
+          REQUIRE(scheduler.feedback(context) == observableMappingCount + 1);
+        }
+      }
+    }
+  }
+}
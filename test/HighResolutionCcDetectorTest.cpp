@@ -0,0 +1,162 @@
+#include <catch.hpp>
+#include <helgoboss-learn/HighResolutionCcDetector.h>
+#include <vector>
+
+namespace helgoboss {
+  SCENARIO("Detect high-resolution messages in raw CC messages") {
+    GIVEN("A detector") {
+      HighResolutionCcDetector detector;
+      // Messages arrive 1 ms apart unless time is advanced explicitly
+      double time = 0.0;
+      const auto feed = [&detector, &time](int channel, int controllerNumber, int value) {
+        time += 0.001;
+        return detector.feed(MidiMessage::controlChange(channel, controllerNumber, value), time);
+      };
+      WHEN("fed with an MSB/LSB pair") {
+        const auto first = feed(3, 7, 100);
+        const auto second = feed(3, 39, 20);
+        THEN("it should describe a 14-bit CC source as soon as the pair is complete") {
+          REQUIRE(!first.has_value());
+          REQUIRE(second.has_value());
+          REQUIRE(second->type == SourceType::ControlChangeValue);
+          REQUIRE(second->channel == 3);
+          REQUIRE(second->midiMessageNumber == 7);
+          REQUIRE(second->is14Bit);
+          REQUIRE(detector.isPartOfHighResolutionMessage(3, 7));
+          REQUIRE(detector.isPartOfHighResolutionMessage(3, 39));
+          REQUIRE(!detector.isPartOfHighResolutionMessage(4, 7));
+          REQUIRE(!detector.isPartOfHighResolutionMessage(3, 8));
+        }
+      }
+      WHEN("fed with an MSB which is not followed by its LSB") {
+        const auto first = feed(3, 7, 100);
+        const auto second = feed(3, 40, 20);
+        const auto third = feed(3, 39, 20);
+        THEN("it shouldn't detect anything") {
+          REQUIRE(!first.has_value());
+          REQUIRE(!second.has_value());
+          REQUIRE(!third.has_value());
+          REQUIRE(!detector.isPartOfHighResolutionMessage(3, 7));
+        }
+      }
+      WHEN("fed with pairs on many channels interleaved") {
+        int detectedCount = 0;
+        for (int channel = 0; channel < 16; channel++) {
+          detectedCount += feed(channel, 1, 64) ? 1 : 0;
+        }
+        for (int channel = 0; channel < 16; channel++) {
+          detectedCount += feed(channel, 33, 0) ? 1 : 0;
+        }
+        THEN("it should detect each of them") {
+          REQUIRE(detectedCount == 16);
+          REQUIRE(detector.isPartOfHighResolutionMessage(15, 1));
+        }
+      }
+      WHEN("fed with an NRPN message with 14-bit data entry") {
+        feed(1, 99, 2);
+        feed(1, 98, 5);
+        const auto msb = feed(1, 6, 10);
+        const auto lsb = feed(1, 38, 3);
+        THEN("it should describe a 14-bit parameter number source") {
+          REQUIRE(!msb.has_value());
+          REQUIRE(lsb.has_value());
+          REQUIRE(lsb->type == SourceType::ParameterNumberMessageValue);
+          REQUIRE(lsb->channel == 1);
+          REQUIRE(lsb->parameterNumberMessageNumber == 2 * 128 + 5);
+          REQUIRE(!lsb->isRegistered);
+          REQUIRE(lsb->is14Bit);
+          REQUIRE(detector.isPartOfHighResolutionMessage(1, 99));
+          REQUIRE(detector.isPartOfHighResolutionMessage(1, 6));
+        }
+      }
+      WHEN("fed with an RPN message with 7-bit data entries") {
+        feed(1, 101, 0);
+        feed(1, 100, 1);
+        const auto first = feed(1, 6, 10);
+        const auto second = feed(1, 6, 11);
+        THEN("it should describe a 7-bit parameter number source as soon as the second data entry arrives") {
+          REQUIRE(!first.has_value());
+          REQUIRE(second.has_value());
+          REQUIRE(second->parameterNumberMessageNumber == 1);
+          REQUIRE(second->isRegistered);
+          REQUIRE(!second->is14Bit);
+        }
+      }
+      WHEN("fed with data entry after RPN null") {
+        feed(1, 101, 127);
+        feed(1, 100, 127);
+        const auto msb = feed(1, 6, 10);
+        const auto lsb = feed(1, 38, 3);
+        THEN("it shouldn't detect anything because data entry is never a 14-bit CC message") {
+          REQUIRE(!msb.has_value());
+          REQUIRE(!lsb.has_value());
+          REQUIRE(!detector.isPartOfHighResolutionMessage(1, 6));
+          REQUIRE(!detector.isPartOfHighResolutionMessage(1, 38));
+        }
+      }
+      WHEN("fed with data entry without any parameter number selected") {
+        const auto msb = feed(1, 6, 10);
+        const auto lsb = feed(1, 38, 3);
+        THEN("it shouldn't detect anything") {
+          REQUIRE(!msb.has_value());
+          REQUIRE(!lsb.has_value());
+          REQUIRE(!detector.isPartOfHighResolutionMessage(1, 6));
+        }
+      }
+      WHEN("fed with an NRPN message with 7-bit data entry which selects the parameter number before each value") {
+        std::vector<boost::optional<SourceDescriptor>> results;
+        for (int i = 0; i < 2; i++) {
+          results.push_back(feed(1, 99, 2));
+          results.push_back(feed(1, 98, 5));
+          results.push_back(feed(1, 6, 10 + i));
+        }
+        THEN("it should describe a 7-bit parameter number source as soon as the second data entry arrives") {
+          for (std::size_t i = 0; i < results.size() - 1; i++) {
+            REQUIRE(!results[i].has_value());
+          }
+          REQUIRE(results.back().has_value());
+          REQUIRE(results.back()->type == SourceType::ParameterNumberMessageValue);
+          REQUIRE(results.back()->parameterNumberMessageNumber == 2 * 128 + 5);
+          REQUIRE(!results.back()->isRegistered);
+          REQUIRE(!results.back()->is14Bit);
+          REQUIRE(detector.isPartOfHighResolutionMessage(1, 6));
+          REQUIRE(detector.isPartOfHighResolutionMessage(1, 98));
+        }
+      }
+      WHEN("fed with a single 7-bit data entry followed by another message much later") {
+        feed(1, 99, 2);
+        feed(1, 98, 5);
+        const auto dataEntry = feed(1, 6, 10);
+        time += 1.0;
+        const auto later = feed(1, 7, 100);
+        THEN("it should describe a 7-bit parameter number source when the later message arrives") {
+          REQUIRE(!dataEntry.has_value());
+          REQUIRE(later.has_value());
+          REQUIRE(later->type == SourceType::ParameterNumberMessageValue);
+          REQUIRE(later->parameterNumberMessageNumber == 2 * 128 + 5);
+          REQUIRE(!later->is14Bit);
+        }
+      }
+      WHEN("fed with a single 7-bit data entry followed by the selection of another parameter number") {
+        feed(1, 99, 2);
+        feed(1, 98, 5);
+        feed(1, 6, 10);
+        const auto otherSelection = feed(1, 99, 3);
+        THEN("it should describe the previous parameter number as 7-bit source") {
+          REQUIRE(otherSelection.has_value());
+          REQUIRE(otherSelection->parameterNumberMessageNumber == 2 * 128 + 5);
+          REQUIRE(!otherSelection->is14Bit);
+        }
+      }
+      WHEN("fed with an MSB whose LSB arrives too late") {
+        feed(3, 7, 100);
+        time += 1.0;
+        const auto lsb = feed(3, 39, 20);
+        THEN("it shouldn't detect anything") {
+          REQUIRE(!lsb.has_value());
+          REQUIRE(!detector.isPartOfHighResolutionMessage(3, 7));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,154 @@
+#include <catch.hpp>
+#include <helgoboss-learn/LatencyHistogram.h>
+#include <helgoboss-learn/LatencyTracer.h>
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/Source.h>
+#include "TestSourceContext.h"
+#include "TestTarget.h"
+#include <cstdint>
+
+namespace helgoboss {
+  // Target whose hit() takes a configurable amount of fake time
+  class SlowTestTarget : public TestTarget {
+  public:
+    std::uint64_t& fakeNow;
+    std::uint64_t hitNanos = 100;
+
+    explicit SlowTestTarget(std::uint64_t& fakeNow) : fakeNow(fakeNow) {
+    }
+
+    void hit(double normalizedValue, bool isStepCount) override {
+      TestTarget::hit(normalizedValue, isStepCount);
+      fakeNow += hitNanos;
+    }
+  };
+
+  SCENARIO("Latency histograms") {
+    GIVEN("A histogram") {
+      LatencyHistogram histogram;
+      WHEN("nothing has been recorded") {
+        THEN("it should report zeros") {
+          REQUIRE(histogram.getCount() == 0);
+          REQUIRE(histogram.getMin() == 0);
+          REQUIRE(histogram.getMax() == 0);
+          REQUIRE(histogram.getValueAtPercentile(99) == 0);
+        }
+      }
+      WHEN("values are recorded") {
+        for (std::uint64_t i = 1; i <= 10000; i++) {
+          histogram.record(i);
+        }
+        THEN("percentiles should be accurate within the bucket resolution") {
+          REQUIRE(histogram.getCount() == 10000);
+          REQUIRE(histogram.getMin() == 1);
+          REQUIRE(histogram.getMax() == 10000);
+          REQUIRE(histogram.getMean() == Approx(5000.5));
+          const auto maxError = 1.0 / LatencyHistogram::SUB_BUCKET_COUNT;
+          REQUIRE(histogram.getValueAtPercentile(50) == Approx(5000).epsilon(maxError));
+          REQUIRE(histogram.getValueAtPercentile(99) == Approx(9900).epsilon(maxError));
+          REQUIRE(histogram.getValueAtPercentile(100) == 10000);
+        }
+        AND_WHEN("the histogram is reset") {
+          histogram.reset();
+          THEN("it should be empty again") {
+            REQUIRE(histogram.getCount() == 0);
+            REQUIRE(histogram.getValueAtPercentile(50) == 0);
+          }
+        }
+      }
+    }
+    GIVEN("Values over the whole 64-bit range") {
+      THEN("each one should fall into a bucket whose highest value is not lower") {
+        std::size_t previousIndex = 0;
+        for (std::uint64_t value = 1; value != 0; value = value < UINT64_MAX / 3 ? value * 3 : 0) {
+          const auto index = LatencyHistogram::getBucketIndex(value);
+          REQUIRE(index < LatencyHistogram::BUCKET_COUNT);
+          REQUIRE(index >= previousIndex);
+          REQUIRE(LatencyHistogram::getHighestValueInBucket(index) >= value);
+          previousIndex = index;
+        }
+        REQUIRE(LatencyHistogram::getBucketIndex(UINT64_MAX) == LatencyHistogram::BUCKET_COUNT - 1);
+        REQUIRE(LatencyHistogram::getHighestValueInBucket(LatencyHistogram::BUCKET_COUNT - 1) == UINT64_MAX);
+      }
+    }
+  }
+
+  SCENARIO("Latency tracing") {
+    GIVEN("A mapping with a latency tracer driven by a fake clock") {
+      std::uint64_t fakeNow = 1000000;
+      LatencyTracer tracer([&fakeNow] {
+        return fakeNow;
+      });
+      Source source;
+      source.channel.set(0);
+      source.midiMessageNumber.set(7);
+      Mode mode;
+      mode.type.set(ModeType::Absolute);
+      mode.setLatencyTracer(&tracer);
+      auto& modeProcessor = mode.getProcessor();
+      SlowTestTarget target(fakeNow);
+      WHEN("many events are processed and a few of them hit a slow target") {
+        const int eventCount = 1000;
+        for (int i = 0; i < eventCount; i++) {
+          target.hitNanos = i % 100 == 0 ? 10000 : 100;
+          // Each event has been waiting 50 ns before processing started
+          const auto arrivalTimestamp = fakeNow - 50;
+          modeProcessor.processTraced(
+              SourceValue(MidiMessage::controlChange(0, 7, i % 128)), arrivalTimestamp, source.getProcessor(), target);
+        }
+        const auto& hits = tracer.getHistogram(LatencyStage::Hit);
+        const auto& endToEnd = tracer.getHistogram(LatencyStage::EndToEnd);
+        THEN("the tail latency should show up in the high percentiles only") {
+          REQUIRE(target.hitCount == eventCount);
+          REQUIRE(tracer.getHistogram(LatencyStage::Match).getCount() == eventCount);
+          REQUIRE(tracer.getHistogram(LatencyStage::Match).getMax() == 0);
+          REQUIRE(tracer.getHistogram(LatencyStage::ModeTransform).getCount() == eventCount);
+          REQUIRE(hits.getCount() == eventCount);
+          REQUIRE(hits.getValueAtPercentile(50) == Approx(100).epsilon(0.05));
+          REQUIRE(hits.getValueAtPercentile(99) == Approx(100).epsilon(0.05));
+          REQUIRE(hits.getValueAtPercentile(99.9) == Approx(10000).epsilon(0.05));
+          REQUIRE(hits.getMax() == 10000);
+          REQUIRE(endToEnd.getMin() == 150);
+          REQUIRE(endToEnd.getMax() == 10050);
+        }
+        THEN("the export should contain all stages") {
+          const auto j = tracer.exportToJson();
+          REQUIRE(j.size() == NUM_LATENCY_STAGES);
+          REQUIRE(j.at("hit").at("count") == eventCount);
+          REQUIRE(j.at("hit").at("max") == 10000);
+          REQUIRE(j.at("endToEnd").contains("p999"));
+          REQUIRE(j.at("eel").at("count") == 0);
+        }
+      }
+      WHEN("an event doesn't match") {
+        const bool matched = modeProcessor.processTraced(
+            SourceValue(MidiMessage::controlChange(0, 8, 64)), fakeNow, source.getProcessor(), target);
+        THEN("only the match stage should be recorded") {
+          REQUIRE(!matched);
+          REQUIRE(tracer.getHistogram(LatencyStage::Match).getCount() == 1);
+          REQUIRE(tracer.getHistogram(LatencyStage::Normalize).getCount() == 0);
+          REQUIRE(tracer.getHistogram(LatencyStage::EndToEnd).getCount() == 0);
+        }
+      }
+      WHEN("an EEL control transformation is used") {
+        mode.eelControlTransformation.set("y = 1 - x");
+        mode.getProcessor().processTraced(
+            SourceValue(MidiMessage::controlChange(0, 7, 64)), fakeNow, source.getProcessor(), target);
+        THEN("its execution should be recorded") {
+          REQUIRE(tracer.getHistogram(LatencyStage::Eel).getCount() == 1);
+          REQUIRE(tracer.getHistogram(LatencyStage::Hit).getCount() == 1);
+        }
+      }
+      WHEN("feedback is sent through a tracing source context") {
+        TestSourceContext context;
+        TracingSourceContext<TestSourceContext> tracingContext(context, tracer, fakeNow - 300);
+        mode.feedback(source, target, tracingContext);
+        THEN("the time since the target change should be recorded") {
+          REQUIRE(context.oneCount == 1);
+          REQUIRE(tracer.getHistogram(LatencyStage::Feedback).getCount() == 1);
+          REQUIRE(tracer.getHistogram(LatencyStage::Feedback).getMax() == 300);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,131 @@
+#include <catch.hpp>
+#include <helgoboss-learn/MappingBank.h>
+#include "TestMappings.h"
+#include "RecordingTarget.h"
+#include <vector>
+
+namespace helgoboss {
+  namespace {
+    constexpr int MAPPING_COUNT = 400;
+
+    // All kinds of values, most of them hitting at least one of the mappings
+    std::vector<SourceValue> createValues() {
+      std::vector<SourceValue> values;
+      for (int i = 0; i < 600; i++) {
+        const int channel = i % 16;
+        const int number = i % 128;
+        const int value = (i * 37) % 128;
+        values.emplace_back(MidiMessage::controlChange(channel, number, value));
+        values.emplace_back(MidiMessage::noteOn(channel, number, value));
+        values.emplace_back(MidiMessage::noteOff(channel, number, 0));
+        values.emplace_back(MidiMessage::pitchBendChange(channel, value * 100));
+        values.emplace_back(MidiMessage::channelPressure(channel, value));
+        values.emplace_back(MidiMessage::programChange(channel, value));
+        values.emplace_back(MidiMessage::polyphonicKeyPressure(channel, number, value));
+        values.emplace_back(Midi14BitCcMessage(channel, number % 32, value * 100));
+        values.emplace_back(MidiParameterNumberMessage(channel, number, value, i % 2 == 0, i % 3 == 0));
+      }
+      values.emplace_back(MidiMessage::start());
+      values.emplace_back(MidiMessage::stop());
+      values.emplace_back(TempoMessage{120});
+      return values;
+    }
+
+    // Processes the values mapping by mapping with the objects' own processors
+    void processIndividually(const std::vector<SourceValue>& values, const std::vector<Source>& sources,
+        std::vector<Mode>& modes, std::vector<RecordingTarget>& targets) {
+      for (const auto& value : values) {
+        for (std::size_t i = 0; i < sources.size(); i++) {
+          const auto& sourceProcessor = sources[i].getProcessor();
+          if (sourceProcessor.processes(value)) {
+            modes[i].getProcessor().processSourceValue(sourceProcessor.getNormalizedValue(value), sourceProcessor,
+                targets[i]);
+          }
+        }
+      }
+    }
+  }
+
+  SCENARIO("Mapping bank") {
+    GIVEN("A bank with mappings which are configured after adding them") {
+      std::vector<Source> sources(MAPPING_COUNT);
+      std::vector<Mode> modes(MAPPING_COUNT);
+      std::vector<RecordingTarget> bankTargets(MAPPING_COUNT);
+      std::vector<RecordingTarget> individualTargets(MAPPING_COUNT);
+      MappingBank bank;
+      for (int i = 0; i < MAPPING_COUNT; i++) {
+        bank.addMapping(sources[i], modes[i], bankTargets[i]);
+      }
+      for (int i = 0; i < MAPPING_COUNT; i++) {
+        configureMapping(sources[i], modes[i], i);
+      }
+      REQUIRE(bank.getMappingCount() == MAPPING_COUNT);
+      WHEN("values are processed") {
+        const auto values = createValues();
+        std::size_t matchCount = 0;
+        for (const auto& value : values) {
+          matchCount += bank.process(value);
+        }
+        processIndividually(values, sources, modes, individualTargets);
+        THEN("the targets should be hit exactly as by processing each mapping on its own") {
+          REQUIRE(matchCount > 0);
+          for (int i = 0; i < MAPPING_COUNT; i++) {
+            REQUIRE(bankTargets[i].hitValues == individualTargets[i].hitValues);
+          }
+        }
+      }
+      WHEN("values are processed with statistics attached") {
+        const auto values = createValues();
+        std::vector<ProcessorStatistics> bankStatistics(MAPPING_COUNT);
+        std::vector<ProcessorStatistics> individualStatistics(MAPPING_COUNT);
+        for (int i = 0; i < MAPPING_COUNT; i++) {
+          sources[i].setStatistics(&bankStatistics[i]);
+          modes[i].setStatistics(&bankStatistics[i]);
+        }
+        for (const auto& value : values) {
+          bank.process(value);
+        }
+        for (int i = 0; i < MAPPING_COUNT; i++) {
+          sources[i].setStatistics(&individualStatistics[i]);
+          modes[i].setStatistics(&individualStatistics[i]);
+        }
+        processIndividually(values, sources, modes, individualTargets);
+        for (int i = 0; i < MAPPING_COUNT; i++) {
+          sources[i].setStatistics(nullptr);
+          modes[i].setStatistics(nullptr);
+        }
+        THEN("the statistics should count exactly as when processing each mapping on its own") {
+          for (int i = 0; i < MAPPING_COUNT; i++) {
+            const auto bankSnapshot = bankStatistics[i].getSnapshot();
+            const auto individualSnapshot = individualStatistics[i].getSnapshot();
+            REQUIRE(bankSnapshot.matchedEventCount == individualSnapshot.matchedEventCount);
+            REQUIRE(bankSnapshot.outOfRangeEventCount == individualSnapshot.outOfRangeEventCount);
+            REQUIRE(bankSnapshot.targetHitCount == individualSnapshot.targetHitCount);
+            REQUIRE(bankSnapshot.suppressedJumpCount == individualSnapshot.suppressedJumpCount);
+          }
+        }
+      }
+      WHEN("settings change in a batch") {
+        sources[0].modifyInBatch([&source = sources[0]] {
+          source.type.set(SourceType::ControlChangeValue);
+          source.is14Bit.set(true);
+          source.channel.set(5);
+          source.midiMessageNumber.set(3);
+        });
+        modes[0].modifyInBatch([&mode = modes[0]] {
+          mode.type.set(ModeType::Absolute);
+          mode.eelControlTransformation.set("");
+          mode.minTargetValue.set(0.25);
+          mode.maxTargetJump.set(1.0);
+          mode.ignoreOutOfRangeSourceValuesIsEnabled.set(false);
+        });
+        const auto matchCount = bank.process(SourceValue(Midi14BitCcMessage(5, 3, 16383)));
+        THEN("the bank should follow") {
+          REQUIRE(matchCount == 1);
+          REQUIRE(bankTargets[0].hitValues.size() == 1);
+          REQUIRE(bankTargets[0].value == Approx(1.0));
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,135 @@
+#include <catch.hpp>
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/ModeConfigPool.h>
+#include <helgoboss-learn/Source.h>
+#include <helgoboss-learn/preset-util.h>
+#include "AllocationCounter.h"
+#include "TestTarget.h"
+#include <string>
+#include <vector>
+
+namespace helgoboss {
+  namespace {
+    ModeProcessor createModeProcessor(double minTargetValue, const std::string& eelControlTransformation) {
+      return ModeProcessor(ModeType::Absolute, minTargetValue, 1.0, 0.0, 1.0, false, false, 0.0, 1.0,
+          eelControlTransformation, false, false, 0.01, 0.01, false);
+    }
+  }
+
+  SCENARIO("Mode config pool") {
+    GIVEN("A pool") {
+      ModeConfigPool pool;
+      WHEN("processors with equal and different settings are interned") {
+        std::vector<ModeProcessor> processors;
+        for (int i = 0; i < 100; i++) {
+          processors.push_back(pool.intern(createModeProcessor(i % 2 == 0 ? 0.0 : 0.5, i % 4 < 2 ? "" : "y = x")));
+        }
+        THEN("processors with equal settings should share their configuration unless they have EEL transformation") {
+          REQUIRE(pool.getConfigCount() == 2);
+          for (std::size_t i = 4; i < processors.size(); i++) {
+            if (i % 4 < 2) {
+              REQUIRE(processors[i].sharesConfigWith(processors[i % 4]));
+              REQUIRE(!processors[i].sharesConfigWith(processors[(i + 1) % 4]));
+            } else {
+              REQUIRE(!processors[i].sharesConfigWith(processors[i % 4]));
+            }
+          }
+        }
+        THEN("they should process values exactly like processors with their own configuration") {
+          const Source source;
+          for (std::size_t i = 0; i < 4; i++) {
+            auto ownProcessor = createModeProcessor(i % 2 == 0 ? 0.0 : 0.5, i % 4 < 2 ? "" : "y = x");
+            for (int value = 0; value <= 10; value++) {
+              TestTarget sharedTarget;
+              TestTarget ownTarget;
+              processors[i].processSourceValue(value / 10.0, source.getProcessor(), sharedTarget);
+              ownProcessor.processSourceValue(value / 10.0, source.getProcessor(), ownTarget);
+              REQUIRE(sharedTarget.hitCount == ownTarget.hitCount);
+              REQUIRE(sharedTarget.lastHitValue == ownTarget.lastHitValue);
+            }
+          }
+        }
+        AND_WHEN("the processors are gone") {
+          processors.clear();
+          THEN("their configurations can be removed") {
+            REQUIRE(pool.removeUnusedConfigs() == 2);
+            REQUIRE(pool.getConfigCount() == 0);
+          }
+        }
+      }
+      WHEN("modes use the pool") {
+        Mode firstMode;
+        Mode secondMode;
+        firstMode.setConfigPool(&pool);
+        secondMode.setConfigPool(&pool);
+        THEN("their processors should share the configuration as long as the settings are equal") {
+          REQUIRE(firstMode.getProcessor().sharesConfigWith(secondMode.getProcessor()));
+          secondMode.minTargetValue.set(0.3);
+          REQUIRE(!firstMode.getProcessor().sharesConfigWith(secondMode.getProcessor()));
+          firstMode.minTargetValue.set(0.3);
+          REQUIRE(firstMode.getProcessor().sharesConfigWith(secondMode.getProcessor()));
+        }
+      }
+      WHEN("modes using the pool are warmed up in the background while the control thread interns as well") {
+        const int modeCount = 200;
+        std::vector<Source> sources(modeCount);
+        std::vector<Mode> modes;
+        modes.reserve(modeCount);
+        std::vector<MappingRef> mappings;
+        for (int i = 0; i < modeCount; i++) {
+          modes.emplace_back(ProcessorActivation::Lazy);
+          modes.back().minTargetValue.set(i % 2 == 0 ? 0.0 : 0.5);
+          modes.back().setConfigPool(&pool);
+          mappings.push_back({&sources.at(i), &modes.at(i)});
+        }
+        auto warmUp = util::warmUpInBackground(mappings);
+        std::vector<ModeProcessor> processors;
+        for (int i = 0; i < modeCount; i++) {
+          processors.push_back(pool.intern(createModeProcessor(i % 2 == 0 ? 0.0 : 0.5, "")));
+        }
+        warmUp.get();
+        THEN("all of them should end up with the same pooled configurations") {
+          REQUIRE(pool.getConfigCount() == 2);
+          for (int i = 0; i < modeCount; i++) {
+            REQUIRE(modes.at(i).getProcessor().sharesConfigWith(processors.at(i % 2)));
+          }
+        }
+      }
+    }
+
+    GIVEN("A processor without EEL control transformation") {
+      const auto processor = createModeProcessor(0.2, "");
+      THEN("copies should share its configuration without allocating") {
+        std::vector<ModeProcessor> copies;
+        copies.reserve(10000);
+        AllocationCounter allocationCounter;
+        for (int i = 0; i < 10000; i++) {
+          copies.push_back(processor);
+        }
+        REQUIRE(allocationCounter.getCount() == 0);
+        REQUIRE(copies.back().sharesConfigWith(processor));
+      }
+    }
+
+    GIVEN("A processor which has been moved from") {
+      auto processor = createModeProcessor(0.2, "y = x * 0.5");
+      const auto movedProcessor = std::move(processor);
+      THEN("it should still be usable with default settings") {
+        TestTarget target;
+        processor.processSourceValue(0.7, Source().getProcessor(), target);
+        REQUIRE(target.lastHitValue == Approx(0.7));
+      }
+    }
+
+    GIVEN("A processor with EEL control transformation") {
+      const auto processor = createModeProcessor(0.2, "y = x * 0.5");
+      THEN("copies should get their own configuration, so they can be used on other threads") {
+        auto copy = processor;
+        REQUIRE(!copy.sharesConfigWith(processor));
+        TestTarget target;
+        copy.processSourceValue(1.0, Source().getProcessor(), target);
+        REQUIRE(target.lastHitValue == Approx(0.6));
+      }
+    }
+  }
+}
@@ -5,6 +5,10 @@
 #include <helgoboss-learn/Target.h>
 #include "TestSourceContext.h"
 #include "TestTarget.h"
+#include <cmath>
+#include <functional>
+#include <string>
+#include <vector>
 
 namespace helgoboss {
   SCENARIO("Modes") {
@@ -45,4 +49,145 @@ namespace helgoboss {
       }
     }
   }
-}
\ No newline at end of file
+
+  class DiscreteTestTarget : public TestTarget {
+  public:
+    double stepSize;
+
+    explicit DiscreteTestTarget(double stepSize) : stepSize(stepSize) {
+    }
+
+    TargetCharacter getCharacter() const override {
+      return TargetCharacter::Discrete;
+    }
+    double getStepSize() const override {
+      return stepSize;
+    }
+    bool canBeDiscrete() const override {
+      return true;
+    }
+  };
+
+  struct FixedPointTestSource {
+    std::string name;
+    SourceProcessor processor;
+    int maxValue;
+    bool isCentered;
+    std::function<SourceValue(int)> createValue;
+  };
+
+  ModeProcessor createAbsoluteModeProcessor(double minTargetValue, double maxTargetValue, double minSourceValue,
+      double maxSourceValue, bool reverseIsEnabled, bool roundTargetValue) {
+    return ModeProcessor(ModeType::Absolute, minTargetValue, maxTargetValue, minSourceValue, maxSourceValue,
+        reverseIsEnabled, false, 0.0, 1.0, "", roundTargetValue, false, 0.01, 0.01, false);
+  }
+
+  SCENARIO("Fixed-point processing") {
+    const std::vector<FixedPointTestSource> sources{
+        {
+            "7-bit CC",
+            SourceProcessor(SourceType::ControlChangeValue, 0, false, false, 7, SourceCharacter::Range,
+                MidiClockTransportMessageType::Start),
+            127, false,
+            [](int value) { return SourceValue(MidiMessage::controlChange(0, 7, value)); }
+        },
+        {
+            "14-bit CC",
+            SourceProcessor(SourceType::ControlChangeValue, 0, true, false, 7, SourceCharacter::Range,
+                MidiClockTransportMessageType::Start),
+            16383, false,
+            [](int value) { return SourceValue(Midi14BitCcMessage(0, 7, value)); }
+        },
+        {
+            "pitch bend",
+            SourceProcessor(SourceType::PitchBendChangeValue, 0, false, false, 0, SourceCharacter::Range,
+                MidiClockTransportMessageType::Start),
+            16383, true,
+            [](int value) { return SourceValue(MidiMessage::pitchBendChange(0, value)); }
+        }
+    };
+    const std::vector<ModeProcessor> continuousModeProcessors{
+        createAbsoluteModeProcessor(0.0, 1.0, 0.0, 1.0, false, false),
+        createAbsoluteModeProcessor(0.2, 0.8, 0.0, 1.0, true, false),
+        createAbsoluteModeProcessor(0.0, 1.0, 0.25, 0.75, false, false),
+        createAbsoluteModeProcessor(0.8, 0.2, 0.75, 0.25, true, false),
+    };
+    for (const auto& source : sources) {
+      GIVEN("A " + source.name + " source") {
+        // Pitch bend differs by design because the fixed-point path maps the center to exactly 0.5. A narrowed source
+        // range amplifies that difference.
+        const double tolerance = (source.isCentered ? 6.0 : 1.0) / util::FIXED_POINT_ONE;
+        WHEN("processing all possible values with continuous targets") {
+          THEN("targets should be hit with nearly the same values as with the double path") {
+            for (auto modeProcessor : continuousModeProcessors) {
+              REQUIRE(modeProcessor.supportsFixedPointProcessing());
+              for (int value = 0; value <= source.maxValue; value++) {
+                const auto sourceValue = source.createValue(value);
+                TestTarget doubleTarget;
+                TestTarget fixedPointTarget;
+                modeProcessor.processSourceValue(
+                    source.processor.getNormalizedValue(sourceValue), source.processor, doubleTarget);
+                modeProcessor.processSourceValuePreferringFixedPoint(sourceValue, source.processor, fixedPointTarget);
+                REQUIRE(fixedPointTarget.hitCount == doubleTarget.hitCount);
+                REQUIRE(std::abs(fixedPointTarget.lastHitValue - doubleTarget.lastHitValue) <= tolerance);
+              }
+            }
+          }
+        }
+        WHEN("processing all possible values with discrete targets and rounding enabled") {
+          // Exact, except for pitch bend whose deviation can move a value across a rounding boundary
+          THEN(source.isCentered ? "targets should be hit with the same or a neighboring step as with the double path"
+                                 : "targets should be hit with exactly the same values as with the double path") {
+            auto modeProcessor = createAbsoluteModeProcessor(0.2, 0.8, 0.0, 1.0, true, true);
+            for (const double stepSize : {1.0 / 127, 1.0 / 10}) {
+              for (int value = 0; value <= source.maxValue; value++) {
+                const auto sourceValue = source.createValue(value);
+                DiscreteTestTarget doubleTarget(stepSize);
+                DiscreteTestTarget fixedPointTarget(stepSize);
+                modeProcessor.processSourceValue(
+                    source.processor.getNormalizedValue(sourceValue), source.processor, doubleTarget);
+                modeProcessor.processFixedPointSourceValue(
+                    *source.processor.getFixedPointValue(sourceValue), source.processor, fixedPointTarget);
+                if (source.isCentered) {
+                  REQUIRE(std::abs(fixedPointTarget.lastHitValue - doubleTarget.lastHitValue) <= stepSize * 1.000001);
+                } else {
+                  REQUIRE(fixedPointTarget.lastHitValue == doubleTarget.lastHitValue);
+                }
+              }
+            }
+          }
+        }
+        if (source.isCentered) {
+          WHEN("processing the center value") {
+            auto modeProcessor = createAbsoluteModeProcessor(0.0, 1.0, 0.0, 1.0, false, false);
+            TestTarget target;
+            modeProcessor.processSourceValuePreferringFixedPoint(source.createValue(8192), source.processor, target);
+            THEN("the target should be hit with exactly 0.5") {
+              REQUIRE(target.lastHitValue == 0.5);
+            }
+          }
+        }
+      }
+    }
+    GIVEN("Modes which don't support the fixed-point path") {
+      Mode relativeMode;
+      relativeMode.type.set(ModeType::Relative);
+      Mode eelMode;
+      eelMode.eelControlTransformation.set("y = 1 - x");
+      TestTarget target;
+      THEN("they should say so") {
+        REQUIRE(!relativeMode.getProcessor().supportsFixedPointProcessing());
+        REQUIRE(!eelMode.getProcessor().supportsFixedPointProcessing());
+        REQUIRE_THROWS_AS(eelMode.getProcessor().processFixedPointSourceValue(0, SourceProcessor(), target),
+            std::logic_error);
+      }
+    }
+    GIVEN("An encoder source") {
+      const SourceProcessor processor(SourceType::ControlChangeValue, 0, false, false, 7, SourceCharacter::Encoder1,
+          MidiClockTransportMessageType::Start);
+      THEN("it shouldn't provide fixed-point values") {
+        REQUIRE(!processor.getFixedPointValue(SourceValue(MidiMessage::controlChange(0, 7, 1))));
+      }
+    }
+  }
+}
@@ -0,0 +1,147 @@
+#include <catch.hpp>
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/ProcessorStatistics.h>
+#include <helgoboss-learn/Source.h>
+#include "TestSourceContext.h"
+#include "TestTarget.h"
+
+namespace helgoboss {
+  SCENARIO("Processor statistics") {
+    GIVEN("A source and mode with attached statistics") {
+      ProcessorStatistics statistics;
+      Source source;
+      source.type.set(SourceType::ControlChangeValue);
+      source.channel.set(0);
+      source.midiMessageNumber.set(7);
+      source.setStatistics(&statistics);
+      Mode mode;
+      mode.type.set(ModeType::Absolute);
+      mode.minSourceValue.set(0.2);
+      mode.maxSourceValue.set(0.8);
+      mode.setStatistics(&statistics);
+      TestTarget target;
+      const auto process = [&](int value) {
+        const auto sourceValue = SourceValue(MidiMessage::controlChange(0, 7, value));
+        if (source.getProcessor().processes(sourceValue)) {
+          mode.getProcessor().processSourceValue(source.getProcessor().getNormalizedValue(sourceValue),
+              source.getProcessor(), target);
+        }
+      };
+      WHEN("matching and non-matching events are processed") {
+        process(64);
+        process(0);
+        mode.ignoreOutOfRangeSourceValuesIsEnabled.set(true);
+        process(127);
+        source.getProcessor().processes(SourceValue(MidiMessage::controlChange(0, 8, 64)));
+        const auto snapshot = statistics.getSnapshot();
+        THEN("matched events, out-of-range events and target hits should be counted") {
+          REQUIRE(snapshot.matchedEventCount == 3);
+          REQUIRE(snapshot.outOfRangeEventCount == 2);
+          REQUIRE(snapshot.targetHitCount == 2);
+          REQUIRE(target.hitCount == 2);
+          REQUIRE(snapshot.toString().find("hits=2") != std::string::npos);
+        }
+      }
+      WHEN("the target jump settings prevent hits") {
+        mode.minSourceValue.set(0.0);
+        mode.maxSourceValue.set(1.0);
+        mode.minTargetJump.set(0.1);
+        mode.maxTargetJump.set(0.2);
+        // The current value of the test target is always 0.5
+        process(64);
+        process(0);
+        process(80);
+        const auto snapshot = statistics.getSnapshot();
+        THEN("suppressed jumps should be counted") {
+          REQUIRE(snapshot.suppressedJumpCount == 2);
+          REQUIRE(snapshot.targetHitCount == 1);
+        }
+      }
+      WHEN("EEL transformations are executed") {
+        mode.minSourceValue.set(0.0);
+        mode.maxSourceValue.set(1.0);
+        mode.eelControlTransformation.set("y = 1 - x");
+        mode.eelFeedbackTransformation.set("x = 1 - x");
+        process(64);
+        TestSourceContext context;
+        mode.feedback(source, target, context);
+        const auto snapshot = statistics.getSnapshot();
+        THEN("their executions should be counted") {
+          REQUIRE(snapshot.controlTransformationCount == 1);
+          REQUIRE(snapshot.feedbackTransformationCount == 1);
+        }
+      }
+      WHEN("feedback is sent") {
+        TestSourceContext context;
+        mode.feedback(source, target, context);
+        source.is14Bit.set(true);
+        mode.feedback(source, target, context);
+        const auto snapshot = statistics.getSnapshot();
+        THEN("each sent MIDI message should be counted") {
+          REQUIRE(context.oneCount == 1);
+          REQUIRE(context.twoCount == 1);
+          REQUIRE(snapshot.feedbackMessageCount == 3);
+        }
+      }
+      WHEN("source and mode are copied") {
+        const Source sourceCopy(source);
+        Mode modeCopy(mode);
+        sourceCopy.getProcessor().processes(SourceValue(MidiMessage::controlChange(0, 7, 64)));
+        TestTarget copyTarget;
+        modeCopy.getProcessor().processSourceValue(0.5, sourceCopy.getProcessor(), copyTarget);
+        const auto snapshot = statistics.getSnapshot();
+        THEN("the copies shouldn't count into the original statistics") {
+          REQUIRE(copyTarget.hitCount == 1);
+          REQUIRE(snapshot.matchedEventCount == 0);
+          REQUIRE(snapshot.targetHitCount == 0);
+        }
+      }
+      WHEN("other sources are assigned to the source and vice versa") {
+        ProcessorStatistics otherStatistics;
+        Source otherSource;
+        otherSource.setStatistics(&otherStatistics);
+        Source lazySource(ProcessorActivation::Lazy);
+        Source assignedSource;
+        assignedSource.midiMessageNumber.set(8);
+        source = assignedSource;
+        lazySource = source;
+        otherSource = source;
+        source.getProcessor().processes(SourceValue(MidiMessage::controlChange(0, 8, 64)));
+        otherSource.getProcessor().processes(SourceValue(MidiMessage::controlChange(0, 8, 64)));
+        THEN("each should take over the settings but keep its own statistics and activation") {
+          REQUIRE(source.midiMessageNumber.get() == 8);
+          REQUIRE(statistics.getSnapshot().matchedEventCount == 1);
+          REQUIRE(otherStatistics.getSnapshot().matchedEventCount == 1);
+          REQUIRE(!lazySource.isWarmedUp());
+          REQUIRE(lazySource == source);
+        }
+      }
+      WHEN("the statistics are detached") {
+        source.setStatistics(nullptr);
+        mode.setStatistics(nullptr);
+        process(64);
+        const auto snapshot = statistics.getSnapshot();
+        THEN("nothing should be counted anymore") {
+          REQUIRE(target.hitCount == 1);
+          REQUIRE(snapshot.matchedEventCount == 0);
+          REQUIRE(snapshot.targetHitCount == 0);
+        }
+      }
+    }
+    GIVEN("Two snapshots") {
+      ProcessorStatistics statistics;
+      statistics.countTargetHit();
+      const auto before = statistics.getSnapshot();
+      statistics.countTargetHit();
+      statistics.countTargetHit();
+      statistics.countFeedbackMessages(2);
+      const auto after = statistics.getSnapshot();
+      THEN("their difference should contain the counts in between") {
+        const auto difference = after - before;
+        REQUIRE(difference.targetHitCount == 2);
+        REQUIRE(difference.feedbackMessageCount == 2);
+        REQUIRE(difference.matchedEventCount == 0);
+      }
+    }
+  }
+}
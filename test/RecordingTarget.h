@@ -0,0 +1,41 @@
+#pragma once
+
+#include <helgoboss-learn/Target.h>
+#include <vector>
+
+namespace helgoboss {
+  // Continuous target which remembers its value and all hits
+  class RecordingTarget : public Target {
+  public:
+    double value = 0.5;
+    std::vector<double> hitValues;
+
+    RecordingTarget() = default;
+
+    explicit RecordingTarget(double value) : value(value) {
+    }
+
+    TargetCharacter getCharacter() const override {
+      return TargetCharacter::Continuous;
+    }
+    double getStepSize() const override {
+      return -1;
+    }
+    bool wantsToBeHitWithStepCounts() const override {
+      return false;
+    }
+    void hit(double normalizedValue, bool isStepCount) override {
+      value = normalizedValue;
+      hitValues.push_back(normalizedValue);
+    }
+    double getCurrentValue() const override {
+      return value;
+    }
+    int getMaxStepCount() const override {
+      return -1;
+    }
+    bool canBeDiscrete() const override {
+      return false;
+    }
+  };
+}
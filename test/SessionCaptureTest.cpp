@@ -0,0 +1,131 @@
+#include <catch.hpp>
+#include <helgoboss-learn/SessionCapture.h>
+#include <helgoboss-learn/SessionReplay.h>
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/Source.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace helgoboss {
+  namespace {
+    std::string recordSession(const Source& source, const Mode& mode, int eventCount) {
+      SessionRecorder recorder({{&source, &mode}}, eventCount);
+      for (int i = 0; i < eventCount; i++) {
+        recorder.record(i * 1000000ULL, SourceValue(MidiMessage::controlChange(0, 7, (i * 7) % 128)));
+      }
+      return recorder.toBytes();
+    }
+  }
+
+  SCENARIO("Session captures") {
+    GIVEN("A recorder for one mapping") {
+      Source source;
+      source.channel.set(0);
+      source.midiMessageNumber.set(7);
+      Mode mode;
+      mode.minTargetValue.set(0.25);
+      mode.eelControlTransformation.set("y = 1 - x");
+      SessionRecorder recorder({{&source, &mode}});
+      WHEN("source values of all types have been recorded") {
+        recorder.record(100, SourceValue(MidiMessage::controlChange(0, 7, 64)));
+        recorder.record(100, SourceValue(MidiMessage::pitchBendChange(3, 8192)));
+        recorder.record(5000000000ULL, SourceValue(MidiParameterNumberMessage(2, 1000, 16000, true, true)));
+        recorder.record(5000000001ULL, SourceValue(Midi14BitCcMessage(1, 20, 12345)));
+        recorder.record(5000000002ULL, SourceValue(TempoMessage{123.5}));
+        const auto bytes = recorder.toBytes();
+        const SessionCaptureView capture(bytes.data(), bytes.size());
+        THEN("they should be read back unchanged") {
+          REQUIRE(capture.getEventCount() == 5);
+          const auto events = capture.readEvents();
+          REQUIRE(events.size() == 5);
+          REQUIRE(events[0].timestamp == 100);
+          REQUIRE(events[0].value.getAsMidiMessage().getControlValue() == 64);
+          REQUIRE(events[1].timestamp == 100);
+          REQUIRE(events[1].value.getAsMidiMessage().getChannel() == 3);
+          REQUIRE(events[1].value.getAsMidiMessage().getPitchBendValue() == 8192);
+          REQUIRE(events[2].timestamp == 5000000000ULL);
+          const auto& parameterNumberMsg = events[2].value.getAsMidiParameterNumberMessage();
+          REQUIRE(parameterNumberMsg.getChannel() == 2);
+          REQUIRE(parameterNumberMsg.getNumber() == 1000);
+          REQUIRE(parameterNumberMsg.getValue() == 16000);
+          REQUIRE(parameterNumberMsg.isRegistered());
+          REQUIRE(parameterNumberMsg.is14bit());
+          const auto& ccMsg = events[3].value.getAsMidi14BitCcMessage();
+          REQUIRE(ccMsg.getChannel() == 1);
+          REQUIRE(ccMsg.getMsbControllerNumber() == 20);
+          REQUIRE(ccMsg.getValue() == 12345);
+          REQUIRE(events[4].value.getAsTempoMessage().bpm == 123.5);
+        }
+        THEN("the preset should be contained") {
+          const auto preset = capture.getPreset();
+          REQUIRE(preset.getMappingCount() == 1);
+          Source loadedSource;
+          Mode loadedMode;
+          preset.loadMapping(0, {&loadedSource, &loadedMode});
+          REQUIRE(loadedSource.midiMessageNumber.get() == 7);
+          REQUIRE(loadedMode.minTargetValue.get() == 0.25);
+          REQUIRE(loadedMode.eelControlTransformation.get() == "y = 1 - x");
+        }
+        THEN("a timestamp going backwards should be refused") {
+          REQUIRE_THROWS(recorder.record(99, SourceValue(MidiMessage::controlChange(0, 7, 64))));
+        }
+        THEN("truncated data should be refused") {
+          REQUIRE_THROWS_AS(SessionCaptureView(bytes.data(), 10), std::runtime_error);
+          const SessionCaptureView truncatedCapture(bytes.data(), bytes.size() - 1);
+          REQUIRE_THROWS_AS(truncatedCapture.readEvents(), std::runtime_error);
+        }
+      }
+    }
+  }
+
+  SCENARIO("Session replay") {
+    GIVEN("A recorded session") {
+      Source source;
+      source.channel.set(0);
+      source.midiMessageNumber.set(7);
+      Mode mode;
+      const int eventCount = 1000;
+      const auto bytes = recordSession(source, mode, eventCount);
+      const SessionCaptureView capture(bytes.data(), bytes.size());
+      WHEN("it's replayed twice") {
+        const auto first = util::replaySession(capture);
+        const auto second = util::replaySession(capture);
+        THEN("both replays should behave exactly the same") {
+          REQUIRE(first.eventCount == eventCount);
+          REQUIRE(first.mappingCount == 1);
+          REQUIRE(first.targetHitCount == eventCount);
+          REQUIRE(first.feedbackMessageCount == eventCount);
+          REQUIRE(first.controlChecksum == second.controlChecksum);
+          REQUIRE(first.feedbackChecksum == second.feedbackChecksum);
+          REQUIRE(first.latencies.at("endToEnd").at("count") == eventCount);
+          REQUIRE(first.toJson().at("controlChecksum") == std::to_string(first.controlChecksum));
+        }
+      }
+      WHEN("it's replayed without feedback") {
+        const auto result = util::replaySession(capture, false);
+        THEN("no feedback should be sent") {
+          REQUIRE(result.targetHitCount == eventCount);
+          REQUIRE(result.feedbackMessageCount == 0);
+        }
+      }
+      WHEN("the same events are replayed with different presets") {
+        mode.reverseIsEnabled.set(true);
+        const auto reversedBytes = recordSession(source, mode, eventCount);
+        mode.reverseIsEnabled.set(false);
+        mode.eelFeedbackTransformation.set("x = 1 - x");
+        const auto invertedFeedbackBytes = recordSession(source, mode, eventCount);
+        const auto original = util::replaySession(capture);
+        const auto reversed = util::replaySession(SessionCaptureView(reversedBytes.data(), reversedBytes.size()));
+        const auto invertedFeedback = util::replaySession(
+            SessionCaptureView(invertedFeedbackBytes.data(), invertedFeedbackBytes.size()));
+        THEN("the checksums should reveal the behavioral differences") {
+          REQUIRE(reversed.targetHitCount == original.targetHitCount);
+          REQUIRE(reversed.controlChecksum != original.controlChecksum);
+          REQUIRE(invertedFeedback.controlChecksum == original.controlChecksum);
+          REQUIRE(invertedFeedback.feedbackChecksum != original.feedbackChecksum);
+        }
+      }
+    }
+  }
+}
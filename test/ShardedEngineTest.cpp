@@ -0,0 +1,128 @@
+#include <catch.hpp>
+#include <helgoboss-learn/ShardedEngine.h>
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/Source.h>
+#include "RecordingTarget.h"
+#include <memory>
+#include <vector>
+
+namespace helgoboss {
+  namespace {
+    constexpr int PORT_COUNT = 8;
+    constexpr int MAPPINGS_PER_PORT = 16;
+    constexpr int TARGET_COUNT = 64;
+
+    // Some targets are controlled from several ports
+    std::vector<std::unique_ptr<RecordingTarget>> createAndAddMappings(ShardedEngine& engine) {
+      std::vector<std::unique_ptr<RecordingTarget>> targets;
+      for (int i = 0; i < TARGET_COUNT; i++) {
+        targets.push_back(std::make_unique<RecordingTarget>());
+      }
+      for (int port = 0; port < PORT_COUNT; port++) {
+        for (int i = 0; i < MAPPINGS_PER_PORT; i++) {
+          Source source;
+          source.channel.set(0);
+          source.midiMessageNumber.set(i);
+          Mode mode;
+          mode.reverseIsEnabled.set((port + i) % 2 == 1);
+          mode.maxTargetJump.set(i % 3 == 0 ? 0.1 : 1.0);
+          mode.minTargetValue.set(i % 4 == 0 ? 0.2 : 0.0);
+          auto& target = *targets[(port * MAPPINGS_PER_PORT + i * 5) % TARGET_COUNT];
+          engine.addMapping(port, source.getProcessor(), mode.getProcessor(), target);
+        }
+      }
+      return targets;
+    }
+
+    std::vector<PortEvent> createEvents(int eventCount) {
+      std::vector<PortEvent> events;
+      for (int i = 0; i < eventCount; i++) {
+        events.push_back({i % PORT_COUNT, SourceValue(MidiMessage::controlChange(0, i % MAPPINGS_PER_PORT, i % 128))});
+      }
+      return events;
+    }
+  }
+
+  SCENARIO("Sharded engine") {
+    GIVEN("Engines with different worker counts and the same mappings") {
+      ShardedEngine singleEngine(1);
+      ShardedEngine multiEngine(4);
+      const auto singleTargets = createAndAddMappings(singleEngine);
+      const auto multiTargets = createAndAddMappings(multiEngine);
+      REQUIRE(singleEngine.getShardCount() == 1);
+      REQUIRE(multiEngine.getShardCount() == 4);
+      WHEN("the same batches are processed") {
+        const auto events = createEvents(2000);
+        for (int i = 0; i < 3; i++) {
+          singleEngine.process(events);
+          multiEngine.process(events);
+        }
+        THEN("the targets should be hit exactly the same way") {
+          std::size_t hitCount = 0;
+          for (int i = 0; i < TARGET_COUNT; i++) {
+            REQUIRE(multiTargets[i]->hitValues == singleTargets[i]->hitValues);
+            REQUIRE(multiTargets[i]->value == singleTargets[i]->value);
+            hitCount += singleTargets[i]->hitValues.size();
+          }
+          REQUIRE(hitCount > 0);
+        }
+      }
+    }
+
+    GIVEN("A target controlled from two ports, one of them with limited jumps") {
+      ShardedEngine engine(2);
+      RecordingTarget target;
+      Source source;
+      source.channel.set(0);
+      source.midiMessageNumber.set(7);
+      Mode mode;
+      engine.addMapping(1, source.getProcessor(), mode.getProcessor(), target);
+      mode.maxTargetJump.set(0.1);
+      engine.addMapping(2, source.getProcessor(), mode.getProcessor(), target);
+      WHEN("events for both ports arrive in one batch") {
+        engine.process({
+            {1, SourceValue(MidiMessage::controlChange(0, 7, 127))},
+            {2, SourceValue(MidiMessage::controlChange(0, 7, 127))}
+        });
+        THEN("the second mapping should see the hit of the first one, as if there was only one worker") {
+          REQUIRE(target.hitValues.size() == 2);
+          REQUIRE(target.hitValues[0] == Approx(1.0));
+          REQUIRE(target.hitValues[1] == Approx(1.0));
+        }
+      }
+    }
+
+    GIVEN("A target controlled from two ports which would end up in different shards round robin") {
+      ShardedEngine engine(2);
+      RecordingTarget target;
+      Source source;
+      source.channel.set(0);
+      source.midiMessageNumber.set(7);
+      Mode mode;
+      engine.addMapping(1, source.getProcessor(), mode.getProcessor(), target);
+      mode.reverseIsEnabled.set(true);
+      engine.addMapping(2, source.getProcessor(), mode.getProcessor(), target);
+      WHEN("events for both ports arrive in one batch") {
+        engine.process({
+            {2, SourceValue(MidiMessage::controlChange(0, 7, 127))},
+            {1, SourceValue(MidiMessage::controlChange(0, 7, 127))}
+        });
+        THEN("the hits should be applied in event order") {
+          REQUIRE(target.hitValues.size() == 2);
+          REQUIRE(target.hitValues[0] == Approx(0.0));
+          REQUIRE(target.hitValues[1] == Approx(1.0));
+          REQUIRE(target.value == Approx(1.0));
+        }
+      }
+      WHEN("events arrive on unknown ports") {
+        engine.process({
+            {3, SourceValue(MidiMessage::controlChange(0, 7, 127))},
+            {-1, SourceValue(MidiMessage::controlChange(0, 7, 0))}
+        });
+        THEN("they should be ignored") {
+          REQUIRE(target.hitValues.empty());
+        }
+      }
+    }
+  }
+}
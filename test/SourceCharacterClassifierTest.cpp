@@ -0,0 +1,92 @@
+#include <catch.hpp>
+#include <helgoboss-learn/SourceCharacterClassifier.h>
+#include <helgoboss-learn/source-util.h>
+
+namespace helgoboss {
+  namespace {
+    struct Capture {
+      const char* description;
+      std::vector<int> controlValues;
+      // Maximum number of messages after which the classifier should have decided
+      int maxDecisionMessageCount;
+    };
+
+    // CC value sequences as sent by typical controllers when turning a control for the first time during learn.
+    // A maxDecisionMessageCount of 0 means that the classifier is not expected to decide early, so learning falls
+    // back to the timeout.
+    const std::vector<Capture> captures{
+        {"Fader moved up slowly", {20, 21, 22, 24, 25, 26, 27, 29, 30, 31}, 5},
+        {"Fader moved down slowly", {100, 99, 97, 96, 94, 93, 91, 90, 88, 87}, 5},
+        {"Knob turned up fast", {10, 14, 19, 25, 32, 40, 49, 58, 66, 73}, 5},
+        {"Fader jumped", {0, 40, 90, 127}, 0},
+        {"Encoder 1 turned clockwise", {1, 1, 1, 1, 1, 1, 1, 1, 1, 1}, 4},
+        {"Encoder 1 turned counter-clockwise", {127, 127, 127, 127, 127, 127, 127, 127, 127, 127}, 4},
+        {"Encoder 1 accelerating", {1, 2, 3, 3, 3, 2, 1, 1, 1, 1}, 6},
+        {"Encoder 2 turned clockwise", {65, 65, 65, 66, 65, 65, 65, 65, 65, 65}, 4},
+        {"Encoder 2 turned counter-clockwise", {63, 63, 62, 63, 63, 63, 63, 63, 63, 63}, 4},
+        {"Encoder 3 turned fast", {12, 12, 12, 12, 12, 12, 12, 12, 12, 12}, 4},
+        {"Fader jittering", {64, 65, 64, 65, 64, 65, 64, 65, 64, 65}, 5},
+        {"Button pressed and released", {127, 0}, 2},
+        {"Button pressed and held", {127}, 0},
+        {"Pad pressed softly and released", {37, 0}, 2}
+    };
+
+    std::vector<MidiMessage> toMidiMessages(const std::vector<int>& controlValues) {
+      std::vector<MidiMessage> msgs;
+      for (const auto v : controlValues) {
+        msgs.push_back(MidiMessage::controlChange(0, 7, v));
+      }
+      return msgs;
+    }
+  }
+
+  SCENARIO("Guess source character incrementally") {
+    GIVEN("Captures of typical controllers") {
+      WHEN("replayed through the classifier") {
+        THEN("it should decide early and agree with the batch algorithm") {
+          for (const auto& capture : captures) {
+            INFO(capture.description);
+            const auto expectedCharacter = util::guessSourceCharacter(toMidiMessages(capture.controlValues));
+            SourceCharacterClassifier classifier;
+            boost::optional<SourceCharacterGuess> decision;
+            for (const auto v : capture.controlValues) {
+              decision = classifier.feed(v);
+              if (decision) {
+                break;
+              }
+            }
+            if (capture.maxDecisionMessageCount == 0) {
+              REQUIRE(!decision.has_value());
+              REQUIRE(classifier.guess().character == expectedCharacter);
+            } else {
+              REQUIRE(decision.has_value());
+              REQUIRE(classifier.getValueCount() <= capture.maxDecisionMessageCount);
+              REQUIRE(decision->character == expectedCharacter);
+              REQUIRE(decision->confidence == 1.0);
+            }
+          }
+        }
+      }
+      WHEN("fed completely") {
+        THEN("the guess should always equal the batch algorithm") {
+          for (const auto& capture : captures) {
+            INFO(capture.description);
+            SourceCharacterClassifier classifier;
+            std::vector<int> valuesSoFar;
+            for (const auto v : capture.controlValues) {
+              classifier.feed(v);
+              valuesSoFar.push_back(v);
+              const auto guess = classifier.guess();
+              REQUIRE(guess.character == util::guessSourceCharacter(toMidiMessages(valuesSoFar)));
+              REQUIRE(guess.confidence > 0.0);
+              REQUIRE(guess.confidence <= 1.0);
+            }
+            classifier.reset();
+            REQUIRE(classifier.getValueCount() == 0);
+            REQUIRE(classifier.guess().confidence == 0.0);
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,143 @@
+#include <catch.hpp>
+#include <helgoboss-learn/SourceConflictFinder.h>
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+namespace helgoboss {
+  namespace {
+    constexpr int CHANNEL_COUNT = 2;
+    constexpr int NUMBER_COUNT = 3;
+
+    // Creates sources with small value ranges (including "any"), so there are lots of duplicates and overlaps
+    std::vector<Source> createSources(int count) {
+      std::vector<Source> sources(count);
+      unsigned int seed = 42;
+      const auto next = [&seed](int max) {
+        seed = seed * 1103515245 + 12345;
+        return static_cast<int>((seed >> 16) % max);
+      };
+      for (auto& source : sources) {
+        source.type.set(static_cast<SourceType>(next(NUM_SOURCE_TYPES)));
+        source.channel.set(next(CHANNEL_COUNT + 1) - 1);
+        source.midiMessageNumber.set(next(NUMBER_COUNT + 1) - 1);
+        source.parameterNumberMessageNumber.set(next(NUMBER_COUNT + 1) - 1);
+        source.is14Bit.set(next(2) == 1);
+        source.isRegistered.set(next(2) == 1);
+        source.customCharacter.set(static_cast<SourceCharacter>(next(2)));
+        source.midiClockTransportMessageType.set(static_cast<MidiClockTransportMessageType>(next(3)));
+      }
+      return sources;
+    }
+
+    // Covers all messages the sources above could react to
+    std::vector<SourceValue> createAllRelevantValues() {
+      std::vector<SourceValue> values;
+      for (int ch = 0; ch < CHANNEL_COUNT; ch++) {
+        for (int n = 0; n < NUMBER_COUNT; n++) {
+          values.emplace_back(MidiMessage::controlChange(ch, n, 1));
+          values.emplace_back(MidiMessage::noteOn(ch, n, 1));
+          values.emplace_back(MidiMessage::noteOff(ch, n, 0));
+          values.emplace_back(MidiMessage::polyphonicKeyPressure(ch, n, 1));
+          values.emplace_back(Midi14BitCcMessage(ch, n, 1));
+          for (const bool isRegistered : {false, true}) {
+            for (const bool is14Bit : {false, true}) {
+              values.emplace_back(MidiParameterNumberMessage(ch, n, 1, isRegistered, is14Bit));
+            }
+          }
+        }
+        values.emplace_back(MidiMessage::pitchBendChange(ch, 1));
+        values.emplace_back(MidiMessage::channelPressure(ch, 1));
+        values.emplace_back(MidiMessage::programChange(ch, 1));
+      }
+      values.emplace_back(MidiMessage::start());
+      values.emplace_back(MidiMessage::continueMessage());
+      values.emplace_back(MidiMessage::stop());
+      values.emplace_back(TempoMessage{120});
+      return values;
+    }
+  }
+
+  SCENARIO("Source conflict finder") {
+    GIVEN("Lots of similar sources") {
+      const auto sources = createSources(300);
+      std::vector<const Source*> sourcePointers;
+      for (const auto& source : sources) {
+        sourcePointers.push_back(&source);
+      }
+      const SourceConflictFinder finder(sourcePointers);
+      THEN("equal sources and their processors should have equal hashes") {
+        for (const bool ignoreCustomCharacter : {false, true}) {
+          for (const bool ignoreChannel : {false, true}) {
+            for (std::size_t i = 0; i < sources.size(); i++) {
+              for (std::size_t j = i + 1; j < sources.size(); j++) {
+                const auto& lhs = sources[i].getProcessor();
+                const auto& rhs = sources[j].getProcessor();
+                const bool areEqual = sources[i].equals(sources[j], ignoreCustomCharacter, ignoreChannel);
+                REQUIRE(lhs.equals(rhs, ignoreCustomCharacter, ignoreChannel) == areEqual);
+                if (areEqual) {
+                  REQUIRE(sources[i].hash(ignoreCustomCharacter, ignoreChannel)
+                      == sources[j].hash(ignoreCustomCharacter, ignoreChannel));
+                  REQUIRE(lhs.hash(ignoreCustomCharacter, ignoreChannel)
+                      == rhs.hash(ignoreCustomCharacter, ignoreChannel));
+                }
+              }
+            }
+          }
+        }
+        REQUIRE(std::hash<Source>()(sources[0]) == sources[0].hash(false, false));
+        REQUIRE(std::hash<SourceProcessor>()(sources[0].getProcessor()) == sources[0].hash(false, false));
+      }
+      THEN("it should find the same duplicates as comparing each source with each other") {
+        for (const bool ignoreCustomCharacter : {false, true}) {
+          for (const bool ignoreChannel : {false, true}) {
+            const auto groups = finder.findDuplicates(ignoreCustomCharacter, ignoreChannel);
+            REQUIRE(!groups.empty());
+            std::vector<int> groupIndexes(sources.size(), -1);
+            for (std::size_t g = 0; g < groups.size(); g++) {
+              REQUIRE(groups[g].size() > 1);
+              for (const auto i : groups[g]) {
+                groupIndexes[i] = static_cast<int>(g);
+              }
+            }
+            for (std::size_t i = 0; i < sources.size(); i++) {
+              for (std::size_t j = i + 1; j < sources.size(); j++) {
+                const bool isDuplicate = groupIndexes[i] != -1 && groupIndexes[i] == groupIndexes[j];
+                REQUIRE(sources[i].equals(sources[j], ignoreCustomCharacter, ignoreChannel) == isDuplicate);
+              }
+            }
+          }
+        }
+      }
+      THEN("it should find exactly the pairs of sources which react to a common message") {
+        const auto values = createAllRelevantValues();
+        std::vector<SourceOverlap> expectedOverlaps;
+        for (std::size_t i = 0; i < sources.size(); i++) {
+          for (std::size_t j = i + 1; j < sources.size(); j++) {
+            for (const auto& value : values) {
+              if (sources[i].getProcessor().processes(value) && sources[j].getProcessor().processes(value)) {
+                expectedOverlaps.push_back({i, j});
+                break;
+              }
+            }
+          }
+        }
+        REQUIRE(!expectedOverlaps.empty());
+        REQUIRE(finder.findOverlaps() == expectedOverlaps);
+      }
+      THEN("it should find the overlaps with a new source") {
+        Source source;
+        source.type.set(SourceType::NoteVelocity);
+        source.channel.set(-1);
+        source.midiMessageNumber.set(1);
+        const auto overlaps = finder.findOverlapsWith(source);
+        REQUIRE(!overlaps.empty());
+        for (std::size_t i = 0; i < sources.size(); i++) {
+          const bool reactsToCommonNote = sources[i].getProcessor().processes(SourceValue(MidiMessage::noteOn(0, 1, 1)))
+              || sources[i].getProcessor().processes(SourceValue(MidiMessage::noteOn(1, 1, 1)));
+          REQUIRE(std::binary_search(overlaps.begin(), overlaps.end(), i) == reactsToCommonNote);
+        }
+      }
+    }
+  }
+}
@@ -5,6 +5,7 @@
 #include <helgoboss-learn/Target.h>
 #include <helgoboss-learn/source-util.h>
 #include "TestSourceContext.h"
+#include "AllocationCounter.h"
 
 using rxcpp::observable;
 
@@ -47,6 +48,9 @@ namespace helgoboss {
           REQUIRE(sourceProcessor.processes(goodSourceValue));
           // TODO See above
 //        REQUIRE(source.getNormalizedValue(goodSourceValue) == 0.5);
+          // The fixed-point path gets it right
+          REQUIRE(sourceProcessor.getFixedPointValue(goodSourceValue).has_value());
+          REQUIRE(*sourceProcessor.getFixedPointValue(goodSourceValue) == util::FIXED_POINT_HALF);
           REQUIRE(!sourceProcessor.consumes(MidiMessage::noteOn(13, 100, 100)));
           REQUIRE(!sourceProcessor.consumes(MidiMessage::pitchBendChange(13, 8192)));
           REQUIRE(sourceProcessor.getMaxStepCount() == 63);
@@ -56,6 +60,63 @@ namespace helgoboss {
     }
   }
 
+  SCENARIO("Format sources into caller-provided buffers") {
+    GIVEN("Sources of different types") {
+      std::vector<Source> sources(6);
+      sources.at(0).type.set(SourceType::ControlChangeValue);
+      sources.at(0).channel.set(15);
+      sources.at(0).midiMessageNumber.set(74);
+      sources.at(1).type.set(SourceType::NoteVelocity);
+      sources.at(1).channel.set(-1);
+      sources.at(1).midiMessageNumber.set(-1);
+      sources.at(2).type.set(SourceType::ParameterNumberMessageValue);
+      sources.at(2).parameterNumberMessageNumber.set(16383);
+      sources.at(2).isRegistered.set(true);
+      sources.at(3).type.set(SourceType::ClockTempo);
+      sources.at(4).type.set(SourceType::ClockTransport);
+      sources.at(4).midiClockTransportMessageType.set(MidiClockTransportMessageType::Continue);
+      sources.at(5).type.set(SourceType::PitchBendChangeValue);
+      WHEN("formatted into buffers") {
+        char buffer[Source::MAX_STRING_SIZE];
+        THEN("the result should be the same as the one of the string variants") {
+          for (const auto& source : sources) {
+            REQUIRE(std::string(buffer, source.toString(buffer, sizeof(buffer))) == source.toString());
+            REQUIRE(std::string(buffer, source.formatNormalizedValue(0.7, buffer, sizeof(buffer))) ==
+                source.formatNormalizedValue(0.7));
+          }
+          REQUIRE(sources.at(0).toString() == "CC value\nChannel 16\nCC number 74");
+          REQUIRE(sources.at(1).toString() == "Note velocity\nAny channel\nAny note");
+          REQUIRE(sources.at(2).toString() == "RPN\nChannel 1\nNumber 16383");
+          REQUIRE(sources.at(4).toString() == "MIDI clock\nContinue");
+          REQUIRE(sources.at(3).formatNormalizedValue(0.5) == "480.50");
+          REQUIRE(sources.at(4).formatNormalizedValue(0.5) == "1");
+          REQUIRE(sources.at(5).formatNormalizedValue(0.0) == "-8192");
+          REQUIRE(Tempo(120).toString() == "120.0000 bpm");
+          REQUIRE(std::string(buffer, Tempo(960).toStringWithoutUnit(buffer, sizeof(buffer))) == "960.0000");
+        }
+        THEN("no memory should be allocated") {
+          AllocationCounter counter;
+          std::size_t totalSize = 0;
+          for (const auto& source : sources) {
+            totalSize += source.toString(buffer, sizeof(buffer));
+            totalSize += source.formatNormalizedValue(0.3, buffer, sizeof(buffer));
+          }
+          totalSize += Tempo(133.3).toString(buffer, sizeof(buffer));
+          REQUIRE(counter.getCount() == 0);
+          REQUIRE(totalSize > 0);
+        }
+      }
+      WHEN("formatted into a buffer which is too small") {
+        char buffer[6];
+        const auto size = sources.at(0).toString(buffer, sizeof(buffer));
+        THEN("the result should be cut off and null-terminated") {
+          REQUIRE(size == 5);
+          REQUIRE(std::string(buffer) == "CC va");
+        }
+      }
+    }
+  }
+
   SCENARIO("Guess source character as range") {
     GIVEN("Some pretty continuous MIDI CC messages") {
       const std::vector<MidiMessage> messages{
@@ -144,4 +205,65 @@ namespace helgoboss {
       }
     }
   }
-}
\ No newline at end of file
+
+  SCENARIO("Parse source descriptors from non-CC MIDI messages") {
+    GIVEN("A note on message") {
+      WHEN("parsing next source descriptor") {
+        const auto descriptors = util::parseSourceDescriptors(
+            observable<>::from(
+                MidiMessage::noteOn(3, 64, 100)
+            ),
+            observable<>::empty<Midi14BitCcMessage>(),
+            observable<>::empty<MidiParameterNumberMessage>(),
+            rxcpp::identity_current_thread()
+        );
+        const SourceDescriptor nextDescriptor = descriptors
+            .take(1)
+            .as_blocking()
+            .first();
+        THEN("it should describe a note velocity source") {
+          REQUIRE(nextDescriptor.type == SourceType::NoteVelocity);
+          REQUIRE(nextDescriptor.channel == 3);
+          REQUIRE(nextDescriptor.midiMessageNumber == 64);
+          REQUIRE(!nextDescriptor.is14Bit);
+        }
+        THEN("materializing it should result in the same source as updating from the MIDI message") {
+          Source materializedSource;
+          materializedSource.updateFromDescriptor(nextDescriptor);
+          Source expectedSource;
+          expectedSource.updateFromMidiMessage(MidiMessage::noteOn(3, 64, 100));
+          REQUIRE(materializedSource == expectedSource);
+          REQUIRE(materializedSource.toDescriptor() == nextDescriptor);
+        }
+      }
+    }
+  }
+
+  SCENARIO("Parse high-resolution sources from raw CC messages") {
+    GIVEN("An MSB/LSB pair") {
+      WHEN("parsing next source descriptor") {
+        const auto descriptors = util::parseSourceDescriptors(
+            observable<>::from(
+                MidiMessage::controlChange(2, 7, 70),
+                MidiMessage::controlChange(2, 39, 3),
+                MidiMessage::controlChange(2, 7, 71),
+                MidiMessage::controlChange(2, 39, 0)
+            ),
+            observable<>::empty<Midi14BitCcMessage>(),
+            observable<>::empty<MidiParameterNumberMessage>(),
+            rxcpp::identity_current_thread()
+        );
+        const SourceDescriptor nextDescriptor = descriptors
+            .take(1)
+            .as_blocking()
+            .first();
+        THEN("it should describe a 14-bit CC source") {
+          REQUIRE(nextDescriptor.type == SourceType::ControlChangeValue);
+          REQUIRE(nextDescriptor.channel == 2);
+          REQUIRE(nextDescriptor.midiMessageNumber == 7);
+          REQUIRE(nextDescriptor.is14Bit);
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <helgoboss-learn/Source.h>
+#include <helgoboss-learn/Mode.h>
+
+namespace helgoboss {
+  const std::vector<std::string> TEST_EEL_SCRIPTS{
+      "",
+      "y = x * 0.5",
+      "y = \"quoted\" \\ backslash\n\ttabbed",
+      u8"y = x; // äöü"
+  };
+
+  // Gives each mapping different settings, depending on its index
+  inline void configureMapping(Source& source, Mode& mode, int i) {
+    source.type.set(static_cast<SourceType>(i % NUM_SOURCE_TYPES));
+    source.channel.set(i % 16);
+    source.midiMessageNumber.set(i % 128);
+    source.parameterNumberMessageNumber.set(i % 16384);
+    source.is14Bit.set(i % 3 == 0);
+    source.isRegistered.set(i % 5 == 0);
+    source.customCharacter.set(static_cast<SourceCharacter>(i % 5));
+    source.midiClockTransportMessageType.set(static_cast<MidiClockTransportMessageType>(i % 3));
+    mode.type.set(static_cast<ModeType>(i % NUM_MODE_TYPES));
+    mode.minSourceValue.set(1.0 / (i % 7 + 3));
+    mode.maxSourceValue.set(1.0 - 1.0 / (i % 11 + 3));
+    mode.minTargetValue.set(i % 2 == 0 ? 0.0 : 0.1);
+    mode.maxTargetValue.set(i % 4 == 0 ? 1.0 : 2.0 / 3.0);
+    mode.minTargetJump.set(i % 3 == 0 ? 0.0 : 1e-7);
+    mode.maxTargetJump.set(0.25);
+    mode.minStepSize.set(0.01);
+    mode.maxStepSize.set(0.05 * (i % 3 + 1));
+    mode.reverseIsEnabled.set(i % 2 == 1);
+    mode.ignoreOutOfRangeSourceValuesIsEnabled.set(i % 3 == 1);
+    mode.roundTargetValue.set(i % 4 == 1);
+    mode.scaleModeEnabled.set(i % 5 == 1);
+    mode.rotateIsEnabled.set(i % 6 == 1);
+    mode.eelControlTransformation.set(TEST_EEL_SCRIPTS.at(i % TEST_EEL_SCRIPTS.size()));
+    mode.eelFeedbackTransformation.set(TEST_EEL_SCRIPTS.at((i + 1) % TEST_EEL_SCRIPTS.size()));
+  }
+
+  // Serializes the mappings with the per-object functions
+  inline std::string serializeMappingsViaDom(const std::vector<Source>& sources, const std::vector<Mode>& modes,
+      bool useStringsForEnums) {
+    auto j = nlohmann::json::array();
+    for (std::size_t i = 0; i < sources.size(); i++) {
+      nlohmann::json mappingJson;
+      sources.at(i).serializeToJson(mappingJson["source"], useStringsForEnums);
+      modes.at(i).serializeToJson(mappingJson["mode"]);
+      j.push_back(mappingJson);
+    }
+    return j.dump();
+  }
+}
@@ -0,0 +1,64 @@
+#include <catch.hpp>
+#include <helgoboss-learn/fixed-point-util.h>
+#include <helgoboss-learn/math-util.h>
+#include <cmath>
+
+using helgoboss::util::FIXED_POINT_HALF;
+using helgoboss::util::FIXED_POINT_ONE;
+using helgoboss::util::mapDiscreteValueToFixedPoint;
+using helgoboss::util::mapFixedPointToDiscreteValue;
+
+namespace helgoboss {
+  static_assert(mapDiscreteValueToFixedPoint(8192, 16383, true) == FIXED_POINT_HALF);
+  static_assert(mapDiscreteValueToFixedPoint(0, 16383, true) == 0);
+  static_assert(mapDiscreteValueToFixedPoint(16383, 16383, true) == FIXED_POINT_ONE);
+  static_assert(mapFixedPointToDiscreteValue(FIXED_POINT_HALF, 16383, true) == 8192);
+  static_assert(util::toFixedPoint(0.5) == FIXED_POINT_HALF);
+  static_assert(util::toFixedPoint(-0.25) == -FIXED_POINT_ONE / 4);
+
+  SCENARIO("Fixed-point mapping methods") {
+    for (const int maxValue : {127, 16383}) {
+      for (const bool isCentered : {false, true}) {
+        GIVEN("Discrete values from 0 to " + std::to_string(maxValue) + (isCentered ? " centered" : "")) {
+          THEN("mapping to fixed point and back should yield the original value") {
+            for (int value = 0; value <= maxValue; value++) {
+              const auto fixedPointValue = mapDiscreteValueToFixedPoint(value, maxValue, isCentered);
+              REQUIRE(mapFixedPointToDiscreteValue(fixedPointValue, maxValue, isCentered) == value);
+            }
+          }
+          THEN("bounds should be mapped exactly") {
+            REQUIRE(mapDiscreteValueToFixedPoint(0, maxValue, isCentered) == 0);
+            REQUIRE(mapDiscreteValueToFixedPoint(maxValue, maxValue, isCentered) == FIXED_POINT_ONE);
+            REQUIRE(mapDiscreteValueToFixedPoint(-1, maxValue, isCentered) == 0);
+            REQUIRE(mapDiscreteValueToFixedPoint(maxValue + 1, maxValue, isCentered) == FIXED_POINT_ONE);
+          }
+          if (!isCentered) {
+            THEN("results should be the closest fixed-point values to the normalized double values") {
+              for (int value = 0; value <= maxValue; value++) {
+                const double normalizedValue = util::mapValueInRangeToNormalizedValue(value, 0, maxValue);
+                const auto fixedPointValue = mapDiscreteValueToFixedPoint(value, maxValue);
+                REQUIRE(fixedPointValue == util::toFixedPoint(normalizedValue));
+              }
+            }
+          }
+        }
+      }
+    }
+    GIVEN("Fixed-point ranges") {
+      const auto quarter = FIXED_POINT_ONE / 4;
+      const auto threeQuarters = 3 * FIXED_POINT_ONE / 4;
+      THEN("mapping should behave like with doubles") {
+        for (int value = 0; value <= FIXED_POINT_ONE; value += 97) {
+          const double doubleValue = util::fromFixedPoint(value);
+          REQUIRE(std::abs(
+              util::fromFixedPoint(util::mapFixedPointInRangeToNormalizedFixedPoint(value, threeQuarters, quarter))
+                  - util::mapValueInRangeToNormalizedValue(doubleValue, 0.75, 0.25)) <= 0.5 / FIXED_POINT_ONE);
+          REQUIRE(std::abs(
+              util::fromFixedPoint(util::mapNormalizedFixedPointToFixedPointInRange(value, threeQuarters, quarter))
+                  - util::mapNormalizedValueToValueInRange(doubleValue, 0.75, 0.25)) <= 0.5 / FIXED_POINT_ONE);
+        }
+        REQUIRE(util::mapFixedPointInRangeToNormalizedFixedPoint(quarter, quarter, quarter) == 0);
+      }
+    }
+  }
+}
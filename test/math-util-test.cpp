@@ -1,5 +1,7 @@
 #include <catch.hpp>
 #include <helgoboss-learn/math-util.h>
+#include <helgoboss-learn/Tempo.h>
+#include <cmath>
 #include <vector>
 
 using helgoboss::util::mapNormalizedValueToValueInRange;
@@ -189,4 +191,23 @@ namespace helgoboss {
         }
     });
   }
-}
\ No newline at end of file
+
+  SCENARIO("Negative zero at runtime") {
+    GIVEN("Negative zero") {
+      const double negativeZero = -0.0;
+      THEN("it should be mapped like a negative value, as before the mapping functions became constexpr") {
+        REQUIRE(mapNormalizedValueToValueInRange(negativeZero, 1, 3) == -1);
+        REQUIRE(std::signbit(mapValueInRangeToNormalizedValue(negativeZero, 1, 3)));
+      }
+    }
+  }
+
+  // The mapping functions can be evaluated at compile time
+  static_assert(mapValueInRangeToNormalizedValue(8192, 0, 16384) == 0.5);
+  static_assert(mapValueInRangeToNormalizedValue(-1.5, 1, 2) == -0.5);
+  static_assert(mapNormalizedValueToValueInRange(0.5, 1, 3) == 2);
+  static_assert(mapNormalizedValueToValueInRange(-1.2, 1, 3) == -3);
+  static_assert(mapValueInRangeToValueInRange(3, 1, 2, 0, 10) == 0);
+  static_assert(Tempo::ofNormalizedValue(1.0).bpm() == Tempo::MAX_BPM);
+  static_assert(Tempo(2000).normalizedValue() == 1.0);
+}
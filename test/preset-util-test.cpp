@@ -0,0 +1,185 @@
+#include <catch.hpp>
+#include <helgoboss-learn/preset-util.h>
+#include <sstream>
+#include <vector>
+#include "TestMappings.h"
+
+namespace helgoboss {
+  SCENARIO("Bulk preset serialization") {
+    GIVEN("Mappings of all kinds") {
+      const int mappingCount = 120;
+      std::vector<Source> sources(mappingCount);
+      std::vector<Mode> modes(mappingCount);
+      std::vector<ConstMappingRef> mappings;
+      for (int i = 0; i < mappingCount; i++) {
+        configureMapping(sources.at(i), modes.at(i), i);
+        mappings.push_back({&sources.at(i), &modes.at(i)});
+      }
+      WHEN("serialized in bulk") {
+        THEN("the result should be byte-identical to the per-object serialization") {
+          REQUIRE(util::serializeMappings(mappings) == serializeMappingsViaDom(sources, modes, false));
+          REQUIRE(util::serializeMappings(mappings, true) == serializeMappingsViaDom(sources, modes, true));
+          REQUIRE(util::serializeMappings({}) == nlohmann::json::array().dump());
+        }
+      }
+      WHEN("deserialized in bulk") {
+        std::vector<Source> loadedSources(mappingCount);
+        std::vector<Mode> loadedModes(mappingCount);
+        std::vector<MappingRef> loadedMappings;
+        for (int i = 0; i < mappingCount; i++) {
+          loadedMappings.push_back({&loadedSources.at(i), &loadedModes.at(i)});
+        }
+        util::deserializeMappings(nlohmann::json::parse(util::serializeMappings(mappings, true)), loadedMappings);
+        THEN("the mappings should be equal to the original ones") {
+          REQUIRE(serializeMappingsViaDom(loadedSources, loadedModes, false) ==
+              serializeMappingsViaDom(sources, modes, false));
+          for (int i = 0; i < mappingCount; i++) {
+            REQUIRE(loadedSources.at(i) == sources.at(i));
+          }
+        }
+        THEN("the processors should reflect the loaded settings") {
+          for (int i = 0; i < mappingCount; i++) {
+            const Source& source = loadedSources.at(i);
+            REQUIRE(source.getProcessor().getMaxDiscreteValue() == sources.at(i).getProcessor().getMaxDiscreteValue());
+          }
+        }
+      }
+    }
+  }
+
+  SCENARIO("Streaming preset loading") {
+    GIVEN("A serialized preset") {
+      const int mappingCount = 50;
+      std::vector<Source> sources(mappingCount);
+      std::vector<Mode> modes(mappingCount);
+      std::vector<ConstMappingRef> mappings;
+      for (int i = 0; i < mappingCount; i++) {
+        configureMapping(sources.at(i), modes.at(i), i);
+        mappings.push_back({&sources.at(i), &modes.at(i)});
+      }
+      std::vector<Source> loadedSources(mappingCount);
+      std::vector<Mode> loadedModes(mappingCount);
+      std::vector<std::size_t> loadedIndexes;
+      const auto provideMapping = [&loadedSources, &loadedModes](std::size_t index) {
+        return MappingRef{&loadedSources.at(index), &loadedModes.at(index)};
+      };
+      const auto mappingLoaded = [&loadedIndexes](std::size_t index, MappingRef) {
+        loadedIndexes.push_back(index);
+      };
+      WHEN("loaded from a stream with integer enums") {
+        std::istringstream input(util::serializeMappings(mappings, false));
+        const auto loadedCount = util::loadMappings(input, provideMapping, mappingLoaded);
+        THEN("it should load all mappings one by one") {
+          REQUIRE(loadedCount == mappingCount);
+          REQUIRE(loadedIndexes.size() == mappingCount);
+          REQUIRE(loadedIndexes.back() == mappingCount - 1);
+          REQUIRE(serializeMappingsViaDom(loadedSources, loadedModes, true) ==
+              serializeMappingsViaDom(sources, modes, true));
+        }
+      }
+      WHEN("loaded from a pretty-printed stream with string enums") {
+        std::istringstream input(nlohmann::json::parse(util::serializeMappings(mappings, true)).dump(2));
+        util::loadMappings(input, provideMapping, mappingLoaded);
+        THEN("it should load the same mappings") {
+          REQUIRE(serializeMappingsViaDom(loadedSources, loadedModes, false) ==
+              serializeMappingsViaDom(sources, modes, false));
+        }
+      }
+      WHEN("loaded from a truncated stream") {
+        const auto text = util::serializeMappings(mappings);
+        std::istringstream input(text.substr(0, text.size() / 2));
+        THEN("it should activate the complete mappings and then fail") {
+          REQUIRE_THROWS_AS(util::loadMappings(input, provideMapping, mappingLoaded), nlohmann::json::parse_error);
+          REQUIRE(!loadedIndexes.empty());
+          REQUIRE(loadedIndexes.size() < mappingCount);
+        }
+      }
+      WHEN("loaded from a stream which doesn't contain an array of mappings") {
+        std::istringstream objectInput(R"({"mode": {}, "source": {}})");
+        std::istringstream numberArrayInput("[1, 2]");
+        std::istringstream nestedArrayInput("[[]]");
+        THEN("it should fail without loading anything") {
+          REQUIRE_THROWS_AS(util::loadMappings(objectInput, provideMapping, mappingLoaded), std::runtime_error);
+          REQUIRE_THROWS_AS(util::loadMappings(numberArrayInput, provideMapping, mappingLoaded), std::runtime_error);
+          REQUIRE_THROWS_AS(util::loadMappings(nestedArrayInput, provideMapping, mappingLoaded), std::runtime_error);
+          REQUIRE(loadedIndexes.empty());
+        }
+      }
+    }
+  }
+  SCENARIO("Lazy mapping activation") {
+    GIVEN("A preset loaded into lazily activated mappings") {
+      const int mappingCount = 20;
+      std::vector<Source> sources(mappingCount);
+      std::vector<Mode> modes(mappingCount);
+      std::vector<ConstMappingRef> mappings;
+      for (int i = 0; i < mappingCount; i++) {
+        configureMapping(sources.at(i), modes.at(i), i);
+        mappings.push_back({&sources.at(i), &modes.at(i)});
+      }
+      std::vector<Source> lazySources;
+      std::vector<Mode> lazyModes;
+      lazySources.reserve(mappingCount);
+      lazyModes.reserve(mappingCount);
+      std::vector<MappingRef> lazyMappings;
+      for (int i = 0; i < mappingCount; i++) {
+        lazySources.emplace_back(ProcessorActivation::Lazy);
+        lazyModes.emplace_back(ProcessorActivation::Lazy);
+        lazyMappings.push_back({&lazySources.at(i), &lazyModes.at(i)});
+      }
+      util::deserializeMappings(nlohmann::json::parse(util::serializeMappings(mappings)), lazyMappings);
+      THEN("no processor should have been built yet") {
+        for (int i = 0; i < mappingCount; i++) {
+          REQUIRE(!lazySources.at(i).isWarmedUp());
+          REQUIRE(!lazyModes.at(i).isWarmedUp());
+        }
+      }
+      WHEN("a mapping is used without warming it up") {
+        const Source& source = lazySources.at(3);
+        const auto maxDiscreteValue = source.getProcessor().getMaxDiscreteValue();
+        lazyModes.at(3).getProcessor();
+        THEN("it should be activated on first use") {
+          REQUIRE(source.isWarmedUp());
+          REQUIRE(lazyModes.at(3).isWarmedUp());
+          REQUIRE(maxDiscreteValue == sources.at(3).getProcessor().getMaxDiscreteValue());
+          REQUIRE(!lazySources.at(4).isWarmedUp());
+        }
+      }
+      WHEN("a mapping is warmed up") {
+        const Source& source = lazySources.at(3);
+        lazySources.at(3).warmUp();
+        lazyModes.at(3).warmUp();
+        const auto maxDiscreteValue = source.getProcessor().getMaxDiscreteValue();
+        THEN("it should be activated with the loaded settings") {
+          REQUIRE(source.isWarmedUp());
+          REQUIRE(lazyModes.at(3).isWarmedUp());
+          REQUIRE(maxDiscreteValue == sources.at(3).getProcessor().getMaxDiscreteValue());
+          REQUIRE(!lazySources.at(4).isWarmedUp());
+        }
+        AND_WHEN("it is changed afterwards") {
+          lazySources.at(3).type.set(SourceType::ControlChangeValue);
+          THEN("its processor should follow") {
+            REQUIRE(source.getProcessor().getMaxDiscreteValue() == 127);
+          }
+        }
+      }
+      WHEN("warmed up in the background") {
+        util::warmUpInBackground(lazyMappings).get();
+        THEN("all mappings should be activated") {
+          for (int i = 0; i < mappingCount; i++) {
+            REQUIRE(lazySources.at(i).isWarmedUp());
+            REQUIRE(lazyModes.at(i).isWarmedUp());
+          }
+        }
+      }
+      WHEN("copied before being used") {
+        const Source sourceCopy(lazySources.at(0));
+        const Mode modeCopy(lazyModes.at(0));
+        THEN("the copies should stay lazy as well") {
+          REQUIRE(!sourceCopy.isWarmedUp());
+          REQUIRE(!modeCopy.isWarmedUp());
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,466 @@
+#include <helgoboss-learn/Mode.h>
+#include <helgoboss-learn/Source.h>
+#include <helgoboss-learn/SourceContext.h>
+#include <helgoboss-learn/Target.h>
+#include "TestMappings.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// With AddressSanitizer, freed memory is kept in quarantine, so resident memory isn't meaningful. Leaks are reported by
+// LeakSanitizer instead.
+#if defined(__SANITIZE_ADDRESS__)
+#define HELGOBOSS_LEARN_STRESS_WITH_ASAN
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define HELGOBOSS_LEARN_STRESS_WITH_ASAN
+#endif
+#endif
+
+#if defined(__linux__)
+#include <unistd.h>
+#include <fstream>
+#elif defined(__APPLE__)
+#include <mach/mach.h>
+#endif
+
+// Stress and soak test which uses the library the way a host does: A control thread owns the sources and modes and
+// changes their settings all the time. Whenever it has changed a mapping, it hands copies of the processors over to
+// the real-time thread, which processes random events, and copies of the source and mode over to the feedback thread,
+// which sends feedback for all mappings. Replaced objects go back to the control thread to be destroyed there.
+//
+// Build with -DHELGOBOSS_LEARN_SANITIZER=thread or address to have data races respectively memory errors reported.
+
+namespace helgoboss {
+  namespace {
+    struct StressOptions {
+      double seconds = 5;
+      int mappingCount = 2000;
+      unsigned seed = 1;
+      // Progress is printed in this interval, useful for soak runs over hours
+      double reportIntervalSeconds = 60;
+      // Fails the run if the resident memory grows more than this during the run
+      double maxMemoryGrowthMb = 256;
+    };
+
+    // Returns 0 if not supported on this platform
+    std::size_t getResidentMemoryBytes() {
+#if defined(__linux__)
+      std::ifstream statm("/proc/self/statm");
+      std::size_t totalPages = 0;
+      std::size_t residentPages = 0;
+      statm >> totalPages >> residentPages;
+      return residentPages * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#elif defined(__APPLE__)
+      mach_task_basic_info info;
+      mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+      if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count)
+          != KERN_SUCCESS) {
+        return 0;
+      }
+      return info.resident_size;
+#else
+      return 0;
+#endif
+    }
+
+    double toMb(std::size_t bytes) {
+      return bytes / (1024.0 * 1024.0);
+    }
+
+    // Written by the real-time thread, read by the feedback thread
+    class StressTarget : public Target {
+    private:
+      TargetCharacter character_;
+      double stepSize_;
+      bool wantsStepCounts_;
+      std::atomic<double> value_{0.5};
+    public:
+      StressTarget(TargetCharacter character, double stepSize, bool wantsStepCounts) :
+          character_(character), stepSize_(stepSize), wantsStepCounts_(wantsStepCounts) {
+      }
+
+      TargetCharacter getCharacter() const override {
+        return character_;
+      }
+      double getStepSize() const override {
+        return stepSize_;
+      }
+      bool wantsToBeHitWithStepCounts() const override {
+        return wantsStepCounts_;
+      }
+      void hit(double normalizedValue, bool isStepCount) override {
+        const double newValue = isStepCount ? getCurrentValue() + normalizedValue * 0.01 : normalizedValue;
+        value_.store(std::min(std::max(newValue, 0.0), 1.0), std::memory_order_relaxed);
+      }
+      double getCurrentValue() const override {
+        return value_.load(std::memory_order_relaxed);
+      }
+      int getMaxStepCount() const override {
+        return stepSize_ == -1 ? -1 : static_cast<int>(1 / stepSize_);
+      }
+      bool canBeDiscrete() const override {
+        return stepSize_ != -1;
+      }
+    };
+
+    class CountingSourceContext : public SourceContext {
+    public:
+      std::uint64_t messageCount = 0;
+
+      void processMidiFeedback(const void* source, const MidiMessage& message) override {
+        messageCount += 1;
+      }
+      void processMidiFeedbackTwo(const void* source, const std::array<MidiMessage, 2>& messages) override {
+        messageCount += 2;
+      }
+    };
+
+    // Not real-time capable, but good enough to move objects between threads
+    template<typename T>
+    class Mailbox {
+    private:
+      std::mutex mutex_;
+      std::vector<T> items_;
+    public:
+      void post(T item) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        items_.push_back(std::move(item));
+      }
+
+      // Doesn't block if the mailbox is busy
+      template<typename F>
+      void tryDrain(F&& f) {
+        std::vector<T> items;
+        {
+          std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+          if (!lock.owns_lock() || items_.empty()) {
+            return;
+          }
+          std::swap(items, items_);
+        }
+        for (auto& item : items) {
+          f(item);
+        }
+      }
+
+      std::size_t size() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return items_.size();
+      }
+    };
+
+    struct RealTimeMapping {
+      SourceProcessor source;
+      ModeProcessor mode;
+    };
+
+    struct FeedbackMapping {
+      Source source;
+      Mode mode;
+
+      FeedbackMapping(const Source& source, const Mode& mode) : source(source), mode(mode) {
+      }
+    };
+
+    struct RealTimeUpdate {
+      std::size_t index;
+      std::unique_ptr<RealTimeMapping> mapping;
+    };
+
+    struct FeedbackUpdate {
+      std::size_t index;
+      std::unique_ptr<FeedbackMapping> mapping;
+    };
+
+    struct Garbage {
+      std::unique_ptr<RealTimeMapping> realTimeMapping;
+      std::unique_ptr<FeedbackMapping> feedbackMapping;
+    };
+
+    void randomizeMapping(Source& source, Mode& mode, std::mt19937& random) {
+      configureMapping(source, mode, static_cast<int>(random() % 100000));
+      // Make a good part of the mappings match the generated events
+      source.channel.set(static_cast<int>(random() % 4));
+      source.midiMessageNumber.set(static_cast<int>(random() % 32));
+    }
+
+    // Changes one random setting
+    void mutateMapping(Source& source, Mode& mode, std::mt19937& random) {
+      const auto value = static_cast<int>(random() % 1000);
+      switch (random() % 12) {
+        case 0:
+          source.type.set(static_cast<SourceType>(value % NUM_SOURCE_TYPES));
+          break;
+        case 1:
+          source.customCharacter.set(static_cast<SourceCharacter>(value % 5));
+          break;
+        case 2:
+          source.is14Bit.set(value % 2 == 0);
+          break;
+        case 3:
+          source.midiMessageNumber.set(value % 32);
+          break;
+        case 4:
+          mode.type.set(static_cast<ModeType>(value % NUM_MODE_TYPES));
+          break;
+        case 5:
+          mode.minTargetValue.set(value / 2000.0);
+          break;
+        case 6:
+          mode.maxSourceValue.set(0.5 + value / 2000.0);
+          break;
+        case 7:
+          mode.reverseIsEnabled.set(value % 2 == 0);
+          break;
+        case 8:
+          mode.eelControlTransformation.set(TEST_EEL_SCRIPTS.at(value % TEST_EEL_SCRIPTS.size()));
+          break;
+        case 9:
+          mode.eelFeedbackTransformation.set(TEST_EEL_SCRIPTS.at(value % TEST_EEL_SCRIPTS.size()));
+          break;
+        case 10:
+          mode.maxTargetJump.set(value / 1000.0);
+          break;
+        default:
+          configureMapping(source, mode, value);
+          break;
+      }
+    }
+
+    std::vector<SourceValue> createEvents(std::mt19937& random) {
+      std::vector<SourceValue> events;
+      for (int i = 0; i < 4096; i++) {
+        const auto channel = static_cast<int>(random() % 4);
+        const auto number = static_cast<int>(random() % 32);
+        const auto value = static_cast<int>(random() % 128);
+        switch (random() % 8) {
+          case 0:
+            events.emplace_back(MidiMessage::noteOn(channel, number, value));
+            break;
+          case 1:
+            events.emplace_back(MidiMessage::pitchBendChange(channel, static_cast<int>(random() % 16384)));
+            break;
+          case 2:
+            events.emplace_back(Midi14BitCcMessage(channel, number, static_cast<int>(random() % 16384)));
+            break;
+          case 3:
+            events.emplace_back(MidiParameterNumberMessage(channel, number, value, random() % 2 == 0, false));
+            break;
+          case 4:
+            events.emplace_back(TempoMessage{60.0 + random() % 120});
+            break;
+          default:
+            events.emplace_back(MidiMessage::controlChange(channel, number, value));
+            break;
+        }
+      }
+      return events;
+    }
+
+    class StressRun {
+    private:
+      StressOptions options_;
+      std::atomic<bool> stopped_{false};
+      std::atomic<bool> failed_{false};
+      std::atomic<std::uint64_t> processedEventCount_{0};
+      std::atomic<std::uint64_t> settingChangeCount_{0};
+      std::atomic<std::uint64_t> feedbackMessageCount_{0};
+      std::vector<std::unique_ptr<StressTarget>> targets_;
+      Mailbox<RealTimeUpdate> realTimeMailbox_;
+      Mailbox<FeedbackUpdate> feedbackMailbox_;
+      Mailbox<Garbage> garbageMailbox_;
+    public:
+      explicit StressRun(StressOptions options) : options_(options) {
+      }
+
+      // Returns the process exit code
+      int run() {
+        std::mt19937 random(options_.seed);
+        const auto mappingCount = static_cast<std::size_t>(options_.mappingCount);
+        std::vector<Source> sources(mappingCount);
+        std::vector<Mode> modes(mappingCount);
+        std::vector<std::unique_ptr<RealTimeMapping>> realTimeMappings;
+        std::vector<std::unique_ptr<FeedbackMapping>> feedbackMappings;
+        for (std::size_t i = 0; i < mappingCount; i++) {
+          randomizeMapping(sources[i], modes[i], random);
+          const auto stepSize = random() % 2 == 0 ? -1.0 : 1.0 / (2 + random() % 100);
+          targets_.push_back(std::make_unique<StressTarget>(
+              stepSize == -1 ? TargetCharacter::Continuous : TargetCharacter::Discrete, stepSize, random() % 4 == 0));
+          realTimeMappings.push_back(createRealTimeMapping(sources[i], modes[i]));
+          feedbackMappings.push_back(std::make_unique<FeedbackMapping>(sources[i], modes[i]));
+        }
+        const auto events = createEvents(random);
+        const auto memoryAtStart = getResidentMemoryBytes();
+        std::printf("%d mappings, %.0f s, seed %u, %.1f MB resident\n",
+            options_.mappingCount, options_.seconds, options_.seed, toMb(memoryAtStart));
+        const auto start = std::chrono::steady_clock::now();
+        std::thread realTimeThread([this, &realTimeMappings, &events] {
+          guard([&] {
+            processEvents(realTimeMappings, events);
+          });
+        });
+        std::thread feedbackThread([this, &feedbackMappings] {
+          guard([&] {
+            sendFeedback(feedbackMappings);
+          });
+        });
+        guard([&] {
+          changeSettings(sources, modes, random, start);
+        });
+        stopped_ = true;
+        realTimeThread.join();
+        feedbackThread.join();
+        const double elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        // Collect everything that's still in flight
+        collectGarbage();
+        realTimeMailbox_.tryDrain([](RealTimeUpdate&) {
+        });
+        feedbackMailbox_.tryDrain([](FeedbackUpdate&) {
+        });
+        const auto memoryAtEnd = getResidentMemoryBytes();
+        const auto memoryGrowthMb = toMb(memoryAtEnd) - toMb(memoryAtStart);
+        std::printf("processed events:  %14.0f/s\n", processedEventCount_ / elapsedSeconds);
+        std::printf("setting changes:   %14.0f/s\n", settingChangeCount_ / elapsedSeconds);
+        std::printf("feedback messages: %14.0f/s\n", feedbackMessageCount_ / elapsedSeconds);
+        std::printf("memory growth:     %14.1f MB\n", memoryGrowthMb);
+        if (failed_) {
+          return 1;
+        }
+#if defined(HELGOBOSS_LEARN_STRESS_WITH_ASAN)
+        std::printf("memory growth not checked because of AddressSanitizer\n");
+        return 0;
+#endif
+        if (memoryGrowthMb > options_.maxMemoryGrowthMb) {
+          std::fprintf(stderr, "Memory grew more than %.1f MB\n", options_.maxMemoryGrowthMb);
+          return 1;
+        }
+        return 0;
+      }
+
+    private:
+      template<typename F>
+      void guard(F&& f) {
+        try {
+          f();
+        } catch (const std::exception& e) {
+          std::fprintf(stderr, "Failed: %s\n", e.what());
+          failed_ = true;
+          stopped_ = true;
+        }
+      }
+
+      static std::unique_ptr<RealTimeMapping> createRealTimeMapping(const Source& source, const Mode& mode) {
+        return std::unique_ptr<RealTimeMapping>(new RealTimeMapping{source.getProcessor(), mode.getProcessor()});
+      }
+
+      void changeSettings(std::vector<Source>& sources, std::vector<Mode>& modes, std::mt19937& random,
+          std::chrono::steady_clock::time_point start) {
+        const auto deadline = start + std::chrono::duration<double>(options_.seconds);
+        auto nextReport = start + std::chrono::duration<double>(options_.reportIntervalSeconds);
+        while (!stopped_ && std::chrono::steady_clock::now() < deadline) {
+          const auto index = random() % sources.size();
+          mutateMapping(sources[index], modes[index], random);
+          realTimeMailbox_.post({index, createRealTimeMapping(sources[index], modes[index])});
+          feedbackMailbox_.post({index, std::make_unique<FeedbackMapping>(sources[index], modes[index])});
+          settingChangeCount_.fetch_add(1, std::memory_order_relaxed);
+          collectGarbage();
+          // Don't let the other threads fall behind too much
+          while (!stopped_ && realTimeMailbox_.size() + feedbackMailbox_.size() > 1000) {
+            std::this_thread::yield();
+            collectGarbage();
+          }
+          const auto now = std::chrono::steady_clock::now();
+          if (now >= nextReport) {
+            std::printf("%8.0f s: %llu events, %llu setting changes, %.1f MB resident\n",
+                std::chrono::duration<double>(now - start).count(),
+                static_cast<unsigned long long>(processedEventCount_.load()),
+                static_cast<unsigned long long>(settingChangeCount_.load()),
+                toMb(getResidentMemoryBytes()));
+            std::fflush(stdout);
+            nextReport += std::chrono::duration<double>(options_.reportIntervalSeconds);
+          }
+        }
+      }
+
+      void collectGarbage() {
+        garbageMailbox_.tryDrain([](Garbage&) {
+          // Destroyed together with the drained items
+        });
+      }
+
+      void processEvents(std::vector<std::unique_ptr<RealTimeMapping>>& mappings,
+          const std::vector<SourceValue>& events) {
+        std::size_t eventIndex = 0;
+        while (!stopped_) {
+          realTimeMailbox_.tryDrain([this, &mappings](RealTimeUpdate& update) {
+            std::swap(mappings[update.index], update.mapping);
+            garbageMailbox_.post({std::move(update.mapping), nullptr});
+          });
+          const auto& event = events[eventIndex];
+          eventIndex = (eventIndex + 1) % events.size();
+          for (std::size_t i = 0; i < mappings.size(); i++) {
+            auto& mapping = *mappings[i];
+            if (mapping.source.processes(event)) {
+              mapping.mode.processSourceValue(mapping.source.getNormalizedValue(event), mapping.source, *targets_[i]);
+            }
+          }
+          processedEventCount_.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+
+      void sendFeedback(std::vector<std::unique_ptr<FeedbackMapping>>& mappings) {
+        CountingSourceContext context;
+        while (!stopped_) {
+          feedbackMailbox_.tryDrain([this, &mappings](FeedbackUpdate& update) {
+            std::swap(mappings[update.index], update.mapping);
+            garbageMailbox_.post({nullptr, std::move(update.mapping)});
+          });
+          for (std::size_t i = 0; i < mappings.size() && !stopped_; i++) {
+            auto& mapping = *mappings[i];
+            mapping.mode.feedback(mapping.source, *targets_[i], context);
+          }
+          feedbackMessageCount_.store(context.messageCount, std::memory_order_relaxed);
+        }
+      }
+    };
+  }
+}
+
+// Usage: helgoboss-learn-stress [--seconds S] [--mappings N] [--seed SEED] [--report-interval S]
+//     [--max-memory-growth MB]
+//
+// The defaults make a run of a few seconds, which is part of the test suite. For a soak test pass e.g.
+// --seconds 14400.
+int main(int argc, char* argv[]) {
+  helgoboss::StressOptions options;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    const std::string arg = argv[i];
+    const char* value = argv[i + 1];
+    if (arg == "--seconds") {
+      options.seconds = std::atof(value);
+    } else if (arg == "--mappings") {
+      options.mappingCount = std::max(1, std::atoi(value));
+    } else if (arg == "--seed") {
+      options.seed = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+    } else if (arg == "--report-interval") {
+      options.reportIntervalSeconds = std::max(1.0, std::atof(value));
+    } else if (arg == "--max-memory-growth") {
+      options.maxMemoryGrowthMb = std::atof(value);
+    } else {
+      std::fprintf(stderr, "Unknown option %s\n", arg.c_str());
+      return 2;
+    }
+  }
+  helgoboss::StressRun run(options);
+  return run.run();
+}
@@ -0,0 +1,114 @@
+#include <catch.hpp>
+#include <rxcpp/rx.hpp>
+#include <rxcpp/rx-test.hpp>
+#include <helgoboss-learn/rx/wait_for_some_more_items.h>
+#include <helgoboss-learn/rx/wait_for_some_more_items_in_buffer.h>
+#include "AllocationCounter.h"
+
+namespace helgoboss {
+  using IntBuffer = FixedCapacityBuffer<int, 4>;
+
+  SCENARIO("Wait for some more items in fixed-capacity buffer") {
+    GIVEN("A hot observable driven by a test scheduler") {
+      auto sc = rxcpp::schedulers::make_test();
+      auto w = sc.create_worker();
+      const rxcpp::schedulers::test::messages<int> on;
+      const rxcpp::schedulers::test::messages<IntBuffer> onBuffer;
+      auto xs = sc.make_hot_observable({
+          // Reaches requested item count
+          on.next(210, 1),
+          on.next(220, 2),
+          on.next(230, 3),
+          // Times out (and is not affected by the obsolete timeout of the first burst at 310)
+          on.next(300, 4),
+          on.next(310, 5),
+          // Times out
+          on.next(500, 6)
+      });
+      WHEN("waiting for 3 items or 100 ms") {
+        auto res = w.start([&xs, &sc]() {
+          return xs.lift<IntBuffer>(
+              util::waitForSomeMoreItemsInBuffer<int, 4>(
+                  3,
+                  std::chrono::milliseconds(100),
+                  rxcpp::identity_one_worker(sc)
+              )
+          );
+        });
+        THEN("it should emit one buffer per burst at the expected virtual time") {
+          const std::vector<rxcpp::schedulers::test::messages<IntBuffer>::recorded_type> expected{
+              onBuffer.next(230, IntBuffer{1, 2, 3}),
+              onBuffer.next(400, IntBuffer{4, 5}),
+              onBuffer.next(600, IntBuffer{6})
+          };
+          REQUIRE(expected == res.get_observer().messages());
+        }
+      }
+    }
+  }
+
+  SCENARIO("Wait for some more items without allocating per item") {
+    GIVEN("Both operator variants subscribed on a test scheduler") {
+      auto sc = rxcpp::schedulers::make_test();
+      int bufferCount = 0;
+      int vectorCount = 0;
+      const auto bufferInput = util::waitForSomeMoreItemsInBuffer<int, 10>(
+          10, std::chrono::milliseconds(250), rxcpp::identity_one_worker(sc)
+      )(rxcpp::make_subscriber<FixedCapacityBuffer<int, 10>>([&bufferCount](FixedCapacityBuffer<int, 10>) {
+        bufferCount += 1;
+      }));
+      const auto vectorInput = util::waitForSomeMoreItems<int>(
+          10, std::chrono::milliseconds(250), rxcpp::identity_one_worker(sc)
+      )(rxcpp::make_subscriber<std::vector<int>>([&vectorCount](std::vector<int>) {
+        vectorCount += 1;
+      }));
+      // Warm up, e.g. let the scheduler queue grow
+      for (int i = 0; i < 10; i++) {
+        bufferInput.on_next(i);
+        vectorInput.on_next(i);
+      }
+      WHEN("feeding the remaining items of a subsequent burst") {
+        bufferInput.on_next(0);
+        vectorInput.on_next(0);
+        AllocationCounter bufferAllocations;
+        for (int i = 1; i < 10; i++) {
+          bufferInput.on_next(i);
+        }
+        const auto bufferAllocationCount = bufferAllocations.getCount();
+        AllocationCounter vectorAllocations;
+        for (int i = 1; i < 10; i++) {
+          vectorInput.on_next(i);
+        }
+        const auto vectorAllocationCount = vectorAllocations.getCount();
+        THEN("the buffer variant should not allocate at all") {
+          REQUIRE(bufferCount == 2);
+          REQUIRE(vectorCount == 2);
+          REQUIRE(bufferAllocationCount == 0);
+          REQUIRE(vectorAllocationCount > 0);
+        }
+      }
+    }
+  }
+
+  SCENARIO("Fixed-capacity buffer") {
+    GIVEN("A buffer") {
+      FixedCapacityBuffer<std::string, 2> buffer;
+      WHEN("filled") {
+        buffer.push_back("a");
+        buffer.push_back("b");
+        THEN("it should keep items inline and refuse more than its capacity") {
+          REQUIRE(buffer.size() == 2);
+          REQUIRE(buffer.full());
+          REQUIRE(buffer.front() == "a");
+          REQUIRE(buffer.back() == "b");
+          REQUIRE_THROWS(buffer.push_back("c"));
+          const auto copy = buffer;
+          REQUIRE(copy == buffer);
+          buffer.clear();
+          REQUIRE(buffer.empty());
+          REQUIRE(copy.size() == 2);
+        }
+      }
+    }
+  }
+}